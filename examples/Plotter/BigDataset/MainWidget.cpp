@@ -30,6 +30,8 @@ MainWidget::MainWidget()
 
     m_plotter = new KChart::Plotter;
     m_plotter->setModel( &m_model );
+    // the model only ever grows at the end
+    m_plotter->setAppendOptimized( true );
     KChart::AbstractDiagram::Private::get( m_plotter )->doDumpPaintTime = true;
     chart->coordinatePlane()->replaceDiagram( m_plotter );
 
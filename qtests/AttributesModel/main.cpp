@@ -134,6 +134,47 @@ private Q_SLOTS:
       QCOMPARE( b.isVisible(), false ); // No sharing
   }
 
+  void testKChartAttributesModelCellOverrides()
+  {
+      AttributesModel* attrsmodel = m_lines->attributesModel();
+      QVERIFY( !attrsmodel->hasCellOverrides( 2, DatasetPenRole ) );
+      m_lines->setPen( 2, QPen( Qt::red ) );
+      // per dataset settings are no cell overrides
+      QVERIFY( !attrsmodel->hasCellOverrides( 2, DatasetPenRole ) );
+
+      QModelIndex idx = m_lines->model()->index( 1, 2, QModelIndex() );
+      m_lines->setPen( idx, QPen( Qt::blue ) );
+      QVERIFY( attrsmodel->hasCellOverrides( 2, DatasetPenRole ) );
+      QVERIFY( !attrsmodel->hasCellOverrides( 2, DatasetBrushRole ) );
+      QVERIFY( !attrsmodel->hasCellOverrides( 1, DatasetPenRole ) );
+
+      QCOMPARE( m_lines->pen( idx ).color(), QColor( Qt::blue ) );
+      QCOMPARE( m_lines->pen( m_lines->model()->index( 0, 2, QModelIndex() ) ).color(), QColor( Qt::red ) );
+
+      attrsmodel->resetData( attrsmodel->mapFromSource( idx ), DatasetPenRole );
+      QVERIFY( !attrsmodel->hasCellOverrides( 2, DatasetPenRole ) );
+      // back to the dataset's pen
+      QCOMPARE( m_lines->pen( idx ).color(), QColor( Qt::red ) );
+  }
+
+  void testKChartAttributesModelTypedAccess()
+  {
+      AttributesModel* attrsmodel = m_lines->attributesModel();
+      const QModelIndex idx = attrsmodel->mapFromSource( m_lines->model()->index( 2, 1, QModelIndex() ) );
+      QVariant buffer;
+      QCOMPARE( attrsmodel->attributes< LineAttributes >( idx, LineAttributesRole, &buffer ),
+                m_lines->lineAttributes( 1 ) );
+
+      const quint64 generation = attrsmodel->attributesGeneration();
+      LineAttributes la;
+      la.setTransparency( 42 );
+      m_lines->setLineAttributes( 1, la );
+      QVERIFY( attrsmodel->attributesGeneration() != generation );
+      const LineAttributes& stored = attrsmodel->attributes< LineAttributes >( idx, LineAttributesRole, &buffer );
+      QCOMPARE( stored.transparency(), 42u );
+      // no copy of the dataset's attributes
+      QVERIFY( &stored != buffer.constData() );
+  }
 
   void cleanupTestCase()
   {
@@ -114,6 +114,40 @@ private Q_SLOTS:
         QVERIFY( m_bars->barAttributes().barGapFactor() == 1 );
     }
 
+    void testHitTesting()
+    {
+        QImage image( 400, 300, QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &image );
+        m_chart->paint( &painter, image.rect() );
+
+        int barCount = 0;
+        for ( int row = 0; row < m_model->rowCount(); ++row ) {
+            for ( int column = 0; column < m_model->columnCount(); ++column ) {
+                const QModelIndex index = m_model->index( row, column );
+                const QRect rect = m_bars->visualRect( index );
+                if ( rect.isEmpty() ) {
+                    continue;
+                }
+                ++barCount;
+                QVERIFY( m_bars->indexesAt( rect.center() ).contains( index ) );
+            }
+        }
+        QVERIFY( barCount > 0 );
+        const int hitCount = m_bars->indexesIn( image.rect() ).count();
+        QVERIFY( hitCount >= barCount );
+        QVERIFY( m_bars->indexesAt( QPoint( -100, -100 ) ).isEmpty() );
+
+        // lazy hit testing finds the same data points, just later
+        m_bars->setHitTestingPolicy( AbstractDiagram::HitTestingLazy );
+        m_chart->paint( &painter, image.rect() );
+        QCOMPARE( m_bars->indexesIn( image.rect() ).count(), hitCount );
+
+        m_bars->setHitTestingPolicy( AbstractDiagram::HitTestingOff );
+        m_chart->paint( &painter, image.rect() );
+        QVERIFY( m_bars->indexesIn( image.rect() ).isEmpty() );
+        m_bars->setHitTestingPolicy( AbstractDiagram::HitTestingEager );
+    }
+
         void testThreeDBarAttributesLevelSettings()
     {
         //check segments
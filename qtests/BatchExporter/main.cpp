@@ -0,0 +1,119 @@
+/**
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QtTest/QtTest>
+#include <QBuffer>
+#include <QStandardItemModel>
+#include <KChartBatchExporter>
+#include <KChartChart>
+#include <KChartLineDiagram>
+#include <KChartCartesianCoordinatePlane>
+
+using namespace KChart;
+
+static QStandardItemModel* createModel( int rows, QObject* parent )
+{
+    QStandardItemModel* model = new QStandardItemModel( rows, 2, parent );
+    for ( int row = 0; row < rows; ++row ) {
+        model->setData( model->index( row, 0 ), row );
+        model->setData( model->index( row, 1 ), rows - row );
+    }
+    return model;
+}
+
+class TestBatchExporter : public QObject {
+  Q_OBJECT
+private Q_SLOTS:
+
+  void initTestCase()
+  {
+      m_chart = new Chart( nullptr );
+      m_lines = new LineDiagram();
+      m_lines->setModel( createModel( 10, this ) );
+      m_chart->coordinatePlane()->replaceDiagram( m_lines );
+  }
+
+  void testImages()
+  {
+      QAbstractItemModel* originalModel = m_lines->model();
+      QStandardItemModel* otherModel = createModel( 20, this );
+      QBuffer png;
+      QBuffer jpeg;
+      QVector< BatchExporter::Job > jobs;
+      jobs << BatchExporter::Job( m_chart, QSize( 300, 200 ), BatchExporter::Png, &png );
+      jobs << BatchExporter::Job( m_chart, QSize( 150, 100 ), BatchExporter::Jpeg, &jpeg );
+      jobs.last().model = otherModel;
+
+      BatchExporter exporter;
+      QSignalSpy finished( &exporter, &BatchExporter::jobFinished );
+      const QVector< BatchExporter::Result > results = exporter.exportCharts( jobs );
+      QCOMPARE( results.size(), 2 );
+      QCOMPARE( finished.count(), 2 );
+      for ( const BatchExporter::Result& result : results ) {
+          QVERIFY2( result.success, qPrintable( result.errorString ) );
+          QVERIFY( result.renderNanoseconds > 0 );
+      }
+
+      QCOMPARE( QImage::fromData( png.data(), "png" ).size(), QSize( 300, 200 ) );
+      QCOMPARE( QImage::fromData( jpeg.data(), "jpeg" ).size(), QSize( 150, 100 ) );
+      // the chart is left as it was, and so are the devices
+      QCOMPARE( m_lines->model(), originalModel );
+      QVERIFY( !png.isOpen() );
+      QVERIFY( !jpeg.isOpen() );
+  }
+
+  void testVector()
+  {
+      QBuffer svg;
+      QBuffer pdf;
+      QVector< BatchExporter::Job > jobs;
+      jobs << BatchExporter::Job( m_chart, QSize( 300, 200 ), BatchExporter::Svg, &svg );
+      jobs << BatchExporter::Job( m_chart, QSize( 300, 200 ), BatchExporter::Pdf, &pdf );
+
+      BatchExporter exporter;
+      const QVector< BatchExporter::Result > results = exporter.exportCharts( jobs );
+      QVERIFY( results.at( 0 ).success );
+      QVERIFY( results.at( 1 ).success );
+      QCOMPARE( results.at( 0 ).encodeNanoseconds, qint64( 0 ) );
+      QVERIFY( svg.data().contains( "<svg" ) );
+      QVERIFY( pdf.data().startsWith( "%PDF" ) );
+      QVERIFY( !svg.isOpen() );
+      QVERIFY( !pdf.isOpen() );
+
+      // devices opened by the caller stay open
+      QBuffer open;
+      open.open( QIODevice::WriteOnly );
+      jobs.clear();
+      jobs << BatchExporter::Job( m_chart, QSize( 300, 200 ), BatchExporter::Png, &open );
+      QVERIFY( exporter.exportCharts( jobs ).at( 0 ).success );
+      QVERIFY( open.isOpen() );
+  }
+
+  void testInvalidJob()
+  {
+      BatchExporter exporter;
+      const QVector< BatchExporter::Result > results =
+          exporter.exportCharts( QVector< BatchExporter::Job >() << BatchExporter::Job() );
+      QCOMPARE( results.size(), 1 );
+      QVERIFY( !results.at( 0 ).success );
+      QVERIFY( !results.at( 0 ).errorString.isEmpty() );
+  }
+
+  void cleanupTestCase()
+  {
+      delete m_chart;
+  }
+
+private:
+  Chart* m_chart;
+  LineDiagram* m_lines;
+};
+
+QTEST_MAIN(TestBatchExporter)
+
+#include "main.moc"
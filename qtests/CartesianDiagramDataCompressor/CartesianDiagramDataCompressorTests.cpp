@@ -11,10 +11,13 @@
 #include <QtTest/QtTest>
 #include <QStandardItem>
 #include <QStandardItemModel>
+#include <QAbstractTableModel>
 
+#include <KChartBulkNumericSource.h>
 #include <KChartCartesianDiagramDataCompressor_p.h>
 
 typedef KChart::CartesianDiagramDataCompressor::CachePosition CachePosition;
+typedef KChart::CartesianDiagramDataCompressor::DataPoint DataPoint;
 
 struct Match {
     Match( const CachePosition& pos, const QModelIndex& index )
@@ -26,6 +29,109 @@ struct Match {
     QModelIndex index;
 };
 
+// a table model that hands out its values through the bulk interface
+class BulkModel : public QAbstractTableModel, public KChart::BulkNumericSource
+{
+public:
+    BulkModel( int columns, int rows, double value )
+        : m_columns( columns, QVector< double >( rows, value ) ),
+          displayDataCalls( 0 )
+    {
+    }
+
+    int rowCount( const QModelIndex& parent ) const override
+    {
+        return parent.isValid() ? 0 : m_columns.first().count();
+    }
+
+    int columnCount( const QModelIndex& parent ) const override
+    {
+        return parent.isValid() ? 0 : m_columns.count();
+    }
+
+    QVariant data( const QModelIndex& index, int role ) const override
+    {
+        if ( role != Qt::DisplayRole ) {
+            return QVariant();
+        }
+        ++displayDataCalls;
+        return m_columns.at( index.column() ).at( index.row() );
+    }
+
+    const double* columnData( int column, const QModelIndex& parent, int role ) const override
+    {
+        Q_UNUSED( parent );
+        return role == Qt::DisplayRole ? m_columns.at( column ).constData() : nullptr;
+    }
+
+    void setValue( int row, int column, double value )
+    {
+        m_columns[ column ][ row ] = value;
+        Q_EMIT dataChanged( index( row, column ), index( row, column ) );
+    }
+
+    void appendRows( int count, double value )
+    {
+        const int rows = m_columns.first().count();
+        beginInsertRows( QModelIndex(), rows, rows + count - 1 );
+        for ( int column = 0; column < m_columns.count(); ++column ) {
+            m_columns[ column ].insert( rows, count, value );
+        }
+        endInsertRows();
+    }
+
+    bool mayContainHiddenData( int column, const QModelIndex& parent ) const override
+    {
+        Q_UNUSED( column );
+        Q_UNUSED( parent );
+        return false;
+    }
+
+    QVector< QVector< double > > m_columns;
+    mutable int displayDataCalls;
+};
+
+// a table model without the bulk interface, which counts the DataHiddenRole lookups
+class HidingModel : public QAbstractTableModel
+{
+public:
+    HidingModel( int rows )
+        : m_hidden( rows, false ),
+          hiddenDataCalls( 0 )
+    {
+    }
+
+    int rowCount( const QModelIndex& parent ) const override
+    {
+        return parent.isValid() ? 0 : m_hidden.count();
+    }
+
+    int columnCount( const QModelIndex& parent ) const override
+    {
+        return parent.isValid() ? 0 : 1;
+    }
+
+    QVariant data( const QModelIndex& index, int role ) const override
+    {
+        if ( role == KChart::DataHiddenRole ) {
+            ++hiddenDataCalls;
+            return m_hidden.at( index.row() );
+        }
+        return role == Qt::DisplayRole ? QVariant( index.row() % 10 ) : QVariant();
+    }
+
+    void hideRows( int firstRow, int lastRow )
+    {
+        for ( int row = firstRow; row <= lastRow; ++row ) {
+            m_hidden[ row ] = true;
+        }
+        Q_EMIT dataChanged( index( firstRow, 0 ), index( lastRow, 0 ) );
+    }
+
+    QVector< bool > m_hidden;
+    mutable int hiddenDataCalls;
+};
+
 class CartesianDiagramDataCompressorTests : public QObject
 {
     Q_OBJECT
@@ -179,11 +285,265 @@ private Q_SLOTS:
                   "datasetDimension == 1 should restore the old column count" );
     }
 
+    void bulkNumericSourceTest()
+    {
+        BulkModel bulkModel( ColumnCount, RowCount, 1.0 );
+        KChart::CartesianDiagramDataCompressor bulkCompressor;
+        bulkCompressor.setModel( &bulkModel );
+        bulkCompressor.setResolution( width, height );
+        QCOMPARE( bulkCompressor.modelDataRows(), compressor.modelDataRows() );
+        // both models hold the same values, so the compressed data must be identical
+        for ( int column = 0; column < ColumnCount; ++column ) {
+            for ( int row = 0; row < bulkCompressor.modelDataRows(); ++row ) {
+                const CachePosition position( row, column );
+                QCOMPARE( bulkCompressor.data( position ).key, compressor.data( position ).key );
+                QCOMPARE( bulkCompressor.data( position ).value, compressor.data( position ).value );
+                QCOMPARE( bulkCompressor.data( position ).hidden, false );
+            }
+        }
+        QVERIFY2( bulkModel.displayDataCalls == 0,
+                  "values should be read through the bulk interface, not through data()" );
+    }
+
+    void minMaxTest()
+    {
+        // a flat line with one spike in each direction
+        BulkModel spikeModel( 1, RowCount, 0.0 );
+        spikeModel.m_columns[ 0 ][ 123 ] = 10.0;
+        spikeModel.m_columns[ 0 ][ 777 ] = -10.0;
+        KChart::CartesianDiagramDataCompressor minMaxCompressor;
+        minMaxCompressor.setApproximationMode( KChart::CartesianDiagramDataCompressor::MinMax );
+        minMaxCompressor.setModel( &spikeModel );
+        minMaxCompressor.setResolution( 100, height );
+        QCOMPARE( minMaxCompressor.modelDataRows(), 4 * 100 );
+
+        // nothing is averaged away
+        const QPair< QPointF, QPointF > boundaries = minMaxCompressor.dataBoundaries();
+        QCOMPARE( boundaries.first, QPointF( 0, -10 ) );
+        QCOMPARE( boundaries.second, QPointF( RowCount - 1, 10 ) );
+
+        // the spike is kept, at its own key
+        const CachePosition spikePosition = minMaxCompressor.mapToCache( 123, 0 );
+        int visibleSpikes = 0;
+        for ( int slot = 0; slot < 4; ++slot ) {
+            const DataPoint point = minMaxCompressor.data( CachePosition( spikePosition.row + slot, 0 ) );
+            QCOMPARE( minMaxCompressor.mapToCache( point.index ), spikePosition );
+            if ( !point.hidden && point.key == 123 ) {
+                QCOMPARE( point.value, 10.0 );
+                ++visibleSpikes;
+            }
+        }
+        QCOMPARE( visibleSpikes, 1 );
+
+        // changing a value must update the extrema of its pixel
+        spikeModel.setValue( 123, 0, 0.0 );
+        for ( int slot = 0; slot < 4; ++slot ) {
+            QCOMPARE( minMaxCompressor.data( CachePosition( spikePosition.row + slot, 0 ) ).value, 0.0 );
+        }
+
+        // with no more than four rows per pixel, nothing needs to be compressed
+        minMaxCompressor.setResolution( RowCount / 4, height );
+        QCOMPARE( minMaxCompressor.modelDataRows(), RowCount );
+    }
+
+    void minMaxAlignedValueTest()
+    {
+        // the spikes of the two datasets are in different rows of the same pixels
+        BulkModel twoColumns( 2, RowCount, 0.0 );
+        for ( int row = 0; row < RowCount; ++row ) {
+            twoColumns.m_columns[ 0 ][ row ] = row % 7;
+            twoColumns.m_columns[ 1 ][ row ] = -( row % 5 );
+        }
+        KChart::CartesianDiagramDataCompressor minMaxCompressor;
+        minMaxCompressor.setApproximationMode( KChart::CartesianDiagramDataCompressor::MinMax );
+        minMaxCompressor.setModel( &twoColumns );
+        minMaxCompressor.setResolution( 100, height );
+        QCOMPARE( minMaxCompressor.modelDataRows(), 4 * 100 );
+
+        for ( int row = 0; row < minMaxCompressor.modelDataRows(); ++row ) {
+            const CachePosition position( row, 0 );
+            const DataPoint point = minMaxCompressor.data( position );
+            QCOMPARE( minMaxCompressor.alignedValue( position, 1 ),
+                      twoColumns.m_columns.at( 1 ).at( point.index.row() ) );
+        }
+        QVERIFY( qIsNaN( minMaxCompressor.alignedValue( CachePosition( 0, 0 ), 2 ) ) );
+    }
+
+    void pyramidTest()
+    {
+        // 64 rows per pixel, enough to compute the pixels from the level of detail pyramid
+        const int rows = 100 * 64;
+        BulkModel bigModel( 1, rows, 0.0 );
+        for ( int row = 0; row < rows; ++row ) {
+            bigModel.m_columns[ 0 ][ row ] = ( row * 7919 ) % 1009;
+        }
+        bigModel.m_columns[ 0 ][ 200 ] = std::numeric_limits< double >::quiet_NaN();
+        KChart::CartesianDiagramDataCompressor pyramidCompressor;
+        pyramidCompressor.setModel( &bigModel );
+        pyramidCompressor.setResolution( 100, height );
+        checkMeans( pyramidCompressor, bigModel, 64 );
+
+        // a changed value only needs its part of the pyramid to be updated
+        bigModel.setValue( 100, 0, 5000.0 );
+        checkMeans( pyramidCompressor, bigModel, 64 );
+
+        // zooming out reuses the pyramid
+        pyramidCompressor.setResolution( 50, height );
+        checkMeans( pyramidCompressor, bigModel, 128 );
+
+        // the extrema found through the pyramid are the first ones of each pixel
+        pyramidCompressor.setApproximationMode( KChart::CartesianDiagramDataCompressor::MinMax );
+        pyramidCompressor.setResolution( 100, height );
+        QCOMPARE( pyramidCompressor.modelDataRows(), 4 * 100 );
+        const QVector< double >& values = bigModel.m_columns.at( 0 );
+        for ( int pixel = 0; pixel < 100; ++pixel ) {
+            int minRow = -1;
+            int maxRow = -1;
+            for ( int row = pixel * 64; row < ( pixel + 1 ) * 64; ++row ) {
+                if ( minRow == -1 || values.at( row ) < values.at( minRow ) ) {
+                    minRow = row;
+                }
+                if ( maxRow == -1 || values.at( row ) > values.at( maxRow ) ) {
+                    maxRow = row;
+                }
+            }
+            QCOMPARE( pyramidCompressor.data( CachePosition( pixel * 4 + 1, 0 ) ).key, qreal( qMin( minRow, maxRow ) ) );
+            QCOMPARE( pyramidCompressor.data( CachePosition( pixel * 4 + 2, 0 ) ).key, qreal( qMax( minRow, maxRow ) ) );
+        }
+        QCOMPARE( pyramidCompressor.dataBoundaries().second, QPointF( rows - 1, 5000 ) );
+    }
+
+    void pyramidBoundariesTest()
+    {
+        // no missing values, so the boundaries come straight from the pyramid, and
+        // the extrema sit right at and next to the boundaries of pyramid buckets
+        const int rows = 100 * 64;
+        BulkModel bigModel( 1, rows, 0.0 );
+        QVector< double >& values = bigModel.m_columns[ 0 ];
+        for ( int row = 0; row < rows; ++row ) {
+            values[ row ] = ( row * 7919 ) % 1009;
+        }
+        values[ 10 * 64 + 63 ] = 5000.0; // last row of a pixel
+        values[ 20 * 64 ] = -5000.0; // first row of a pixel
+        values[ 30 * 64 + 15 ] = 3000.0; // last row of a base bucket...
+        values[ 30 * 64 + 16 ] = 3000.0; // ...and the first one of the next, the first one wins
+        values[ 40 * 64 + 31 ] = -3000.0; // both halves of a pixel
+        values[ 40 * 64 + 32 ] = -3000.0;
+
+        KChart::CartesianDiagramDataCompressor pyramidCompressor;
+        pyramidCompressor.setApproximationMode( KChart::CartesianDiagramDataCompressor::MinMax );
+        pyramidCompressor.setModel( &bigModel );
+        pyramidCompressor.setResolution( 100, height );
+        QCOMPARE( pyramidCompressor.modelDataRows(), 4 * 100 );
+
+        const QPair< QPointF, QPointF > boundaries = pyramidCompressor.dataBoundaries();
+        QCOMPARE( boundaries.first, QPointF( 0, -5000 ) );
+        QCOMPARE( boundaries.second, QPointF( rows - 1, 5000 ) );
+
+        for ( int pixel = 0; pixel < 100; ++pixel ) {
+            int minRow = -1;
+            int maxRow = -1;
+            for ( int row = pixel * 64; row < ( pixel + 1 ) * 64; ++row ) {
+                if ( minRow == -1 || values.at( row ) < values.at( minRow ) ) {
+                    minRow = row;
+                }
+                if ( maxRow == -1 || values.at( row ) > values.at( maxRow ) ) {
+                    maxRow = row;
+                }
+            }
+            QCOMPARE( pyramidCompressor.data( CachePosition( pixel * 4 + 1, 0 ) ).key, qreal( qMin( minRow, maxRow ) ) );
+            QCOMPARE( pyramidCompressor.data( CachePosition( pixel * 4 + 2, 0 ) ).key, qreal( qMax( minRow, maxRow ) ) );
+        }
+        QCOMPARE( pyramidCompressor.data( CachePosition( 10 * 4 + 2, 0 ) ).key, qreal( 10 * 64 + 63 ) );
+        QCOMPARE( pyramidCompressor.data( CachePosition( 20 * 4 + 1, 0 ) ).key, qreal( 20 * 64 ) );
+        QCOMPARE( pyramidCompressor.data( CachePosition( 30 * 4 + 1, 0 ) ).key, qreal( 30 * 64 + 15 ) );
+        QCOMPARE( pyramidCompressor.data( CachePosition( 40 * 4 + 2, 0 ) ).key, qreal( 40 * 64 + 31 ) );
+    }
+
+    void hiddenDataTest()
+    {
+        const int rows = 100 * 64;
+        HidingModel hidingModel( rows );
+        KChart::CartesianDiagramDataCompressor hidingCompressor;
+        hidingCompressor.setModel( &hidingModel );
+        hidingCompressor.setResolution( 100, height );
+        for ( int pixel = 0; pixel < hidingCompressor.modelDataRows(); ++pixel ) {
+            QCOMPARE( hidingCompressor.data( CachePosition( pixel, 0 ) ).hidden, false );
+        }
+        // every row has been asked once, to find out that none is hidden
+        QCOMPARE( hidingModel.hiddenDataCalls, rows );
+
+        // zooming does not ask again
+        hidingCompressor.setResolution( 50, height );
+        hidingCompressor.setResolution( 200, height );
+        for ( int pixel = 0; pixel < hidingCompressor.modelDataRows(); ++pixel ) {
+            hidingCompressor.data( CachePosition( pixel, 0 ) );
+        }
+        QCOMPARE( hidingModel.hiddenDataCalls, rows );
+
+        // hidden rows are noticed when they change
+        hidingModel.hideRows( 3 * 32, 4 * 32 - 1 );
+        QCOMPARE( hidingCompressor.data( CachePosition( 3, 0 ) ).hidden, true );
+        QCOMPARE( hidingCompressor.data( CachePosition( 4, 0 ) ).hidden, false );
+    }
+
+    void appendOptimizedTest()
+    {
+        BulkModel appendModel( 1, RowCount, 1.0 );
+        KChart::CartesianDiagramDataCompressor appendCompressor;
+        appendCompressor.setAppendOptimized( true );
+        appendCompressor.setModel( &appendModel );
+        appendCompressor.setResolution( 100, height );
+        // ten rows per pixel
+        QCOMPARE( appendCompressor.modelDataRows(), 100 );
+        QCOMPARE( appendCompressor.dataBoundaries().first, QPointF( 4.5, 1 ) );
+        QCOMPARE( appendCompressor.dataBoundaries().second, QPointF( 994.5, 1 ) );
+
+        // appended rows start a new pixel instead of moving all the pixel boundaries
+        appendModel.appendRows( 5, 3.0 );
+        QCOMPARE( appendCompressor.modelDataRows(), 101 );
+        QCOMPARE( appendCompressor.data( CachePosition( 99, 0 ) ).value, 1.0 );
+        QCOMPARE( appendCompressor.data( CachePosition( 100, 0 ) ).key, 1002.0 );
+        QCOMPARE( appendCompressor.data( CachePosition( 100, 0 ) ).value, 3.0 );
+        QCOMPARE( appendCompressor.dataBoundaries().first, QPointF( 4.5, 1 ) );
+        QCOMPARE( appendCompressor.dataBoundaries().second, QPointF( 1002, 3 ) );
+
+        // the pixel that was incomplete gets completed
+        appendModel.appendRows( 5, 3.0 );
+        QCOMPARE( appendCompressor.modelDataRows(), 101 );
+        QCOMPARE( appendCompressor.data( CachePosition( 100, 0 ) ).key, 1004.5 );
+        QCOMPARE( appendCompressor.dataBoundaries().second, QPointF( 1004.5, 3 ) );
+
+        // when there are twice as many pixels as wanted, the rows per pixel are recalculated
+        appendModel.appendRows( RowCount, 1.0 );
+        QCOMPARE( appendCompressor.modelDataRows(), 96 );
+        QCOMPARE( appendCompressor.data( CachePosition( 0, 0 ) ).key, 10.0 );
+    }
+
     void cleanupTestCase()
     {
     }
 
 private:
+    // compares the compressed values to the means of rowsPerPixel rows, missing values counting as zero
+    void checkMeans( const KChart::CartesianDiagramDataCompressor& pyramidCompressor, const BulkModel& bigModel,
+                     int rowsPerPixel )
+    {
+        const QVector< double >& values = bigModel.m_columns.at( 0 );
+        QCOMPARE( pyramidCompressor.modelDataRows(), values.count() / rowsPerPixel );
+        for ( int pixel = 0; pixel < pyramidCompressor.modelDataRows(); ++pixel ) {
+            double sum = 0.0;
+            for ( int row = pixel * rowsPerPixel; row < ( pixel + 1 ) * rowsPerPixel; ++row ) {
+                if ( !qIsNaN( values.at( row ) ) ) {
+                    sum += values.at( row );
+                }
+            }
+            const DataPoint& point = pyramidCompressor.data( CachePosition( pixel, 0 ) );
+            QCOMPARE( point.key, pixel * rowsPerPixel + ( rowsPerPixel - 1 ) / 2.0 );
+            QCOMPARE( point.value, sum / rowsPerPixel );
+        }
+    }
+
     KChart::CartesianDiagramDataCompressor compressor;
     QStandardItemModel model;
     static const int RowCount;
@@ -11,6 +11,10 @@
 #include <QPointF>
 #include <QPair>
 #include <QString>
+#include <QImage>
+#include <QPainter>
+#include <QSemaphore>
+#include <QThreadPool>
 #include <KChartChart>
 #include <KChartCartesianCoordinatePlane>
 #include <KChartBarDiagram>
@@ -20,6 +24,23 @@
 
 using namespace KChart;
 
+// moves everything to the right, like an application might do
+class ShiftedPlane : public CartesianCoordinatePlane
+{
+public:
+    explicit ShiftedPlane( Chart* parent )
+        : CartesianCoordinatePlane( parent )
+    {
+        // the batch translation would bypass translate()
+        setBatchTranslationEnabled( false );
+    }
+
+    const QPointF translate( const QPointF& diagramPoint ) const override
+    {
+        return CartesianCoordinatePlane::translate( diagramPoint ) + QPointF( 10.0, 0.0 );
+    }
+};
+
 class NumericDataModel : public QStandardItemModel
 {
     Q_OBJECT
@@ -77,6 +98,8 @@ private Q_SLOTS:
     void testGlobalGridAttributesSettings();
     void testGridAttributesSettings();
     void testAxesCalcModesSettings();
+    void testTranslatePoints();
+    void testParallelPlaneRendering();
 
 private:
     void doTestRangeSettings( AbstractCartesianDiagram *diagram, const QPointF &min, const QPointF &max );
@@ -278,6 +301,100 @@ void TestCartesianPlanes::testAxesCalcModesSettings()
     QCOMPARE( m_plane->axesCalcModeY(), AbstractCoordinatePlane::Linear );
 }
 
+void TestCartesianPlanes::testTranslatePoints()
+{
+    QList< QPointF > points;
+    points << QPointF( 1.0, 40.0 ) << QPointF( 2.0, 45.0 ) << QPointF( 3.0, 42.0 )
+           << QPointF( 4.0, 34.0 ) << QPointF( 5.0, 34.0 );
+    m_model->setXyValues( points );
+    m_plane->addDiagram( m_plotter );
+
+    QVector< qreal > keys;
+    QVector< qreal > values;
+    for ( int i = 0; i < 20; ++i ) {
+        keys << 1.0 + i * 0.25;
+        values << 30.0 + i;
+    }
+    QVector< QPointF > screenPoints( keys.size() );
+
+    const AbstractCoordinatePlane::AxesCalcMode modes[ 2 ] = {
+        AbstractCoordinatePlane::Linear, AbstractCoordinatePlane::Logarithmic
+    };
+    for ( AbstractCoordinatePlane::AxesCalcMode modeX : modes ) {
+        for ( AbstractCoordinatePlane::AxesCalcMode modeY : modes ) {
+            m_plane->setAxesCalcModeX( modeX );
+            m_plane->setAxesCalcModeY( modeY );
+            // lay out the plane, so that it has a transformation
+            QImage image( 400, 300, QImage::Format_ARGB32_Premultiplied );
+            QPainter painter( &image );
+            m_chart->paint( &painter, image.rect() );
+            painter.end();
+
+            m_plane->translatePoints( keys.constData(), values.constData(), screenPoints.data(), keys.size() );
+            for ( int i = 0; i < keys.size(); ++i ) {
+                QCOMPARE( screenPoints.at( i ), m_plane->translate( QPointF( keys.at( i ), values.at( i ) ) ) );
+            }
+        }
+    }
+
+    // a reimplemented translate() is honored
+    Chart chart;
+    ShiftedPlane* shifted = new ShiftedPlane( &chart );
+    chart.replaceCoordinatePlane( shifted );
+    Plotter* plotter = new Plotter;
+    plotter->setModel( m_model );
+    shifted->addDiagram( plotter );
+    QImage image( 400, 300, QImage::Format_ARGB32_Premultiplied );
+    QPainter painter( &image );
+    chart.paint( &painter, image.rect() );
+    painter.end();
+    shifted->translatePoints( keys.constData(), values.constData(), screenPoints.data(), keys.size() );
+    for ( int i = 0; i < keys.size(); ++i ) {
+        QCOMPARE( screenPoints.at( i ), shifted->translate( QPointF( keys.at( i ), values.at( i ) ) ) );
+    }
+}
+
+void TestCartesianPlanes::testParallelPlaneRendering()
+{
+    QList< QPointF > points;
+    points << QPointF( 1.0, 40.0 ) << QPointF( 2.0, 45.0 ) << QPointF( 3.0, 42.0 )
+           << QPointF( 4.0, 34.0 ) << QPointF( 5.0, 34.0 );
+    m_model->setXyValues( points );
+
+    // one plane per diagram, stacked like planes sharing an abscissa
+    Chart chart;
+    chart.coordinatePlane()->replaceDiagram( new BarDiagram );
+    chart.coordinatePlane()->diagram()->setModel( m_model );
+    for ( int i = 0; i < 3; ++i ) {
+        CartesianCoordinatePlane* plane = new CartesianCoordinatePlane( &chart );
+        chart.addCoordinatePlane( plane );
+        Plotter* plotter = new Plotter;
+        plotter->setModel( m_model );
+        plane->addDiagram( plotter );
+    }
+
+    auto render = [ &chart ]() {
+        QImage image( 400, 600, QImage::Format_ARGB32_Premultiplied );
+        image.fill( Qt::white );
+        QPainter painter( &image );
+        chart.paint( &painter, image.rect() );
+        painter.end();
+        return image;
+    };
+    const QImage sequential = render();
+    chart.setParallelPlaneRenderingEnabled( true );
+    QCOMPARE( render(), sequential );
+
+    // a saturated pool must not block painting, this thread rasterizes on its own then
+    QThreadPool::globalInstance()->setMaxThreadCount( 1 );
+    QSemaphore release;
+    QThreadPool::globalInstance()->start( [ &release ]() { release.acquire(); } );
+    QCOMPARE( render(), sequential );
+    release.release();
+    QThreadPool::globalInstance()->waitForDone();
+    QThreadPool::globalInstance()->setMaxThreadCount( QThread::idealThreadCount() );
+}
+
 
 QTEST_MAIN(TestCartesianPlanes)
 
@@ -73,9 +73,12 @@ private Q_SLOTS:
             LineAttributes attrs;
             attrs.setMissingValuesPolicy( LineAttributes::MissingValuesShownAsZero );
             diagram->setLineAttributes( attrs );
+            diagram->setAppendOptimized( true );
             LineDiagram* clone = diagram->clone();
             QCOMPARE( diagram->type(), clone->type() );
             QCOMPARE( diagram->lineAttributes(), clone->lineAttributes() );
+            QVERIFY( clone->isAppendOptimized() );
+            QVERIFY( clone->compare( diagram ) );
 
             // the rest is already tested in testCloningBarDiagram()
         }
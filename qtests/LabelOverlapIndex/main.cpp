@@ -0,0 +1,65 @@
+/**
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QtTest/QtTest>
+#include <QTransform>
+#include <KChartLabelOverlapIndex_p.h>
+
+using namespace KChart;
+
+class TestLabelOverlapIndex : public QObject {
+  Q_OBJECT
+private Q_SLOTS:
+
+  void testRects()
+  {
+      LabelOverlapIndex index( 10.0 );
+      index.insert( QRectF( 0, 0, 30, 10 ) );
+      QVERIFY( index.intersects( QRectF( 25, 5, 30, 10 ) ) );
+      // touching is no overlap
+      QVERIFY( !index.intersects( QRectF( 30, 0, 30, 10 ) ) );
+      QVERIFY( !index.intersects( QRectF( 0, 10, 30, 10 ) ) );
+      QVERIFY( !index.intersects( QRectF( -100, -100, 5, 5 ) ) );
+      // a label covering many cells
+      QVERIFY( index.intersects( QRectF( -1000, -1000, 2000, 2000 ) ) );
+      QCOMPARE( index.count(), 1 );
+  }
+
+  void testRotated()
+  {
+      LabelOverlapIndex index;
+      QTransform transform;
+      transform.translate( 100, 100 );
+      transform.rotate( 45 );
+      // a diamond with corners at distance 14.1 from ( 100, 100 )
+      const QPolygonF diamond = transform.map( QPolygonF( QRectF( -10, -10, 20, 20 ) ) );
+      index.insert( diamond );
+      // inside the diamond's bounding rect, but not inside the diamond
+      QVERIFY( !index.intersects( QRectF( 86, 86, 4, 4 ) ) );
+      QVERIFY( index.intersects( QRectF( 98, 98, 4, 4 ) ) );
+  }
+
+  void testUpdate()
+  {
+      LabelOverlapIndex index;
+      const int first = index.insert( QRectF( 0, 0, 20, 10 ) );
+      const int second = index.insert( QRectF( 10, 0, 20, 10 ) );
+      QVERIFY( index.intersects( QPolygonF( QRectF( 0, 0, 20, 10 ) ), first ) );
+      index.update( second, QPolygonF( QRectF( 200, 0, 20, 10 ) ) );
+      QVERIFY( !index.intersects( QPolygonF( QRectF( 0, 0, 20, 10 ) ), first ) );
+      QVERIFY( index.intersects( QRectF( 205, 5, 1, 1 ) ) );
+
+      index.clear();
+      QCOMPARE( index.count(), 0 );
+      QVERIFY( !index.intersects( QRectF( 205, 5, 1, 1 ) ) );
+  }
+};
+
+QTEST_MAIN(TestLabelOverlapIndex)
+
+#include "main.moc"
@@ -7,10 +7,18 @@
  */
 
 #include <QtTest/QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPicture>
+#include <QStandardItemModel>
 #include <KChartChart>
 #include <KChartGlobal>
 #include <KChartLineDiagram>
 #include <KChartThreeDLineAttributes>
+#include <KChartDataValueAttributes>
+#include <KChartMarkerAttributes>
+#include <KChartTextAttributes>
 #include <KChartCartesianCoordinatePlane>
 
 #include <TableModel.h>
@@ -159,6 +167,241 @@ private Q_SLOTS:
         QVERIFY( m_lines->threeDLineAttributes().lineYRotation() == 25 );
     }
 
+    void testRenderCache()
+    {
+        m_chart->resize( 400, 300 );
+        QVERIFY( !m_chart->isRenderCacheEnabled() );
+        m_chart->setRenderCacheEnabled( true );
+        QVERIFY( m_chart->isRenderCacheEnabled() );
+
+        const QImage cached = m_chart->grab().toImage();
+        QCOMPARE( m_chart->grab().toImage(), cached );
+
+        // changing the diagram must not show the old rendering
+        const QPen oldPen = m_lines->pen( 0 );
+        m_lines->setPen( 0, QPen( Qt::red, 5 ) );
+        QVERIFY( m_chart->grab().toImage() != cached );
+        m_lines->setPen( 0, oldPen );
+
+        m_chart->setRenderCacheEnabled( false );
+    }
+
+    void testRenderToImage()
+    {
+        m_chart->resize( 400, 300 );
+        const QRect geometry = m_chart->geometry();
+
+        const QImage image = m_chart->renderToImage( QSize( 800, 200 ), 192.0 );
+        QCOMPARE( image.size(), QSize( 800, 200 ) );
+        QCOMPARE( image.logicalDpiX(), 192 );
+        // something has been drawn
+        QVERIFY( image != QImage( image.size(), image.format() ) );
+        // the widget is left alone
+        QCOMPARE( m_chart->geometry(), geometry );
+
+        QVERIFY( m_chart->renderToImage( QSize() ).isNull() );
+    }
+
+    void testTracing()
+    {
+        m_chart->resize( 400, 300 );
+        QVERIFY( !m_chart->isTracingEnabled() );
+        QVector< RenderTrace > traces;
+        auto collect = [ &traces ]( const RenderTrace& trace ) {
+            traces.append( trace );
+        };
+        const QMetaObject::Connection connection = connect( m_chart, &Chart::frameTraced, this, collect );
+
+        m_chart->grab();
+        QVERIFY( traces.isEmpty() );
+
+        m_chart->setTracingEnabled( true );
+        m_chart->grab();
+        QCOMPARE( traces.size(), 1 );
+        const RenderTrace& trace = traces.first();
+        QCOMPARE( trace.frame, 1 );
+        QVERIFY( trace.durationNanoseconds > 0 );
+        QStringList stages;
+        for ( const RenderTrace::Event& event : trace.events ) {
+            stages.append( event.stage );
+        }
+        QVERIFY( stages.contains( QStringLiteral( "frame" ) ) );
+        QVERIFY( stages.contains( QStringLiteral( "plane" ) ) );
+        QVERIFY( stages.contains( QStringLiteral( "diagram" ) ) );
+        QVERIFY( trace.count( QStringLiteral( "line segments painted" ) ) > 0 );
+
+        const QJsonDocument json = QJsonDocument::fromJson( trace.toChromeTraceJson() );
+        QVERIFY( json.isObject() );
+        // the stages, and the counters
+        QVERIFY( json.object().value( QStringLiteral( "traceEvents" ) ).toArray().size() > trace.events.size() );
+        QCOMPARE( trace.count( QStringLiteral( "markers painted" ) ), qint64( 0 ) );
+
+        // only markers that are actually drawn are counted
+        const DataValueAttributes oldDva( m_lines->dataValueAttributes() );
+        DataValueAttributes dva( oldDva );
+        MarkerAttributes ma( dva.markerAttributes() );
+        ma.setVisible( true );
+        ma.setMarkerStyle( MarkerAttributes::NoMarker );
+        dva.setMarkerAttributes( ma );
+        dva.setVisible( true );
+        m_lines->setDataValueAttributes( dva );
+        m_chart->grab();
+        QCOMPARE( traces.size(), 2 );
+        QCOMPARE( traces.last().count( QStringLiteral( "markers painted" ) ), qint64( 0 ) );
+
+        ma.setMarkerStyle( MarkerAttributes::MarkerCircle );
+        dva.setMarkerAttributes( ma );
+        m_lines->setDataValueAttributes( dva );
+        m_chart->grab();
+        QCOMPARE( traces.size(), 3 );
+        QVERIFY( traces.last().count( QStringLiteral( "markers painted" ) ) > 0 );
+        m_lines->setDataValueAttributes( oldDva );
+
+        m_chart->setTracingEnabled( false );
+        m_chart->grab();
+        QCOMPARE( traces.size(), 3 );
+        disconnect( connection );
+    }
+
+    void testLazyHitTesting()
+    {
+        m_chart->resize( 400, 300 );
+        // markers and line segments are mapped as circles and lines
+        const DataValueAttributes oldDva( m_lines->dataValueAttributes() );
+        DataValueAttributes dva( oldDva );
+        MarkerAttributes ma( dva.markerAttributes() );
+        ma.setVisible( true );
+        dva.setMarkerAttributes( ma );
+        dva.setVisible( true );
+        m_lines->setDataValueAttributes( dva );
+
+        QImage image( 400, 300, QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &image );
+        m_chart->paint( &painter, image.rect() );
+        const QModelIndexList eagerHits = m_lines->indexesIn( image.rect() );
+        QVERIFY( !eagerHits.isEmpty() );
+        const QRect eagerRect = m_lines->visualRect( eagerHits.first() );
+
+        m_lines->setHitTestingPolicy( AbstractDiagram::HitTestingLazy );
+        m_chart->paint( &painter, image.rect() );
+        QCOMPARE( m_lines->indexesIn( image.rect() ), eagerHits );
+        QCOMPARE( m_lines->visualRect( eagerHits.first() ), eagerRect );
+
+        m_lines->setHitTestingPolicy( AbstractDiagram::HitTestingEager );
+        m_lines->setDataValueAttributes( oldDva );
+    }
+
+    void testSourceModelCellPens()
+    {
+        // the pens come from the source model, the diagram has none set for single cells
+        QStandardItemModel model( 6, 1 );
+        for ( int row = 0; row < model.rowCount(); ++row ) {
+            model.setData( model.index( row, 0 ), row % 2 ? 10.0 : 20.0 );
+        }
+        Chart chart;
+        LineDiagram* lines = new LineDiagram;
+        lines->setModel( &model );
+        lines->setAntiAliasing( false );
+        lines->setPen( 0, QPen( Qt::blue, 5 ) );
+        chart.coordinatePlane()->replaceDiagram( lines );
+
+        int redPixels = 0;
+        int bluePixels = 0;
+        auto paintChart = [&]() {
+            QImage image( 400, 300, QImage::Format_ARGB32_Premultiplied );
+            image.fill( Qt::white );
+            QPainter painter( &image );
+            chart.paint( &painter, image.rect() );
+            painter.end();
+            redPixels = 0;
+            bluePixels = 0;
+            for ( int y = 0; y < image.height(); ++y ) {
+                for ( int x = 0; x < image.width(); ++x ) {
+                    const QRgb pixel = image.pixel( x, y );
+                    redPixels += pixel == qRgb( 255, 0, 0 );
+                    bluePixels += pixel == qRgb( 0, 0, 255 );
+                }
+            }
+        };
+
+        paintChart();
+        QCOMPARE( redPixels, 0 );
+        QVERIFY( bluePixels > 0 );
+
+        // the diagram remembers that the model had no pens until the model changes
+        for ( int row = 3; row < model.rowCount(); ++row ) {
+            model.setData( model.index( row, 0 ), QVariant::fromValue( QPen( Qt::red, 5 ) ), DatasetPenRole );
+        }
+        paintChart();
+        QVERIFY( redPixels > 0 );
+        QVERIFY( bluePixels > 0 );
+    }
+
+    void testMixedMarkerStyles()
+    {
+        // three datasets with the same values, so that their markers are stacked
+        QStandardItemModel model( 5, 3 );
+        for ( int row = 0; row < model.rowCount(); ++row ) {
+            for ( int column = 0; column < model.columnCount(); ++column ) {
+                model.setData( model.index( row, column ), row % 2 ? 10.0 : 20.0 );
+            }
+        }
+        Chart chart;
+        LineDiagram* lines = new LineDiagram;
+        lines->setModel( &model );
+        chart.coordinatePlane()->replaceDiagram( lines );
+
+        QPainterPath path;
+        path.addRect( -3, -3, 6, 6 );
+        const MarkerAttributes::MarkerStyle styles[] = {
+            MarkerAttributes::MarkerSquare, MarkerAttributes::PainterPathMarker, MarkerAttributes::Marker4Pixels
+        };
+        const QColor colors[] = { Qt::red, Qt::blue, Qt::darkGreen };
+        for ( int column = 0; column < model.columnCount(); ++column ) {
+            DataValueAttributes dva( lines->dataValueAttributes( column ) );
+            TextAttributes ta( dva.textAttributes() );
+            ta.setVisible( false );
+            dva.setTextAttributes( ta );
+            MarkerAttributes ma( dva.markerAttributes() );
+            ma.setVisible( true );
+            ma.setMarkerStyle( styles[ column ] );
+            ma.setMarkerSize( QSizeF( 12, 12 ) );
+            ma.setMarkerColor( colors[ column ] );
+            ma.setCustomMarkerPath( path );
+            ma.setPen( QPen( colors[ column ] ) );
+            dva.setMarkerAttributes( ma );
+            dva.setVisible( true );
+            lines->setDataValueAttributes( column, dva );
+        }
+
+        // the vector path, recorded as a picture
+        QPicture picture;
+        QPainter picturePainter( &picture );
+        chart.paint( &picturePainter, QRect( 0, 0, 400, 300 ) );
+        picturePainter.end();
+        QImage vectorImage( 400, 300, QImage::Format_ARGB32_Premultiplied );
+        vectorImage.fill( Qt::white );
+        QPainter vectorPainter( &vectorImage );
+        vectorPainter.drawPicture( 0, 0, picture );
+        vectorPainter.end();
+
+        // sprites, where the raster engine allows them
+        QImage spriteImage( 400, 300, QImage::Format_ARGB32_Premultiplied );
+        spriteImage.fill( Qt::white );
+        QPainter spritePainter( &spriteImage );
+        chart.paint( &spritePainter, spriteImage.rect() );
+        spritePainter.end();
+
+        for ( int row = 0; row < model.rowCount(); ++row ) {
+            // the markers painted last are on top in both cases
+            const QPoint center = lines->visualRect( model.index( row, 2 ) ).center();
+            QVERIFY( vectorImage.pixel( center ) != qRgb( 255, 0, 0 ) );
+            QCOMPARE( spriteImage.pixel( center ), vectorImage.pixel( center ) );
+            const QPoint edge = center + QPoint( 0, 4 );
+            QCOMPARE( spriteImage.pixel( edge ), vectorImage.pixel( edge ) );
+        }
+    }
+
     void cleanupTestCase()
     {
     }
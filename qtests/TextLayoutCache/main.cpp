@@ -0,0 +1,78 @@
+/**
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QtTest/QtTest>
+#include <QTextDocument>
+#include <KChartTextLayoutCache_p.h>
+
+using namespace KChart;
+
+class TestTextLayoutCache : public QObject {
+  Q_OBJECT
+private Q_SLOTS:
+
+  void testHitsAndMisses()
+  {
+      TextLayoutCache cache;
+      QFont font;
+      font.setPointSize( 10 );
+      const QRectF rect = cache.boundingRect( QStringLiteral( "12.5" ), font, nullptr );
+      QVERIFY( rect.width() > 0.0 );
+      QCOMPARE( cache.misses(), 1 );
+      QCOMPARE( cache.hits(), 0 );
+
+      QCOMPARE( cache.boundingRect( QStringLiteral( "12.5" ), font, nullptr ), rect );
+      QCOMPARE( cache.hits(), 1 );
+
+      // a different font is a different layout
+      QFont bigFont = font;
+      bigFont.setPointSize( 20 );
+      QVERIFY( cache.boundingRect( QStringLiteral( "12.5" ), bigFont, nullptr ).height() > rect.height() );
+      QCOMPARE( cache.misses(), 2 );
+      QCOMPARE( cache.count(), 2 );
+
+      cache.resetStatistics();
+      QCOMPARE( cache.hits(), 0 );
+      QCOMPARE( cache.misses(), 0 );
+  }
+
+  void testRichText()
+  {
+      TextLayoutCache cache;
+      const QFont font;
+      QTextDocument* doc = cache.document( QStringLiteral( "<b>42</b>" ), font, nullptr );
+      QCOMPARE( doc->toPlainText(), QStringLiteral( "42" ) );
+      doc = cache.document( QStringLiteral( "&lt;42" ), font, nullptr );
+      QCOMPARE( doc->toPlainText(), QStringLiteral( "&lt;42" ) );
+  }
+
+  void testEviction()
+  {
+      TextLayoutCache cache( 2 );
+      const QFont font;
+      cache.boundingRect( QStringLiteral( "1" ), font, nullptr );
+      cache.boundingRect( QStringLiteral( "2" ), font, nullptr );
+      // makes "1" the most recently used entry
+      cache.boundingRect( QStringLiteral( "1" ), font, nullptr );
+      cache.boundingRect( QStringLiteral( "3" ), font, nullptr );
+      QCOMPARE( cache.count(), 2 );
+
+      cache.resetStatistics();
+      cache.boundingRect( QStringLiteral( "1" ), font, nullptr );
+      QCOMPARE( cache.hits(), 1 );
+      cache.boundingRect( QStringLiteral( "2" ), font, nullptr );
+      QCOMPARE( cache.misses(), 1 );
+
+      cache.clear();
+      QCOMPARE( cache.count(), 0 );
+  }
+};
+
+QTEST_MAIN(TestTextLayoutCache)
+
+#include "main.moc"
@@ -112,6 +112,25 @@ namespace KChart {
             return transform.map( data );
         }
 
+        // convert count data space points, given as separate arrays of keys (x) and values (y),
+        // to screen points; the same as calling translate() for each of them
+        void translate( const qreal* keys, const qreal* values, QPointF* screenPoints, int count ) const
+        {
+            if ( axesCalcModeX == CartesianCoordinatePlane::Logarithmic ) {
+                if ( axesCalcModeY == CartesianCoordinatePlane::Logarithmic ) {
+                    translatePoints< true, true >( keys, values, screenPoints, count );
+                } else {
+                    translatePoints< true, false >( keys, values, screenPoints, count );
+                }
+            } else {
+                if ( axesCalcModeY == CartesianCoordinatePlane::Logarithmic ) {
+                    translatePoints< false, true >( keys, values, screenPoints, count );
+                } else {
+                    translatePoints< false, false >( keys, values, screenPoints, count );
+                }
+            }
+        }
+
         // convert screen point to data space point
         inline const QPointF translateBack( const QPointF& screenPoint ) const
         {
@@ -124,6 +143,28 @@ namespace KChart {
             }
             return ret;
         }
+
+    private:
+        // The axis modes are template parameters so that the loop has no branches, which
+        // lets the compiler vectorize it. The transformation only scales and translates,
+        // see updateTransform().
+        template< bool logX, bool logY >
+        void translatePoints( const qreal* keys, const qreal* values, QPointF* screenPoints, int count ) const
+        {
+            Q_ASSERT( transform.type() <= QTransform::TxScale );
+            const qreal m11 = transform.m11();
+            const qreal m22 = transform.m22();
+            const qreal dx = transform.dx();
+            const qreal dy = transform.dy();
+            // a negative range maps value to -log10( -value ), see logTransform()
+            const qreal signX = isPositiveX ? 1.0 : -1.0;
+            const qreal signY = isPositiveY ? 1.0 : -1.0;
+            for ( int i = 0; i < count; ++i ) {
+                const qreal x = logX ? signX * log10( signX * keys[ i ] ) : keys[ i ];
+                const qreal y = logY ? signY * log10( signY * values[ i ] ) : values[ i ];
+                screenPoints[ i ] = QPointF( m11 * x + dx, m22 * y + dy );
+            }
+        }
     };
 
     typedef QList<CoordinateTransformation> CoordinateTransformationList;
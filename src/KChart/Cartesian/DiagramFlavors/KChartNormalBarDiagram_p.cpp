@@ -48,7 +48,9 @@ const QPair<QPointF, QPointF> NormalBarDiagram::calculateDataBoundaries() const
             const qreal value = ISNAN( point.value ) ? 0.0 : point.value;
 
             QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
-            ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes( sourceIndex );
+            QVariant threeDBuffer;
+            const ThreeDBarAttributes& threeDAttrs =
+                m_private->attributes< ThreeDBarAttributes >( sourceIndex, ThreeDBarAttributesRole, &threeDBuffer );
 
             if ( threeDAttrs.isEnabled() )
                 usedDepth = qMax( usedDepth, threeDAttrs.depth() );
@@ -142,6 +144,29 @@ void NormalBarDiagram::paint( PaintContext* ctx )
 
     LabelPaintCache lpc;
 
+    // translate the top and bottom points of all bars in one go
+    Q_ASSERT( dynamic_cast< CartesianCoordinatePlane* >( ctx->coordinatePlane() ) );
+    const CartesianCoordinatePlane* plane = static_cast< CartesianCoordinatePlane* >( ctx->coordinatePlane() );
+    const int pointCount = rowCount * colCount;
+    QVector< qreal > topKeys( pointCount );
+    QVector< qreal > bottomKeys( pointCount );
+    QVector< qreal > values( pointCount );
+    const QVector< qreal > zeros( pointCount, 0.0 );
+    for ( int row = 0; row < rowCount; ++row ) {
+        for ( int column = 0; column < colCount; ++column ) {
+            const CartesianDiagramDataCompressor::DataPoint& point =
+                compressor().data( CartesianDiagramDataCompressor::CachePosition( row, column ) );
+            const int i = row * colCount + column;
+            topKeys[ i ] = point.key + 0.5;
+            bottomKeys[ i ] = point.key;
+            values[ i ] = point.value;
+        }
+    }
+    QVector< QPointF > topPoints( pointCount );
+    QVector< QPointF > bottomPoints( pointCount );
+    plane->translatePoints( topKeys.constData(), values.constData(), topPoints.data(), pointCount );
+    plane->translatePoints( bottomKeys.constData(), zeros.constData(), bottomPoints.data(), pointCount );
+
     for ( int row = 0; row < rowCount; ++row ) {
         qreal offset = -groupWidth / 2 + spaceBetweenGroups / 2;
 
@@ -164,8 +189,8 @@ void NormalBarDiagram::paint( PaintContext* ctx )
             const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
             const qreal value = point.value;//attributesModel()->data( sourceIndex ).toReal();
             if ( ! point.hidden && !ISNAN( value ) ) {
-                QPointF topPoint = ctx->coordinatePlane()->translate( QPointF( point.key + 0.5, value ) );
-                QPointF bottomPoint =  ctx->coordinatePlane()->translate( QPointF( point.key, 0 ) );
+                QPointF topPoint = topPoints.at( row * colCount + column );
+                const QPointF bottomPoint = bottomPoints.at( row * colCount + column );
 
                 if ( threeDAttrs.isEnabled() ) {
                     const qreal usedDepth = threeDAttrs.depth() / 4;
@@ -50,18 +50,43 @@ void NormalLineDiagram::paint( PaintContext* ctx )
     LabelPaintCache lpc;
     LineAttributesInfoList lineList;
 
+    // when zoomed in, only compute the pixels that end up in the drawing area
+    const qreal offset = diagram()->centerDataPoints() ? 0.5 : 0;
+    const qreal leftKey = plane->translateBack( plane->drawingArea().topLeft() ).x() - offset;
+    const qreal rightKey = plane->translateBack( plane->drawingArea().bottomRight() ).x() - offset;
+    int firstRow;
+    int endRow;
+    compressor().cacheRowRange( qMin( leftKey, rightKey ), qMax( leftKey, rightKey ), &firstRow, &endRow );
+
+    // Get min. y value, used as lower or upper bounding for area highlighting
+    const qreal minYValue = qMin(plane->visibleDataRange().bottom(), plane->visibleDataRange().top());
+
+    // the points of a column are translated in one go, a and c of a row are b and d of the row before
+    const int pointCount = qMax( endRow - firstRow, 0 );
+    QVector< qreal > keys( pointCount );
+    QVector< qreal > values( pointCount );
+    const QVector< qreal > minYValues( pointCount, minYValue );
+    QVector< QPointF > valuePoints( pointCount );
+    QVector< QPointF > minYPoints( pointCount );
+
     const int step = rev ? -1 : 1;
     const int end = rev ? -1 : columnCount;
     for ( int column = rev ? columnCount - 1 : 0; column != end; column += step ) {
-        LineAttributes laPreviousCell;
         CartesianDiagramDataCompressor::DataPoint lastPoint;
-        qreal lastAreaBoundingValue = 0;
-
-        // Get min. y value, used as lower or upper bounding for area highlighting
-        const qreal minYValue = qMin(plane->visibleDataRange().bottom(), plane->visibleDataRange().top());
+        QPointF lastValuePoint = plane->translate( QPointF( lastPoint.key + offset, lastPoint.value ) );
+        QPointF lastAreaPoint = plane->translate( QPointF( lastPoint.key + offset, 0.0 ) );
+
+        for ( int i = 0; i < pointCount; ++i ) {
+            const CartesianDiagramDataCompressor::DataPoint& point =
+                compressor().data( CartesianDiagramDataCompressor::CachePosition( firstRow + i, column ) );
+            keys[ i ] = point.key + offset;
+            values[ i ] = point.value;
+        }
+        plane->translatePoints( keys.constData(), values.constData(), valuePoints.data(), pointCount );
+        plane->translatePoints( keys.constData(), minYValues.constData(), minYPoints.data(), pointCount );
 
         CartesianDiagramDataCompressor::CachePosition previousCellPosition;
-        for ( int row = 0; row < rowCount; ++row ) {
+        for ( int row = firstRow; row < endRow; ++row ) {
             const CartesianDiagramDataCompressor::CachePosition position( row, column );
             // get where to draw the line from:
             CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
@@ -71,19 +96,21 @@ void NormalLineDiagram::paint( PaintContext* ctx )
 
             const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
 
-            const LineAttributes laCell = diagram()->lineAttributes( sourceIndex );
+            QVariant laBuffer;
+            const LineAttributes& laCell = m_private->attributes< LineAttributes >( sourceIndex, LineAttributesRole, &laBuffer );
             const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
 
             // lower or upper bounding for the highlighted area
-            qreal areaBoundingValue;
+            QPointF d;
             if ( laCell.areaBoundingDataset() != -1 ) {
-                const CartesianDiagramDataCompressor::CachePosition areaBoundingCachePosition( row, laCell.areaBoundingDataset() );
-                areaBoundingValue = compressor().data( areaBoundingCachePosition ).value;
+                const qreal areaBoundingValue = compressor().alignedValue( position, laCell.areaBoundingDataset() );
+                d = plane->translate( QPointF( point.key + offset, areaBoundingValue ) );
             } else {
                 // Use min. y value (i.e. zero line in most cases) if no bounding dataset is set
-                areaBoundingValue = minYValue;
+                d = minYPoints.at( row - firstRow );
             }
 
+            QPointF b = valuePoints.at( row - firstRow );
             if ( ISNAN( point.value ) )
             {
                 switch ( policy )
@@ -94,6 +121,7 @@ void NormalLineDiagram::paint( PaintContext* ctx )
                 case LineAttributes::MissingValuesShownAsZero:
                     // set it to zero
                     point.value = 0.0;
+                    b = plane->translate( QPointF( point.key + offset, point.value ) );
                     break;
                 case LineAttributes::MissingValuesHideSegments:
                     // they're just hidden
@@ -106,11 +134,8 @@ void NormalLineDiagram::paint( PaintContext* ctx )
 
             if ( !ISNAN( point.value ) ) {
                 // area corners, a + b are the line ends:
-                const qreal offset = diagram()->centerDataPoints() ? 0.5 : 0;
-                const QPointF a( plane->translate( QPointF( lastPoint.key + offset, lastPoint.value ) ) );
-                const QPointF b( plane->translate( QPointF( point.key + offset, point.value ) ) );
-                const QPointF c( plane->translate( QPointF( lastPoint.key + offset, lastAreaBoundingValue ) ) );
-                const QPointF d( plane->translate( QPointF( point.key + offset, areaBoundingValue ) ) );
+                const QPointF a = lastValuePoint;
+                const QPointF c = lastAreaPoint;
                 const PositionPoints pts = PositionPoints( b, a, d, c );
 
                 // add label
@@ -131,9 +156,9 @@ void NormalLineDiagram::paint( PaintContext* ctx )
             }
 
             previousCellPosition = position;
-            laPreviousCell = laCell;
-            lastAreaBoundingValue = areaBoundingValue;
             lastPoint = point;
+            lastValuePoint = b;
+            lastAreaPoint = d;
         }
     }
 
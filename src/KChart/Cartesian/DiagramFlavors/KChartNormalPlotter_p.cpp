@@ -50,12 +50,18 @@ void NormalPlotter::paint( PaintContext* ctx )
         {
             LineAttributesInfoList lineList;
             PlotterDiagramCompressor::DataPoint lastPoint;
+            // a and c of a point are b and d of the point before
+            const QPointF noValuePoint = plane->translate( QPointF( lastPoint.key, lastPoint.value ) );
+            const QPointF noZeroPoint = plane->translate( QPointF( lastPoint.key, 0.0 ) );
+            QPointF lastValuePoint = noValuePoint;
+            QPointF lastZeroPoint = noZeroPoint;
             for ( PlotterDiagramCompressor::Iterator it = plotterCompressor().begin( dataset ); it != plotterCompressor().end( dataset ); ++ it )
             {
                 const PlotterDiagramCompressor::DataPoint point = *it;
 
                 const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
-                LineAttributes laCell = diagram()->lineAttributes( sourceIndex );
+                QVariant laBuffer;
+                const LineAttributes& laCell = m_private->attributes< LineAttributes >( sourceIndex, LineAttributesRole, &laBuffer );
                 const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
 
                 if ( ISNAN( point.key ) || ISNAN( point.value ) )
@@ -68,17 +74,19 @@ void NormalPlotter::paint( PaintContext* ctx )
                     case LineAttributes::MissingValuesHideSegments: // fall-through since they're just hidden
                     default:
                         lastPoint = PlotterDiagramCompressor::DataPoint();
+                        lastValuePoint = noValuePoint;
+                        lastZeroPoint = noZeroPoint;
                         continue;
                     }
                 }
 
                 // data area painting: a and b are prev / current data points, c and d are on the null line
                 const QPointF b( plane->translate( QPointF( point.key, point.value ) ) );
+                const QPointF d( plane->translate( QPointF( point.key, 0.0 ) ) );
 
                 if ( !point.hidden && PaintingHelpers::isFinite( b )  ) {
-                    const QPointF a( plane->translate( QPointF( lastPoint.key, lastPoint.value ) ) );
-                    const QPointF c( plane->translate( QPointF( lastPoint.key, 0.0 ) ) );
-                    const QPointF d( plane->translate( QPointF( point.key, 0.0 ) ) );
+                    const QPointF a = lastValuePoint;
+                    const QPointF c = lastZeroPoint;
 
                     // data point label
                     const PositionPoints pts = PositionPoints( b, a, d, c );
@@ -104,6 +112,8 @@ void NormalPlotter::paint( PaintContext* ctx )
                 }
 
                 lastPoint = point;
+                lastValuePoint = b;
+                lastZeroPoint = d;
             }
             PaintingHelpers::paintElements( m_private, ctx, lpc, lineList );
         }
@@ -112,10 +122,32 @@ void NormalPlotter::paint( PaintContext* ctx )
     {
         if ( colCount == 0 || rowCount == 0 )
             return;
+
+        // the points of a column are translated in one go, a and c of a row are b and d of the row before
+        QVector< qreal > keys( rowCount );
+        QVector< qreal > values( rowCount );
+        const QVector< qreal > zeros( rowCount, 0.0 );
+        QVector< QPointF > valuePoints( rowCount );
+        QVector< QPointF > zeroPoints( rowCount );
+        const CartesianDiagramDataCompressor::DataPoint noPoint;
+        const QPointF noValuePoint = plane->translate( QPointF( noPoint.key, noPoint.value ) );
+        const QPointF noZeroPoint = plane->translate( QPointF( noPoint.key, 0.0 ) );
+
         for ( int column = 0; column < colCount; ++column )
         {
             LineAttributesInfoList lineList;
             CartesianDiagramDataCompressor::DataPoint lastPoint;
+            QPointF lastValuePoint = noValuePoint;
+            QPointF lastZeroPoint = noZeroPoint;
+
+            for ( int row = 0; row < rowCount; ++row ) {
+                const CartesianDiagramDataCompressor::DataPoint& point =
+                    compressor().data( CartesianDiagramDataCompressor::CachePosition( row, column ) );
+                keys[ row ] = point.key;
+                values[ row ] = point.value;
+            }
+            plane->translatePoints( keys.constData(), values.constData(), valuePoints.data(), rowCount );
+            plane->translatePoints( keys.constData(), zeros.constData(), zeroPoints.data(), rowCount );
 
             for ( int row = 0; row < rowCount; ++row )
             {
@@ -123,7 +155,8 @@ void NormalPlotter::paint( PaintContext* ctx )
                 const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
 
                 const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
-                LineAttributes laCell = diagram()->lineAttributes( sourceIndex );
+                QVariant laBuffer;
+                const LineAttributes& laCell = m_private->attributes< LineAttributes >( sourceIndex, LineAttributesRole, &laBuffer );
                 const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
 
                 if ( ISNAN( point.key ) || ISNAN( point.value ) )
@@ -136,17 +169,19 @@ void NormalPlotter::paint( PaintContext* ctx )
                     case LineAttributes::MissingValuesHideSegments: // fall-through since they're just hidden
                     default:
                         lastPoint = CartesianDiagramDataCompressor::DataPoint();
+                        lastValuePoint = noValuePoint;
+                        lastZeroPoint = noZeroPoint;
                         continue;
                     }
                 }
 
                 // data area painting: a and b are prev / current data points, c and d are on the null line
-                const QPointF b( plane->translate( QPointF( point.key, point.value ) ) );
+                const QPointF b = valuePoints.at( row );
+                const QPointF d = zeroPoints.at( row );
 
                 if ( !point.hidden && PaintingHelpers::isFinite( b )  ) {
-                    const QPointF a( plane->translate( QPointF( lastPoint.key, lastPoint.value ) ) );
-                    const QPointF c( plane->translate( QPointF( lastPoint.key, 0.0 ) ) );
-                    const QPointF d( plane->translate( QPointF( point.key, 0.0 ) ) );
+                    const QPointF a = lastValuePoint;
+                    const QPointF c = lastZeroPoint;
 
                     // data point label
                     const PositionPoints pts = PositionPoints( b, a, d, c );
@@ -172,6 +207,8 @@ void NormalPlotter::paint( PaintContext* ctx )
                 }
 
                 lastPoint = point;
+                lastValuePoint = b;
+                lastZeroPoint = d;
             }
             PaintingHelpers::paintElements( m_private, ctx, lpc, lineList );
         }
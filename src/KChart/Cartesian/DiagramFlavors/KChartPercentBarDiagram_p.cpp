@@ -44,7 +44,9 @@ const QPair<QPointF, QPointF> PercentBarDiagram::calculateDataBoundaries() const
             const CartesianDiagramDataCompressor::CachePosition position( row, col );
             const CartesianDiagramDataCompressor::DataPoint p = compressor().data( position );
             QModelIndex sourceIndex = attributesModel()->mapToSource( p.index );
-            ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes( sourceIndex );
+            QVariant threeDBuffer;
+            const ThreeDBarAttributes& threeDAttrs =
+                m_private->attributes< ThreeDBarAttributes >( sourceIndex, ThreeDBarAttributesRole, &threeDBuffer );
 
             if ( threeDAttrs.isEnabled() && threeDAttrs.depth() > usedDepth ) {
                 usedDepth = threeDAttrs.depth();
@@ -148,7 +150,9 @@ void PercentBarDiagram::paint( PaintContext* ctx )
             const CartesianDiagramDataCompressor::CachePosition position( row, col );
             const CartesianDiagramDataCompressor::DataPoint p = compressor().data( position );
             QModelIndex sourceIndex = attributesModel()->mapToSource( p.index );
-            ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes( sourceIndex );
+            QVariant threeDBuffer;
+            const ThreeDBarAttributes& threeDAttrs =
+                m_private->attributes< ThreeDBarAttributes >( sourceIndex, ThreeDBarAttributesRole, &threeDBuffer );
 
             if ( threeDAttrs.isEnabled() ) {
                 if ( barWidth > 0 )
@@ -81,7 +81,8 @@ void PercentLineDiagram::paint( PaintContext* ctx )
             const CartesianDiagramDataCompressor::CachePosition position( row, col );
             CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
             const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
-            const LineAttributes laCell = diagram()->lineAttributes( sourceIndex );
+            QVariant laBuffer;
+            const LineAttributes& laCell = m_private->attributes< LineAttributes >( sourceIndex, LineAttributesRole, &laBuffer );
             const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
             if ( ISNAN( point.value ) && policy == LineAttributes::MissingValuesAreBridged )
                 point.value = interpolateMissingValue( position );
@@ -111,7 +112,8 @@ void PercentLineDiagram::paint( PaintContext* ctx )
             const CartesianDiagramDataCompressor::CachePosition position( row, column );
             CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
             const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
-            const LineAttributes laCell = diagram()->lineAttributes( sourceIndex );
+            QVariant laBuffer;
+            const LineAttributes& laCell = m_private->attributes< LineAttributes >( sourceIndex, LineAttributesRole, &laBuffer );
             const bool bDisplayCellArea = laCell.displayArea();
 
             qreal stackedValues = 0, nextValues = 0, nextKey = 0;
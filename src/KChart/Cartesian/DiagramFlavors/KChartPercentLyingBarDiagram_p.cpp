@@ -155,7 +155,9 @@ void PercentLyingBarDiagram::paint( PaintContext* ctx )
             const CartesianDiagramDataCompressor::CachePosition position( curRow, col );
             const CartesianDiagramDataCompressor::DataPoint p = compressor().data( position );
             QModelIndex sourceIndex = attributesModel()->mapToSource( p.index );
-            ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes( sourceIndex );
+            QVariant threeDBuffer;
+            const ThreeDBarAttributes& threeDAttrs =
+                m_private->attributes< ThreeDBarAttributes >( sourceIndex, ThreeDBarAttributesRole, &threeDBuffer );
 
             if ( threeDAttrs.isEnabled() ) {
                 if ( barWidth > 0 ) {
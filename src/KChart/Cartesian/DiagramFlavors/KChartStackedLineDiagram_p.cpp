@@ -116,7 +116,8 @@ void StackedLineDiagram::paint( PaintContext* ctx )
             CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
             const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
 
-            const LineAttributes laCell = diagram()->lineAttributes( sourceIndex );
+            QVariant laBuffer;
+            const LineAttributes& laCell = m_private->attributes< LineAttributes >( sourceIndex, LineAttributesRole, &laBuffer );
             const bool bDisplayCellArea = laCell.displayArea();
 
             const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
@@ -32,6 +32,7 @@ bool AbstractCartesianDiagram::compare( const AbstractCartesianDiagram* other )
     return  // compare the base class
             ( static_cast<const AbstractDiagram*>(this)->compare( other ) ) &&
             // compare own properties
+            (isAppendOptimized() == other->isAppendOptimized()) &&
             (referenceDiagram() == other->referenceDiagram()) &&
             ((! referenceDiagram()) || (referenceDiagramOffset() == other->referenceDiagramOffset()));
 }
@@ -147,6 +148,23 @@ QPointF AbstractCartesianDiagram::referenceDiagramOffset() const
     return d->referenceDiagramOffset;
 }
 
+void AbstractCartesianDiagram::setAppendOptimized( bool enable )
+{
+    if ( d->compressor.isAppendOptimized() == enable ) {
+        return;
+    }
+
+    d->compressor.setAppendOptimized( enable );
+    setDataBoundariesDirty();
+    Q_EMIT layoutChanged( this );
+    Q_EMIT propertiesChanged();
+}
+
+bool AbstractCartesianDiagram::isAppendOptimized() const
+{
+    return d->compressor.isAppendOptimized();
+}
+
 void AbstractCartesianDiagram::setRootIndex( const QModelIndex& index )
 {
     d->compressor.setRootIndex( attributesModel()->mapFromSource( index ) );
@@ -97,6 +97,25 @@ namespace KChart {
           */
         virtual QPointF referenceDiagramOffset() const;
 
+        /**
+          * Optimizes the diagram for models that grow by appending rows at the end, like
+          * live data feeds.
+          *
+          * By default, the data points falling onto one pixel are recombined whenever the
+          * number of rows changes, which costs time proportional to the number of rows.
+          * With this option set, the number of rows per pixel stays fixed until the row count
+          * has doubled, so appending a row only recalculates the last pixel. As a consequence
+          * the diagram may show up to two data points per pixel.
+          *
+          * Inserting or removing rows anywhere else than at the end is still supported, but
+          * not optimized.
+          *
+          * \sa isAppendOptimized()
+          */
+        void setAppendOptimized( bool enable );
+        /** @return option set by setAppendOptimized() */
+        bool isAppendOptimized() const;
+
         /* reimpl */
         void setModel( QAbstractItemModel* model ) override;
         /* reimpl */
@@ -50,6 +50,7 @@ public:
         referenceDiagram( nullptr ),
         referenceDiagramOffset()
         {
+            compressor.setAppendOptimized( rhs.compressor.isAppendOptimized() );
         }
 
     /** \reimpl */
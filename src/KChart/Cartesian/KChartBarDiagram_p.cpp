@@ -10,6 +10,7 @@
 
 #include "KChartDataValueAttributes.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartRenderTracer_p.h"
 
 using namespace KChart;
 
@@ -20,6 +21,7 @@ BarDiagram::Private::Private( const Private& rhs )
 
 void BarDiagram::BarDiagramType::paintBars( PaintContext* ctx, const QModelIndex& index, const QRectF& bar, qreal maxDepth )
 {
+    traceCount( "bars painted", diagram() );
     PainterSaver painterSaver( ctx->painter() );
 
     //Pending Michel: configure threeDBrush settings - shadowColor etc...
@@ -27,7 +29,9 @@ void BarDiagram::BarDiagramType::paintBars( PaintContext* ctx, const QModelIndex
     QPen indexPen( diagram()->pen( index ) );
 
     ctx->painter()->setRenderHint( QPainter::Antialiasing, diagram()->antiAliasing() );
-    ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes( index );
+    QVariant threeDBuffer;
+    const ThreeDBarAttributes& threeDAttrs =
+        m_private->attributes< ThreeDBarAttributes >( index, ThreeDBarAttributesRole, &threeDBuffer );
     if ( threeDAttrs.isEnabled() ) {
         indexBrush = threeDAttrs.threeDBrush( indexBrush, bar );
     }
@@ -35,11 +39,9 @@ void BarDiagram::BarDiagramType::paintBars( PaintContext* ctx, const QModelIndex
     ctx->painter()->setPen( PrintingParameters::scalePen( indexPen ) );
 
     if ( threeDAttrs.isEnabled() ) {
-        if ( maxDepth ) {
-            threeDAttrs.setDepth( -maxDepth );
-        }
+        const qreal depth = maxDepth ? -maxDepth : threeDAttrs.depth();
         //fixme adjust the painting to reasonable depth value
-        const qreal usedDepth = threeDAttrs.depth() * ( type() == BarDiagram::Normal ? 0.25 : 1.0 );
+        const qreal usedDepth = depth * ( type() == BarDiagram::Normal ? 0.25 : 1.0 );
 
         const QRectF isoRect = bar.translated( usedDepth, -usedDepth );
         // we need to find out if the height is negative
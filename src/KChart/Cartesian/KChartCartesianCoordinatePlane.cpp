@@ -16,6 +16,7 @@
 #include "KChartGridAttributes.h"
 #include "KChartPaintContext.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartRenderTracer_p.h"
 #include "KChartBarDiagram.h"
 #include "KChartStockDiagram.h"
 
@@ -28,6 +29,7 @@
 #include <QElapsedTimer>
 
 
+
 using namespace KChart;
 
 #define d d_func()
@@ -49,6 +51,7 @@ CartesianCoordinatePlane::Private::Private()
     , xAxisStartAtZero( true )
     , reverseVerticalPlane( false )
     , reverseHorizontalPlane( false )
+    , batchTranslation( true )
 {
 }
 
@@ -121,6 +124,8 @@ void CartesianCoordinatePlane::paint( QPainter* painter )
             }
 
             PainterSaver diagramPainterSaver( painter );
+            const DiagramTraceScope scope( diags[ i ] );
+            AbstractDiagram::Private::get( diags[ i ] )->setUpReverseMapping();
             diags[i]->paint( &ctx );
 
             if ( doDumpPaintTime ) {
@@ -448,6 +453,28 @@ const QPointF CartesianCoordinatePlane::translate( const QPointF& diagramPoint )
     return d->coordinateTransformation.translate( diagramPoint );
 }
 
+void CartesianCoordinatePlane::translatePoints( const qreal* keys, const qreal* values,
+                                                QPointF* screenPoints, int count ) const
+{
+    if ( !d->batchTranslation ) {
+        for ( int i = 0; i < count; ++i ) {
+            screenPoints[ i ] = translate( QPointF( keys[ i ], values[ i ] ) );
+        }
+        return;
+    }
+    d->coordinateTransformation.translate( keys, values, screenPoints, count );
+}
+
+void CartesianCoordinatePlane::setBatchTranslationEnabled( bool enable )
+{
+    d->batchTranslation = enable;
+}
+
+bool CartesianCoordinatePlane::isBatchTranslationEnabled() const
+{
+    return d->batchTranslation;
+}
+
 const QPointF CartesianCoordinatePlane::translateBack( const QPointF& screenPoint ) const
 {
     return d->coordinateTransformation.translateBack( screenPoint );
@@ -49,6 +49,16 @@ namespace KChart {
 
         const QPointF translate ( const QPointF& diagramPoint ) const override;
 
+        /**
+         * Translates @p count diagram points, given by their @p keys (x) and @p values (y),
+         * to screen points and writes them to @p screenPoints.
+         *
+         * The result is the same as calling translate() for each point. The
+         * transformation is only set up once for the whole batch, unless batch
+         * translation is disabled, see setBatchTranslationEnabled().
+         */
+        void translatePoints( const qreal* keys, const qreal* values, QPointF* screenPoints, int count ) const;
+
         /**
          * \sa setZoomFactorX, setZoomCenter
          */
@@ -473,6 +483,17 @@ namespace KChart {
 
         void handleFixedDataCoordinateSpaceRelation( const QRectF& geometry );
 
+        /**
+         * Sets whether translatePoints() transforms whole batches of points without
+         * calling translate(). Enabled by default.
+         *
+         * A subclass that reimplements translate() has to disable it, otherwise the
+         * line, bar, plotter and stock diagrams bypass its translate().
+         */
+        void setBatchTranslationEnabled( bool enable );
+        /** @return whether batch translation is enabled, see setBatchTranslationEnabled() */
+        bool isBatchTranslationEnabled() const;
+
         // reimplemented from QLayoutItem, via AbstractLayoutItem, AbstractArea, AbstractCoordinatePlane
         bool hasHeightForWidth() const override;
         int heightForWidth( int w ) const override;
@@ -120,6 +120,9 @@ public:
 
     bool reverseVerticalPlane;
     bool reverseHorizontalPlane;
+
+    // see setBatchTranslationEnabled()
+    bool batchTranslation;
 };
 
 
@@ -12,7 +12,9 @@
 #include <QAbstractItemModel>
 
 #include "KChartAbstractCartesianDiagram.h"
+#include "KChartAttributesModel.h"
 #include "KChartMath_p.h"
+#include "KChartRenderTracer_p.h"
 
 
 using namespace KChart;
@@ -24,7 +26,13 @@ CartesianDiagramDataCompressor::CartesianDiagramDataCompressor( QObject* parent
     , m_xResolution( 0 )
     , m_yResolution( 0 )
     , m_sampleStep( 0 )
+    , m_appendOptimized( false )
+    , m_rowsPerBucket( 1 )
+    , m_pointsPerBucket( 1 )
+    , m_stableBoundaryRows( 0 )
     , m_datasetDimension( 1 )
+    , m_hiddenGeneration( 0 )
+    , m_attributesGeneration( 0 )
 {
     calculateSampleStepWidth();
     m_data.resize( 0 );
@@ -47,6 +55,14 @@ CartesianDiagramDataCompressor::AggregatedDataValueAttributes CartesianDiagramDa
         const QModelIndex & index,
         const CachePosition& position ) const
 {
+    // setting attributes of single cells does not emit dataChanged(), so drop
+    // the cache whenever the attributes model has changed at all
+    const AttributesModel* attributesModel = diagram->attributesModel();
+    if ( attributesModel->attributesGeneration() != m_attributesGeneration ) {
+        m_attributesGeneration = attributesModel->attributesGeneration();
+        m_dataValueAttributesCache.clear();
+    }
+
     // return cached attrs, if any
     DataValueAttributesCache::const_iterator i = m_dataValueAttributesCache.constFind( position );
     if ( i != m_dataValueAttributesCache.constEnd() ) {
@@ -56,8 +72,11 @@ CartesianDiagramDataCompressor::AggregatedDataValueAttributes CartesianDiagramDa
     // aggregate attributes from all indices in the same CachePosition as index
     CartesianDiagramDataCompressor::AggregatedDataValueAttributes aggregated;
     const auto neighborIndexes = mapToModel( position );
+    QVariant buffer;
     for ( const QModelIndex& neighborIndex : neighborIndexes ) {
-        DataValueAttributes attrs = diagram->dataValueAttributes( neighborIndex );
+        // the compressor's model is the diagram's attributes model
+        const DataValueAttributes& attrs = attributesModel->attributes< DataValueAttributes >(
+                    neighborIndex, DataValueLabelAttributesRole, &buffer );
         // only store visible and unique attributes
         if ( !attrs.isVisible() ) {
             continue;
@@ -106,6 +125,10 @@ bool CartesianDiagramDataCompressor::prepareDataChange( const QModelIndex& paren
 
 void CartesianDiagramDataCompressor::slotRowsAboutToBeInserted( const QModelIndex& parent, int start, int end )
 {
+    if ( hasFixedBucketLayout() ) {
+        // handled in slotRowsInserted()
+        return;
+    }
     if ( !prepareDataChange( parent, true, &start, &end ) ) {
         return;
     }
@@ -118,6 +141,25 @@ void CartesianDiagramDataCompressor::slotRowsAboutToBeInserted( const QModelInde
 
 void CartesianDiagramDataCompressor::slotRowsInserted( const QModelIndex& parent, int start, int end )
 {
+    if ( parent == m_rootIndex && end != m_model->rowCount( m_rootIndex ) - 1 ) {
+        // appended rows are picked up by the pyramid on its own, others move its buckets
+        m_pyramid.clear();
+        m_hiddenColumns.clear();
+    } else if ( parent == m_rootIndex ) {
+        for ( int column = 0; column < m_hiddenColumns.size(); ++column ) {
+            updateHiddenColumn( column, start, end + 1 );
+        }
+    }
+    if ( hasFixedBucketLayout() ) {
+        if ( parent == m_rootIndex ) {
+            if ( m_appendOptimized && end == m_model->rowCount( m_rootIndex ) - 1 ) {
+                appendRows();
+            } else {
+                rebuildCache();
+            }
+        }
+        return;
+    }
     if ( !prepareDataChange( parent, true, &start, &end ) ) {
         return;
     }
@@ -131,6 +173,9 @@ void CartesianDiagramDataCompressor::slotRowsInserted( const QModelIndex& parent
 
 void CartesianDiagramDataCompressor::slotColumnsAboutToBeInserted( const QModelIndex& parent, int start, int end )
 {
+    if ( hasFixedBucketLayout() ) {
+        return;
+    }
     if ( !prepareDataChange( parent, false, &start, &end ) ) {
         return;
     }
@@ -141,6 +186,16 @@ void CartesianDiagramDataCompressor::slotColumnsAboutToBeInserted( const QModelI
 
 void CartesianDiagramDataCompressor::slotColumnsInserted( const QModelIndex& parent, int start, int end )
 {
+    if ( parent == m_rootIndex ) {
+        m_pyramid.clear();
+        m_hiddenColumns.clear();
+    }
+    if ( hasFixedBucketLayout() ) {
+        if ( parent == m_rootIndex ) {
+            rebuildCache();
+        }
+        return;
+    }
     if ( !prepareDataChange( parent, false, &start, &end ) ) {
         return;
     }
@@ -154,6 +209,9 @@ void CartesianDiagramDataCompressor::slotColumnsInserted( const QModelIndex& par
 
 void CartesianDiagramDataCompressor::slotRowsAboutToBeRemoved( const QModelIndex& parent, int start, int end )
 {
+    if ( hasFixedBucketLayout() ) {
+        return;
+    }
     if ( !prepareDataChange( parent, true, &start, &end ) ) {
         return;
     }
@@ -166,6 +224,12 @@ void CartesianDiagramDataCompressor::slotRowsRemoved( const QModelIndex& parent,
 {
     if ( parent != m_rootIndex )
         return;
+    m_pyramid.clear();
+    m_hiddenColumns.clear();
+    if ( hasFixedBucketLayout() ) {
+        rebuildCache();
+        return;
+    }
     Q_ASSERT( start <= end );
     Q_UNUSED( end )
 
@@ -186,6 +250,9 @@ void CartesianDiagramDataCompressor::slotRowsRemoved( const QModelIndex& parent,
 
 void CartesianDiagramDataCompressor::slotColumnsAboutToBeRemoved( const QModelIndex& parent, int start, int end )
 {
+    if ( hasFixedBucketLayout() ) {
+        return;
+    }
     if ( !prepareDataChange( parent, false, &start, &end ) ) {
         return;
     }
@@ -196,6 +263,12 @@ void CartesianDiagramDataCompressor::slotColumnsRemoved( const QModelIndex& pare
 {
     if ( parent != m_rootIndex )
         return;
+    m_pyramid.clear();
+    m_hiddenColumns.clear();
+    if ( hasFixedBucketLayout() ) {
+        rebuildCache();
+        return;
+    }
     Q_ASSERT( start <= end );
     Q_UNUSED( end );
 
@@ -217,6 +290,8 @@ void CartesianDiagramDataCompressor::slotColumnsRemoved( const QModelIndex& pare
 
 void CartesianDiagramDataCompressor::slotModelHeaderDataChanged( Qt::Orientation orientation, int first, int last )
 {
+    // the header of a dataset may hide it
+    m_hiddenColumns.clear();
     if ( orientation != Qt::Vertical )
         return;
 
@@ -237,6 +312,10 @@ void CartesianDiagramDataCompressor::slotModelDataChanged(
     Q_ASSERT( topLeftIndex.parent() == bottomRightIndex.parent() );
     Q_ASSERT( topLeftIndex.row() <= bottomRightIndex.row() );
     Q_ASSERT( topLeftIndex.column() <= bottomRightIndex.column() );
+    for ( int column = topLeftIndex.column(); column <= bottomRightIndex.column(); ++column ) {
+        m_pyramid.invalidate( column, topLeftIndex.row(), bottomRightIndex.row() + 1 );
+        updateHiddenColumn( column, topLeftIndex.row(), bottomRightIndex.row() + 1 );
+    }
     CachePosition topleft = mapToCache( topLeftIndex );
     CachePosition bottomright = mapToCache( bottomRightIndex );
     for ( int row = topleft.row; row <= bottomright.row; ++row )
@@ -246,10 +325,19 @@ void CartesianDiagramDataCompressor::slotModelDataChanged(
 
 void CartesianDiagramDataCompressor::slotModelLayoutChanged()
 {
+    m_pyramid.clear();
+    m_hiddenColumns.clear();
     rebuildCache();
     calculateSampleStepWidth();
 }
 
+void CartesianDiagramDataCompressor::slotModelReset()
+{
+    m_pyramid.clear();
+    m_hiddenColumns.clear();
+    rebuildCache();
+}
+
 void CartesianDiagramDataCompressor::slotDiagramLayoutChanged( AbstractDiagram* diagramBase )
 {
     AbstractCartesianDiagram* diagram = qobject_cast< AbstractCartesianDiagram* >( diagramBase );
@@ -313,11 +401,13 @@ void CartesianDiagramDataCompressor::setModel( QAbstractItemModel* model )
         disconnect( m_model, SIGNAL(columnsAboutToBeRemoved(QModelIndex,int,int)),
                  this, SLOT(slotColumnsAboutToBeRemoved(QModelIndex,int,int)) );
         disconnect( m_model, SIGNAL(modelReset()),
-                    this, SLOT(rebuildCache()) );
+                    this, SLOT(slotModelReset()) );
         m_model = nullptr;
     }
 
     m_modelCache.setModel( model );
+    m_pyramid.clear();
+    m_hiddenColumns.clear();
 
     if ( model != nullptr ) {
         m_model = model;
@@ -343,7 +433,7 @@ void CartesianDiagramDataCompressor::setModel( QAbstractItemModel* model )
                  SLOT(slotColumnsRemoved(QModelIndex,int,int)) );
         connect( m_model, SIGNAL(columnsAboutToBeRemoved(QModelIndex,int,int)),
                  SLOT(slotColumnsAboutToBeRemoved(QModelIndex,int,int)) );
-        connect( m_model, SIGNAL(modelReset()), SLOT(rebuildCache()) );
+        connect( m_model, SIGNAL(modelReset()), SLOT(slotModelReset()) );
     }
     rebuildCache();
     calculateSampleStepWidth();
@@ -355,6 +445,8 @@ void CartesianDiagramDataCompressor::setRootIndex( const QModelIndex& root )
         Q_ASSERT( root.model() == m_model || !root.isValid() );
         m_rootIndex = root;
         m_modelCache.setRootIndex( root );
+        m_pyramid.clear();
+        m_hiddenColumns.clear();
         rebuildCache();
         calculateSampleStepWidth();
     }
@@ -368,6 +460,12 @@ void CartesianDiagramDataCompressor::recalcResolution()
 void CartesianDiagramDataCompressor::setResolution( int x, int y )
 {
     if ( setResolutionInternal( x, y ) ) {
+        if ( m_appendOptimized && m_datasetDimension != 1 && !m_data.isEmpty() &&
+             m_data.first().size() == m_xResolution ) {
+            // the X resolution of multi-dimensional datasets is the row count,
+            // and appendRows() has already grown the cache accordingly
+            return;
+        }
         rebuildCache();
         calculateSampleStepWidth();
     }
@@ -393,25 +491,74 @@ void CartesianDiagramDataCompressor::clearCache()
 {
     for ( int column = 0; column < m_data.size(); ++column )
         m_data[column].fill( DataPoint() );
+    m_stableBoundaryRows = 0;
 }
 
 void CartesianDiagramDataCompressor::rebuildCache()
 {
     Q_ASSERT( m_datasetDimension != 0 );
+    const TraceScope scope( "compression" );
 
     m_data.clear();
     setResolutionInternal( m_xResolution, m_yResolution );
     const int columnDivisor = m_datasetDimension == 2 ? 2 : 1;
     const int columnCount = m_model ? m_model->columnCount( m_rootIndex ) / columnDivisor : 0;
-    const int rowCount = qMin( m_model ? m_model->rowCount( m_rootIndex ) : 0, m_xResolution );
+    const int modelRowCount = m_model ? m_model->rowCount( m_rootIndex ) : 0;
+    const int capacity = cacheCapacity();
+    // MinMax keeps up to four data points per pixel, but only decimates if there are more rows than that
+    m_pointsPerBucket = m_mode == MinMax && m_datasetDimension == 1 && modelRowCount > capacity ? MinMaxBucketSize : 1;
+    m_rowsPerBucket = 1;
+    int rowCount = qMin( modelRowCount, capacity );
+    if ( m_appendOptimized && capacity > 0 ) {
+        // a fixed number of rows per pixel, so that appended rows only touch the last pixel(s)
+        if ( modelRowCount > capacity ) {
+            m_rowsPerBucket = ( modelRowCount + m_xResolution - 1 ) / m_xResolution;
+        }
+        rowCount = ( ( modelRowCount + m_rowsPerBucket - 1 ) / m_rowsPerBucket ) * m_pointsPerBucket;
+    }
     m_data.resize( columnCount );
     for ( int i = 0; i < columnCount; ++i ) {
         m_data[i].resize( rowCount );
     }
+    m_stableBoundaryRows = 0;
     // also empty the attrs cache
     m_dataValueAttributesCache.clear();
 }
 
+void CartesianDiagramDataCompressor::appendRows()
+{
+    Q_ASSERT( m_appendOptimized );
+    const int modelRowCount = m_model->rowCount( m_rootIndex );
+    const int capacity = cacheCapacity();
+    const int rowCount = ( ( modelRowCount + m_rowsPerBucket - 1 ) / m_rowsPerBucket ) * m_pointsPerBucket;
+    if ( m_data.isEmpty() || capacity <= 0 || rowCount > 2 * capacity ) {
+        // Start over with about twice as many rows per pixel. As this only happens each time the
+        // row count has doubled, appending a row is O(1) amortized.
+        rebuildCache();
+        return;
+    }
+
+    const int oldRowCount = m_data.first().size();
+    for ( int column = 0; column < m_data.size(); ++column ) {
+        // the formerly last pixel may not have been complete
+        if ( oldRowCount > 0 ) {
+            invalidate( CachePosition( oldRowCount - 1, column ) );
+        }
+        m_data[ column ].resize( rowCount );
+    }
+}
+
+int CartesianDiagramDataCompressor::cacheCapacity() const
+{
+    const bool minMax = m_mode == MinMax && m_datasetDimension == 1;
+    return m_xResolution * ( minMax ? MinMaxBucketSize : 1 );
+}
+
+bool CartesianDiagramDataCompressor::hasFixedBucketLayout() const
+{
+    return m_mode == MinMax || m_appendOptimized;
+}
+
 const CartesianDiagramDataCompressor::DataPoint& CartesianDiagramDataCompressor::data( const CachePosition& position ) const
 {
     static DataPoint nullDataPoint;
@@ -424,87 +571,164 @@ const CartesianDiagramDataCompressor::DataPoint& CartesianDiagramDataCompressor:
     return m_data.at( position.column ).at( position.row );
 }
 
+static void extendBoundaries( QPair< QPointF, QPointF >* boundaries, qreal x, qreal y )
+{
+    if ( ISNAN( x ) || ISNAN( y ) ) {
+        return;
+    }
+
+    if ( ISNAN( boundaries->first.x() ) ) {
+        boundaries->first = QPointF( x, y );
+        boundaries->second = QPointF( x, y );
+    } else {
+        boundaries->first = QPointF( qMin( boundaries->first.x(), x ), qMin( boundaries->first.y(), y ) );
+        boundaries->second = QPointF( qMax( boundaries->second.x(), x ), qMax( boundaries->second.y(), y ) );
+    }
+}
+
 QPair< QPointF, QPointF > CartesianDiagramDataCompressor::dataBoundaries() const
 {
     const int colCount = modelDataColumns();
-    qreal xMin = std::numeric_limits< qreal >::quiet_NaN();
-    qreal xMax = std::numeric_limits< qreal >::quiet_NaN();
-    qreal yMin = std::numeric_limits< qreal >::quiet_NaN();
-    qreal yMax = std::numeric_limits< qreal >::quiet_NaN();
+    const qreal nan = std::numeric_limits< qreal >::quiet_NaN();
+    const QPair< QPointF, QPointF > noBoundaries( QPointF( nan, nan ), QPointF( nan, nan ) );
+
+    if ( isMinMaxDecimating() && usesPyramid() ) {
+        // MinMax keeps the extrema and the first and last row, so unless values are
+        // missing, the boundaries are those of the raw data
+        const int rowCount = m_modelCache.rowCount();
+        QPair< QPointF, QPointF > boundaries = noBoundaries;
+        bool complete = true;
+        for ( int column = 0; column < colCount && complete; ++column ) {
+            const qreal* values = pyramidColumnData( column );
+            const CartesianDiagramDataPyramid::Bucket all = m_pyramid.aggregate( column, values, 0, rowCount );
+            complete = all.count == rowCount;
+            extendBoundaries( &boundaries, 0, all.min );
+            extendBoundaries( &boundaries, rowCount - 1, all.max );
+        }
+        if ( complete ) {
+            return boundaries;
+        }
+    }
+
+    // With appendOptimized, only the last pixel changes when rows are appended, so the
+    // boundaries of all the others are kept until one of them gets invalidated.
+    const int stableRows = m_appendOptimized && colCount > 0 ? qMax( 0, m_data.first().size() - m_pointsPerBucket ) : 0;
+    if ( m_stableBoundaryRows > stableRows ) {
+        m_stableBoundaryRows = 0;
+    }
+    QPair< QPointF, QPointF > stable = m_stableBoundaryRows > 0 ? m_stableBoundaries : noBoundaries;
+    QPair< QPointF, QPointF > tail = noBoundaries;
 
     for ( int column = 0; column < colCount; ++column )
     {
         const DataPointVector& data = m_data.at( column );
-        int row = 0;
-        for ( DataPointVector::const_iterator it = data.begin(); it != data.end(); ++it, ++row )
+        for ( int row = m_stableBoundaryRows; row < data.size(); ++row )
         {
-            const DataPoint& p = *it;
+            const DataPoint& p = data.at( row );
             if ( !p.index.isValid() )
                 retrieveModelData( CachePosition( row, column ) );
 
-            if ( ISNAN( p.key ) || ISNAN( p.value ) ) {
-                continue;
-            }
-
-            if ( ISNAN( xMin ) ) {
-                xMin = p.key;
-                xMax = p.key;
-                yMin = p.value;
-                yMax = p.value;
-            } else {
-                xMin = qMin( xMin, p.key );
-                xMax = qMax( xMax, p.key );
-                yMin = qMin( yMin, p.value );
-                yMax = qMax( yMax, p.value );
-            }
+            extendBoundaries( row < stableRows ? &stable : &tail, p.key, p.value );
         }
     }
 
-    const QPointF bottomLeft( xMin, yMin );
-    const QPointF topRight( xMax, yMax );
-    return qMakePair( bottomLeft, topRight );
+    m_stableBoundaries = stable;
+    m_stableBoundaryRows = stableRows;
+
+    QPair< QPointF, QPointF > boundaries = stable;
+    extendBoundaries( &boundaries, tail.first.x(), tail.first.y() );
+    extendBoundaries( &boundaries, tail.second.x(), tail.second.y() );
+    return boundaries;
+}
+
+qreal CartesianDiagramDataCompressor::alignedValue( const CachePosition& position, int column ) const
+{
+    if ( !isMinMaxDecimating() || m_datasetDimension != 1 ) {
+        // the cache rows of all columns stand for the same model rows
+        return data( CachePosition( position.row, column ) ).value;
+    }
+    // the slots of a MinMax pixel hold different rows in each column
+    const QModelIndex index = data( position ).index;
+    if ( !index.isValid() || column < 0 || column >= modelDataColumns() ) {
+        return std::numeric_limits< qreal >::quiet_NaN();
+    }
+    const int row = index.row();
+    return m_modelCache.columnData( column, row, row + 1 )[ row ];
+}
+
+void CartesianDiagramDataCompressor::cacheRowRange( qreal firstKey, qreal lastKey, int* firstRow, int* endRow ) const
+{
+    const int rows = modelDataRows();
+    const int modelRowCount = m_model ? m_model->rowCount( m_rootIndex ) : 0;
+    *firstRow = 0;
+    *endRow = rows;
+    // the keys of multi-dimensional datasets come from the model, not from the row numbers
+    if ( m_datasetDimension != 1 || rows == 0 || modelRowCount == 0 || ISNAN( firstKey ) || ISNAN( lastKey ) ) {
+        return;
+    }
+    const int first = int( qBound( qreal( 0 ), floor( firstKey ), qreal( modelRowCount - 1 ) ) );
+    const int last = int( qBound( qreal( 0 ), ceil( lastKey ), qreal( modelRowCount - 1 ) ) );
+    *firstRow = qMax( 0, ( bucketOfRow( first ) - 1 ) * m_pointsPerBucket );
+    *endRow = qMin( rows, ( bucketOfRow( last ) + 2 ) * m_pointsPerBucket );
 }
 
 void CartesianDiagramDataCompressor::retrieveModelData( const CachePosition& position ) const
 {
     Q_ASSERT( mapsToModelIndex( position ) );
+    if ( isMinMaxDecimating() ) {
+        retrieveMinMaxBucket( position );
+        return;
+    }
+
     DataPoint result;
     result.hidden = true;
 
     switch ( m_mode ) {
     case Precise:
+    case MinMax: // without decimation, every pixel holds exactly one row
     {
-        const QModelIndexList indexes = mapToModel( position );
-
         if ( m_datasetDimension == 2 ) {
-            Q_ASSERT( indexes.count() == 2 );
-            const QModelIndex& xIndex = indexes.at( 0 );
-            result.index = xIndex;
-            result.key = m_modelCache.data( xIndex );
-            result.value = m_modelCache.data( indexes.at( 1 ) );
+            const int row = position.row;
+            const int xColumn = position.column * 2;
+            if ( row >= m_modelCache.rowCount() ) {
+                break;
+            }
+            result.index = m_model->index( row, xColumn, m_rootIndex ); // checked
+            result.key = m_modelCache.columnData( xColumn, row, row + 1 )[ row ];
+            result.value = m_modelCache.columnData( xColumn + 1, row, row + 1 )[ row ];
+            result.hidden = isHidden( xColumn, row, row + 1 ) && isHidden( xColumn + 1, row, row + 1 );
         } else {
-            if ( indexes.isEmpty() ) {
+            // read the rows belonging to this pixel straight from the column buffer
+            const int baseRow = bucketStartRow( position.row );
+            // the following line needs to work for the last row(s), too...
+            const int endRow = qMin( bucketStartRow( position.row + 1 ), m_modelCache.rowCount() );
+            if ( baseRow >= endRow ) {
                 break;
             }
-            result.value = std::numeric_limits< qreal >::quiet_NaN();
-            result.key = 0.0;
-            for ( const QModelIndex& index : indexes ) {
-                const qreal value = m_modelCache.data( index );
-                if ( !ISNAN( value ) ) {
-                    result.value = ISNAN( result.value ) ? value : result.value + value;
+            const int count = endRow - baseRow;
+            if ( count >= PyramidMinimumRows ) {
+                const qreal* values = pyramidColumnData( position.column );
+                const CartesianDiagramDataPyramid::Bucket bucket
+                    = m_pyramid.aggregate( position.column, values, baseRow, endRow );
+                result.value = bucket.count > 0 ? bucket.sum : std::numeric_limits< qreal >::quiet_NaN();
+                // the sum of baseRow, ..., endRow - 1
+                result.key = ( baseRow + endRow - 1 ) * qreal( count ) / 2;
+            } else {
+                const qreal* values = m_modelCache.columnData( position.column, baseRow, endRow );
+                result.value = std::numeric_limits< qreal >::quiet_NaN();
+                result.key = 0.0;
+                for ( int row = baseRow; row < endRow; ++row ) {
+                    const qreal value = values[ row ];
+                    if ( !ISNAN( value ) ) {
+                        result.value = ISNAN( result.value ) ? value : result.value + value;
+                    }
+                    result.key += row;
                 }
-                result.key += index.row();
-            }
-            result.index = indexes.at( 0 );
-            result.key /= indexes.size();
-            result.value /= indexes.size();
-        }
-
-        for ( const QModelIndex& index : indexes ) {
-            // the DataPoint point is visible if any of the underlying, aggregated points is visible
-            if ( m_model->data( index, DataHiddenRole ).value<bool>() == false ) {
-                result.hidden = false;
             }
+            result.index = m_model->index( baseRow, position.column, m_rootIndex ); // checked
+            result.key /= count;
+            result.value /= count;
+            result.hidden = isHidden( position.column, baseRow, endRow );
         }
         break;
     }
@@ -516,6 +740,85 @@ void CartesianDiagramDataCompressor::retrieveModelData( const CachePosition& pos
     Q_ASSERT( isCached( position ) );
 }
 
+bool CartesianDiagramDataCompressor::isMinMaxDecimating() const
+{
+    return m_pointsPerBucket == MinMaxBucketSize;
+}
+
+int CartesianDiagramDataCompressor::bucketStartRow( int bucket ) const
+{
+    if ( m_appendOptimized ) {
+        return bucket * m_rowsPerBucket;
+    }
+    if ( isMinMaxDecimating() ) {
+        const qint64 rowCount = m_model->rowCount( m_rootIndex );
+        const qint64 bucketCount = m_data.at( 0 ).size() / MinMaxBucketSize;
+        // the smallest row that bucketOfRow() puts into the bucket
+        return int( ( bucket * rowCount + bucketCount - 1 ) / bucketCount );
+    }
+    return floor( bucket * indexesPerPixel() );
+}
+
+int CartesianDiagramDataCompressor::bucketOfRow( int row ) const
+{
+    if ( m_appendOptimized ) {
+        return row / m_rowsPerBucket;
+    }
+    if ( isMinMaxDecimating() ) {
+        const qint64 bucketCount = m_data.at( 0 ).size() / MinMaxBucketSize;
+        return int( row * bucketCount / m_model->rowCount( m_rootIndex ) );
+    }
+    return int( row / indexesPerPixel() );
+}
+
+void CartesianDiagramDataCompressor::retrieveMinMaxBucket( const CachePosition& position ) const
+{
+    const int bucket = position.row / MinMaxBucketSize;
+    const int baseRow = bucketStartRow( bucket );
+    const int endRow = qMin( bucketStartRow( bucket + 1 ), m_modelCache.rowCount() );
+    Q_ASSERT( baseRow < endRow );
+
+    const qreal* values;
+    int minRow = -1;
+    int maxRow = -1;
+    if ( endRow - baseRow >= PyramidMinimumRows ) {
+        values = pyramidColumnData( position.column );
+        minRow = m_pyramid.minimumRow( position.column, values, baseRow, endRow );
+        maxRow = m_pyramid.maximumRow( position.column, values, baseRow, endRow );
+    } else {
+        values = m_modelCache.columnData( position.column, baseRow, endRow );
+        for ( int row = baseRow; row < endRow; ++row ) {
+            const qreal value = values[ row ];
+            if ( ISNAN( value ) ) {
+                continue;
+            }
+            if ( minRow == -1 || value < values[ minRow ] ) {
+                minRow = row;
+            }
+            if ( maxRow == -1 || value > values[ maxRow ] ) {
+                maxRow = row;
+            }
+        }
+    }
+    if ( minRow == -1 ) {
+        minRow = maxRow = baseRow;
+    }
+
+    // first, extrema in the order they occur, last - so the line keeps its shape
+    const int rows[ MinMaxBucketSize ] = { baseRow, qMin( minRow, maxRow ), qMax( minRow, maxRow ), endRow - 1 };
+    DataPointVector& data = m_data[ position.column ];
+    for ( int slot = 0; slot < MinMaxBucketSize; ++slot ) {
+        const int row = rows[ slot ];
+        DataPoint& point = data[ bucket * MinMaxBucketSize + slot ];
+        point.index = m_model->index( row, position.column, m_rootIndex ); // checked
+        point.key = row;
+        point.value = values[ row ];
+        // a row that is already represented by the previous slot is hidden, so it is painted only once
+        point.hidden = ( slot > 0 && row == rows[ slot - 1 ] ) || isHidden( position.column, row, row + 1 );
+    }
+    Q_ASSERT( isCached( position ) );
+}
+
 CartesianDiagramDataCompressor::CachePosition CartesianDiagramDataCompressor::mapToCache(
         const QModelIndex& index ) const
 {
@@ -540,7 +843,7 @@ CartesianDiagramDataCompressor::CachePosition CartesianDiagramDataCompressor::ma
     if ( indexesPerPixel() == 0 ) {
         return mapToCache( QModelIndex() );
     }
-    return CachePosition( int( row / indexesPerPixel() ), column / m_datasetDimension );
+    return CachePosition( bucketOfRow( row ) * m_pointsPerBucket, column / m_datasetDimension );
 }
 
 QModelIndexList CartesianDiagramDataCompressor::mapToModel( const CachePosition& position ) const
@@ -551,16 +854,21 @@ QModelIndexList CartesianDiagramDataCompressor::mapToModel( const CachePosition&
     }
 
     Q_ASSERT( position.column < modelDataColumns() );
-    if ( m_datasetDimension == 2 ) {
+    if ( isMinMaxDecimating() ) {
+        // every cache row stands for exactly one model row
+        const DataPoint& point = data( position );
+        if ( point.index.isValid() ) {
+            indexes << point.index;
+        }
+    } else if ( m_datasetDimension == 2 ) {
         indexes << m_model->index( position.row, position.column * 2, m_rootIndex ); // checked
         indexes << m_model->index( position.row, position.column * 2 + 1, m_rootIndex ); // checked
     } else {
         // here, indexes per column is usually but not always 1 (e.g. stock diagrams can have three
         // or four dimensions: High-Low-Close or Open-High-Low-Close)
-        const qreal ipp = indexesPerPixel();
-        const int baseRow = floor( position.row * ipp );
+        const int baseRow = bucketStartRow( position.row );
         // the following line needs to work for the last row(s), too...
-        const int endRow = floor( ( position.row + 1 ) * ipp );
+        const int endRow = qMin( bucketStartRow( position.row + 1 ), m_model->rowCount( m_rootIndex ) );
         for ( int row = baseRow; row < endRow; ++row ) {
             Q_ASSERT( row < m_model->rowCount( m_rootIndex ) );
             const QModelIndex index = m_model->index( row, position.column, m_rootIndex );
@@ -589,6 +897,18 @@ bool CartesianDiagramDataCompressor::mapsToModelIndex( const CachePosition& posi
 
 void CartesianDiagramDataCompressor::invalidate( const CachePosition& position )
 {
+    if ( position.row < m_stableBoundaryRows ) {
+        m_stableBoundaryRows = 0;
+    }
+    if ( isMinMaxDecimating() && mapsToModelIndex( position ) ) {
+        // any row may be the new minimum or maximum, forget the whole pixel
+        const int firstRow = position.row - position.row % MinMaxBucketSize;
+        for ( int row = firstRow; row < firstRow + MinMaxBucketSize; ++row ) {
+            m_data[ position.column ][ row ] = DataPoint();
+            m_dataValueAttributesCache.remove( CachePosition( row, position.column ) );
+        }
+        return;
+    }
     if ( mapsToModelIndex( position ) ) {
         m_data[ position.column ][ position.row ] = DataPoint();
         // Also invalidate the data value attributes at "position".
@@ -598,6 +918,82 @@ void CartesianDiagramDataCompressor::invalidate( const CachePosition& position )
     }
 }
 
+bool CartesianDiagramDataCompressor::usesPyramid() const
+{
+    if ( !m_model || m_datasetDimension != 1 || m_mode == SamplingSeven || m_data.isEmpty() ) {
+        return false;
+    }
+    const qint64 buckets = m_data.first().size() / m_pointsPerBucket;
+    return buckets > 0 && m_model->rowCount( m_rootIndex ) >= buckets * PyramidMinimumRows;
+}
+
+const qreal* CartesianDiagramDataCompressor::pyramidColumnData( int column ) const
+{
+    const int rowCount = m_modelCache.rowCount();
+    int firstRow;
+    int endRow;
+    m_pyramid.pendingRows( column, rowCount, &firstRow, &endRow );
+    // all other rows have been read before and are still valid in the model cache
+    const qreal* values = m_modelCache.columnData( column, firstRow, endRow );
+    m_pyramid.update( column, values, rowCount );
+    return values;
+}
+
+bool CartesianDiagramDataCompressor::isHidden( int column, int firstRow, int endRow ) const
+{
+    if ( !mayContainHiddenData( column ) ) {
+        return firstRow >= endRow;
+    }
+    for ( int row = firstRow; row < endRow; ++row ) {
+        // the DataPoint is visible if any of the underlying, aggregated points is visible
+        if ( m_model->data( m_model->index( row, column, m_rootIndex ), DataHiddenRole ).value<bool>() == false ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CartesianDiagramDataCompressor::mayContainHiddenData( int column ) const
+{
+    const BulkNumericSource* bulkSource = m_modelCache.bulkSource();
+    if ( bulkSource != nullptr ) {
+        const QModelIndex sourceRoot = ModelDataCachePrivate::mapToBulkNumericSource( m_model, m_rootIndex );
+        if ( !bulkSource->mayContainHiddenData( column, sourceRoot ) ) {
+            return false;
+        }
+    }
+
+    const AttributesModel* attributesModel = qobject_cast< const AttributesModel* >( m_model.data() );
+    if ( attributesModel && attributesModel->attributesGeneration() != m_hiddenGeneration ) {
+        m_hiddenGeneration = attributesModel->attributesGeneration();
+        m_hiddenColumns.clear();
+    }
+    if ( column < 0 || column >= m_model->columnCount( m_rootIndex ) ) {
+        return true;
+    }
+    if ( column >= m_hiddenColumns.size() ) {
+        m_hiddenColumns.resize( m_model->columnCount( m_rootIndex ) );
+    }
+    if ( m_hiddenColumns.at( column ) == HiddenUnknown ) {
+        m_hiddenColumns[ column ] = NoneHidden;
+        updateHiddenColumn( column, 0, m_model->rowCount( m_rootIndex ) );
+    }
+    return m_hiddenColumns.at( column ) == SomeHidden;
+}
+
+void CartesianDiagramDataCompressor::updateHiddenColumn( int column, int firstRow, int endRow ) const
+{
+    if ( column < 0 || column >= m_hiddenColumns.size() || m_hiddenColumns.at( column ) != NoneHidden ) {
+        return;
+    }
+    for ( int row = firstRow; row < endRow; ++row ) {
+        if ( m_model->data( m_model->index( row, column, m_rootIndex ), DataHiddenRole ).value<bool>() ) {
+            m_hiddenColumns[ column ] = SomeHidden;
+            return;
+        }
+    }
+}
+
 bool CartesianDiagramDataCompressor::isCached( const CachePosition& position ) const
 {
     Q_ASSERT( mapsToModelIndex( position ) );
@@ -607,7 +1003,7 @@ bool CartesianDiagramDataCompressor::isCached( const CachePosition& position ) c
 
 void CartesianDiagramDataCompressor::calculateSampleStepWidth()
 {
-    if ( m_mode == Precise ) {
+    if ( m_mode == Precise || m_mode == MinMax ) {
         m_sampleStep = 1;
         return;
     }
@@ -640,6 +1036,34 @@ void CartesianDiagramDataCompressor::calculateSampleStepWidth()
     }
 }
 
+void CartesianDiagramDataCompressor::setApproximationMode( ApproximationMode mode )
+{
+    if ( mode != m_mode ) {
+        m_mode = mode;
+        rebuildCache();
+        calculateSampleStepWidth();
+    }
+}
+
+CartesianDiagramDataCompressor::ApproximationMode CartesianDiagramDataCompressor::approximationMode() const
+{
+    return m_mode;
+}
+
+void CartesianDiagramDataCompressor::setAppendOptimized( bool enable )
+{
+    if ( enable != m_appendOptimized ) {
+        m_appendOptimized = enable;
+        rebuildCache();
+        calculateSampleStepWidth();
+    }
+}
+
+bool CartesianDiagramDataCompressor::isAppendOptimized() const
+{
+    return m_appendOptimized;
+}
+
 void CartesianDiagramDataCompressor::setDatasetDimension( int dimension )
 {
     if ( dimension != m_datasetDimension ) {
@@ -30,6 +30,7 @@
 
 #include "KChartDataValueAttributes.h"
 #include "KChartModelDataCache_p.h"
+#include "KChartCartesianDiagramDataPyramid_p.h"
 
 #include "kchart_export.h"
 
@@ -111,7 +112,10 @@ namespace KChart {
             // datapoints for a pixel
             Precise,
             // approximate by averaging out over prime number distances
-            SamplingSeven
+            SamplingSeven,
+            // keep the first, minimum, maximum and last datapoint of
+            // every pixel (M4), so spikes survive the compression
+            MinMax
         };
 
         explicit CartesianDiagramDataCompressor( QObject* parent = nullptr );
@@ -122,6 +126,11 @@ namespace KChart {
         void setResolution( int x, int y );
         void recalcResolution();
         void setApproximationMode( ApproximationMode mode );
+        ApproximationMode approximationMode() const;
+        // keep the number of model rows per pixel fixed, so that rows appended
+        // at the end of the model only affect the last pixel(s)
+        void setAppendOptimized( bool enable );
+        bool isAppendOptimized() const;
         void setDatasetDimension( int dimension );
 
         // output: resulting model resolution, data points
@@ -129,8 +138,14 @@ namespace KChart {
         int modelDataColumns() const;
         int modelDataRows() const;
         const DataPoint& data( const CachePosition& ) const;
+        // the value of the dataset column for the model rows that the data point at
+        // position stands for, e.g. the lower bound of an area painted below the point
+        qreal alignedValue( const CachePosition& position, int column ) const;
 
         QPair< QPointF, QPointF > dataBoundaries() const;
+        // cache rows [*firstRow, *endRow) needed to paint the keys in [firstKey, lastKey],
+        // including one pixel on either side to connect lines leaving the range
+        void cacheRowRange( qreal firstKey, qreal lastKey, int* firstRow, int* endRow ) const;
 
         AggregatedDataValueAttributes aggregatedAttrs(
                 const AbstractDiagram* diagram,
@@ -156,6 +171,7 @@ namespace KChart {
         void slotModelHeaderDataChanged( Qt::Orientation, int, int );
         void slotModelDataChanged( const QModelIndex&, const QModelIndex& );
         void slotModelLayoutChanged();
+        void slotModelReset();
 
         // geometry has changed
         void rebuildCache();
@@ -183,12 +199,42 @@ namespace KChart {
 
         // retrieve data from the model, put it into the cache
         void retrieveModelData( const CachePosition& ) const;
+        // true if MinMax mode actually reduces the data, with one group of
+        // MinMaxBucketSize cache rows per pixel
+        bool isMinMaxDecimating() const;
+        // first model row of the given pixel bucket, a bucket being a group of
+        // m_pointsPerBucket cache rows
+        int bucketStartRow( int bucket ) const;
+        // pixel bucket containing the model row
+        int bucketOfRow( int row ) const;
+        // number of cache rows that the current resolution calls for
+        int cacheCapacity() const;
+        // true if row and column changes don't map to cache rows one by one
+        bool hasFixedBucketLayout() const;
+        // grow the cache for rows appended to the model
+        void appendRows();
+        // fills all cache rows of the MinMax pixel bucket containing the position
+        void retrieveMinMaxBucket( const CachePosition& ) const;
+        // true if pixels aggregate enough rows to be computed from the pyramid
+        bool usesPyramid() const;
+        // brings the pyramid of the column up to date, returns the column's values
+        const qreal* pyramidColumnData( int column ) const;
+        // check if all model rows in [firstRow, endRow) of column are hidden
+        bool isHidden( int column, int firstRow, int endRow ) const;
+        // false if no row of the column is hidden, looks at all rows only once
+        bool mayContainHiddenData( int column ) const;
+        // notes hidden rows among rows that changed in a column known to have none
+        void updateHiddenColumn( int column, int firstRow, int endRow ) const;
         // check if a data point is in the cache:
         bool isCached( const CachePosition& ) const;
         // set sample step width according to settings:
         void calculateSampleStepWidth();
 
 
+        static const int MinMaxBucketSize = 4;
+        // below that many rows per pixel, reading the rows directly is cheaper
+        static const int PyramidMinimumRows = 4 * CartesianDiagramDataPyramid::BaseBucketSize;
+
         QPointer<QAbstractItemModel> m_model;
         QModelIndex m_rootIndex;
 
@@ -197,10 +243,25 @@ namespace KChart {
         int m_yResolution;
         unsigned int m_sampleStep;
 
+        bool m_appendOptimized;
+        int m_rowsPerBucket; // only used if m_appendOptimized
+        int m_pointsPerBucket;
+        mutable QPair< QPointF, QPointF > m_stableBoundaries;
+        mutable int m_stableBoundaryRows;
+
         mutable QVector<DataPointVector> m_data; // one per dataset
         ModelDataCache< qreal, Qt::DisplayRole > m_modelCache;
+        // kept across resolution changes, so that zooming does not need to read every row again
+        mutable CartesianDiagramDataPyramid m_pyramid;
+        // per column, whether any row is hidden - cleared with the pyramid, on header
+        // changes and whenever the attributes change, since setting them does not emit dataChanged()
+        enum HiddenState { HiddenUnknown, NoneHidden, SomeHidden };
+        mutable QVector< char > m_hiddenColumns;
+        mutable quint64 m_hiddenGeneration;
         mutable DataValueAttributesCache m_dataValueAttributesCache;
         int m_datasetDimension;
+        // AttributesModel::attributesGeneration() m_dataValueAttributesCache was filled at
+        mutable quint64 m_attributesGeneration;
     };
 }
 
@@ -0,0 +1,265 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KChartCartesianDiagramDataPyramid_p.h"
+
+#include "KChartMath_p.h"
+
+
+using namespace KChart;
+
+void CartesianDiagramDataPyramid::Bucket::add( qreal value )
+{
+    if ( ISNAN( value ) ) {
+        return;
+    }
+    min = qMin( min, value );
+    max = qMax( max, value );
+    sum += value;
+    ++count;
+}
+
+void CartesianDiagramDataPyramid::Bucket::add( const Bucket& other )
+{
+    min = qMin( min, other.min );
+    max = qMax( max, other.max );
+    sum += other.sum;
+    count += other.count;
+}
+
+void CartesianDiagramDataPyramid::clear()
+{
+    m_columns.clear();
+}
+
+void CartesianDiagramDataPyramid::invalidate( int column, int firstRow, int endRow )
+{
+    if ( column >= m_columns.size() || m_columns.at( column ).rowCount < 0 || firstRow >= endRow ) {
+        return;
+    }
+    Column& c = m_columns[ column ];
+    if ( c.dirtyFirstRow < c.dirtyEndRow ) {
+        c.dirtyFirstRow = qMin( c.dirtyFirstRow, firstRow );
+        c.dirtyEndRow = qMax( c.dirtyEndRow, endRow );
+    } else {
+        c.dirtyFirstRow = firstRow;
+        c.dirtyEndRow = endRow;
+    }
+}
+
+void CartesianDiagramDataPyramid::pendingRows( int column, int rowCount, int* firstRow, int* endRow ) const
+{
+    if ( column >= m_columns.size() || m_columns.at( column ).rowCount < 0 ||
+         rowCount < m_columns.at( column ).rowCount ) {
+        // not built yet, or rows have been removed: start over
+        *firstRow = 0;
+        *endRow = rowCount;
+        return;
+    }
+
+    const Column& c = m_columns.at( column );
+    int first = rowCount;
+    int end = 0;
+    if ( c.dirtyFirstRow < c.dirtyEndRow ) {
+        first = c.dirtyFirstRow;
+        end = c.dirtyEndRow;
+    }
+    if ( rowCount > c.rowCount ) {
+        // appended rows
+        first = qMin( first, c.rowCount );
+        end = rowCount;
+    }
+    end = qMin( end, rowCount );
+    if ( first >= end ) {
+        first = end = 0;
+    }
+    *firstRow = first;
+    *endRow = end;
+}
+
+void CartesianDiagramDataPyramid::update( int column, const qreal* values, int rowCount )
+{
+    int firstRow;
+    int endRow;
+    pendingRows( column, rowCount, &firstRow, &endRow );
+
+    if ( column >= m_columns.size() ) {
+        m_columns.resize( column + 1 );
+    }
+    Column& c = m_columns[ column ];
+    if ( c.rowCount < 0 || rowCount < c.rowCount ) {
+        c.levels.clear();
+    }
+    c.rowCount = rowCount;
+    c.dirtyFirstRow = 0;
+    c.dirtyEndRow = 0;
+    if ( firstRow >= endRow ) {
+        return;
+    }
+
+    // make room for appended rows, and for the levels they add on top
+    int size = ( rowCount + BaseBucketSize - 1 ) / BaseBucketSize;
+    int levelCount = 0;
+    for ( ;; ) {
+        if ( levelCount == c.levels.size() ) {
+            c.levels.append( QVector< Bucket >() );
+        }
+        c.levels[ levelCount ].resize( size );
+        ++levelCount;
+        if ( size <= 1 ) {
+            break;
+        }
+        size = ( size + 1 ) / 2;
+    }
+    c.levels.resize( levelCount );
+
+    int first = firstRow / BaseBucketSize;
+    int end = ( endRow + BaseBucketSize - 1 ) / BaseBucketSize;
+    QVector< Bucket >& base = c.levels[ 0 ];
+    for ( int i = first; i < end; ++i ) {
+        Bucket bucket;
+        const int bucketEndRow = qMin( ( i + 1 ) * BaseBucketSize, rowCount );
+        for ( int row = i * BaseBucketSize; row < bucketEndRow; ++row ) {
+            bucket.add( values[ row ] );
+        }
+        base[ i ] = bucket;
+    }
+
+    // propagate the changes up to the top
+    for ( int level = 1; level < c.levels.size(); ++level ) {
+        first /= 2;
+        end = ( end + 1 ) / 2;
+        const QVector< Bucket >& children = c.levels.at( level - 1 );
+        QVector< Bucket >& buckets = c.levels[ level ];
+        for ( int i = first; i < end; ++i ) {
+            Bucket bucket = children.at( 2 * i );
+            if ( 2 * i + 1 < children.size() ) {
+                bucket.add( children.at( 2 * i + 1 ) );
+            }
+            buckets[ i ] = bucket;
+        }
+    }
+}
+
+void CartesianDiagramDataPyramid::decompose( const Column& column, int firstRow, int endRow, PieceList* pieces ) const
+{
+    Q_ASSERT( column.rowCount >= 0 && column.dirtyFirstRow == column.dirtyEndRow );
+    Q_ASSERT( firstRow >= 0 && endRow <= column.rowCount );
+
+    const int headEndRow = qMin( endRow, ( firstRow + BaseBucketSize - 1 ) / BaseBucketSize * BaseBucketSize );
+    if ( firstRow < headEndRow ) {
+        const Piece head = { -1, firstRow, headEndRow };
+        pieces->append( head );
+    }
+    if ( headEndRow >= endRow ) {
+        return;
+    }
+
+    // the complete buckets in between, bottom up from both ends
+    int first = headEndRow / BaseBucketSize;
+    int end = endRow / BaseBucketSize;
+    const int tailFirstRow = end * BaseBucketSize;
+    PieceList right;
+    for ( int level = 0; first < end; ++level ) {
+        if ( first & 1 ) {
+            const Piece piece = { level, first, first + 1 };
+            pieces->append( piece );
+            ++first;
+        }
+        if ( end & 1 ) {
+            --end;
+            const Piece piece = { level, end, end + 1 };
+            right.append( piece );
+        }
+        first /= 2;
+        end /= 2;
+    }
+    for ( int i = right.size() - 1; i >= 0; --i ) {
+        pieces->append( right.at( i ) );
+    }
+
+    if ( tailFirstRow < endRow ) {
+        const Piece tail = { -1, tailFirstRow, endRow };
+        pieces->append( tail );
+    }
+}
+
+CartesianDiagramDataPyramid::Bucket CartesianDiagramDataPyramid::aggregate( int column, const qreal* values,
+                                                                            int firstRow, int endRow ) const
+{
+    Q_ASSERT( column < m_columns.size() );
+    const Column& c = m_columns.at( column );
+    PieceList pieces;
+    decompose( c, firstRow, endRow, &pieces );
+
+    Bucket result;
+    for ( int i = 0; i < pieces.size(); ++i ) {
+        const Piece& piece = pieces.at( i );
+        if ( piece.level == -1 ) {
+            for ( int row = piece.first; row < piece.end; ++row ) {
+                result.add( values[ row ] );
+            }
+        } else {
+            result.add( c.levels.at( piece.level ).at( piece.first ) );
+        }
+    }
+    return result;
+}
+
+int CartesianDiagramDataPyramid::minimumRow( int column, const qreal* values, int firstRow, int endRow ) const
+{
+    return extremumRow( column, values, firstRow, endRow, false );
+}
+
+int CartesianDiagramDataPyramid::maximumRow( int column, const qreal* values, int firstRow, int endRow ) const
+{
+    return extremumRow( column, values, firstRow, endRow, true );
+}
+
+int CartesianDiagramDataPyramid::extremumRow( int column, const qreal* values, int firstRow, int endRow,
+                                              bool maximum ) const
+{
+    const Bucket range = aggregate( column, values, firstRow, endRow );
+    if ( range.count == 0 ) {
+        return -1;
+    }
+    const qreal extremum = maximum ? range.max : range.min;
+
+    const Column& c = m_columns.at( column );
+    PieceList pieces;
+    decompose( c, firstRow, endRow, &pieces );
+    for ( int i = 0; i < pieces.size(); ++i ) {
+        const Piece& piece = pieces.at( i );
+        int first = piece.first;
+        int end = piece.end;
+        if ( piece.level != -1 ) {
+            const Bucket& bucket = c.levels.at( piece.level ).at( piece.first );
+            if ( ( maximum ? bucket.max : bucket.min ) != extremum ) {
+                continue;
+            }
+            // descend to the first base bucket holding the extremum
+            int index = piece.first;
+            for ( int level = piece.level - 1; level >= 0; --level ) {
+                index *= 2;
+                const Bucket& left = c.levels.at( level ).at( index );
+                if ( ( maximum ? left.max : left.min ) != extremum ) {
+                    ++index;
+                }
+            }
+            first = index * BaseBucketSize;
+            end = qMin( first + BaseBucketSize, c.rowCount );
+        }
+        for ( int row = first; row < end; ++row ) {
+            if ( values[ row ] == extremum ) {
+                return row;
+            }
+        }
+    }
+    Q_ASSERT( false );
+    return -1;
+}
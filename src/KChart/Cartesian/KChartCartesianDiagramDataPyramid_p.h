@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KCHARTCARTESIANDIAGRAMDATAPYRAMID_H
+#define KCHARTCARTESIANDIAGRAMDATAPYRAMID_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <limits>
+
+#include <QVector>
+#include <QVarLengthArray>
+
+namespace KChart {
+
+    // - level of detail index over the columns of a dataset: level 0 aggregates
+    // BaseBucketSize consecutive rows, every further level aggregates two
+    // buckets of the level below
+    // - the minimum, maximum, sum and count of any row range are found by
+    // combining O(log n) buckets plus at most 2 * BaseBucketSize raw values,
+    // which keeps zooming and panning through huge datasets independent of
+    // the number of rows per pixel
+    // - a column costs about half the memory of its raw values
+    class CartesianDiagramDataPyramid
+    {
+    public:
+        class Bucket {
+        public:
+            Bucket()
+                : min( std::numeric_limits< qreal >::infinity() ),
+                  max( -std::numeric_limits< qreal >::infinity() ),
+                  sum( 0.0 ),
+                  count( 0 )
+                  {}
+            // NaN values, i.e. missing data, are not counted
+            void add( qreal value );
+            void add( const Bucket& other );
+
+            qreal min;
+            qreal max;
+            qreal sum;
+            int count;
+        };
+
+        static const int BaseBucketSize = 16;
+
+        // forget all columns
+        void clear();
+        // the values in rows [firstRow, endRow) of the column have changed
+        void invalidate( int column, int firstRow, int endRow );
+
+        // the rows of the column that have to be up to date in the values
+        // passed to update()
+        void pendingRows( int column, int rowCount, int* firstRow, int* endRow ) const;
+        // builds or refreshes the levels of the column; values points to all
+        // rowCount values of the column
+        void update( int column, const qreal* values, int rowCount );
+
+        // the following require an up to date column, see update()
+        Bucket aggregate( int column, const qreal* values, int firstRow, int endRow ) const;
+        // first row in [firstRow, endRow) holding the minimum resp. maximum
+        // value of the range, or -1 if all values are missing
+        int minimumRow( int column, const qreal* values, int firstRow, int endRow ) const;
+        int maximumRow( int column, const qreal* values, int firstRow, int endRow ) const;
+
+    private:
+        class Column {
+        public:
+            Column()
+                : rowCount( -1 ),
+                  dirtyFirstRow( 0 ),
+                  dirtyEndRow( 0 )
+                  {}
+            QVector< QVector< Bucket > > levels;
+            int rowCount; // -1 if not built
+            int dirtyFirstRow;
+            int dirtyEndRow;
+        };
+
+        // a bucket of a level, or raw rows [first, end) if level is -1
+        class Piece {
+        public:
+            int level;
+            int first;
+            int end;
+        };
+        typedef QVarLengthArray< Piece, 64 > PieceList;
+
+        // splits [firstRow, endRow) into pieces, ordered by row
+        void decompose( const Column& column, int firstRow, int endRow, PieceList* pieces ) const;
+        int extremumRow( int column, const qreal* values, int firstRow, int endRow, bool maximum ) const;
+
+        QVector< Column > m_columns;
+    };
+}
+
+#endif
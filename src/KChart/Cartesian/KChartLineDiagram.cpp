@@ -53,6 +53,7 @@ void LineDiagram::init()
     d->implementor = d->normalDiagram;
     d->centerDataPoints = false;
     d->reverseDatasetOrder = false;
+    d->minMaxCompression = false;
 }
 
 LineDiagram::~LineDiagram()
@@ -66,6 +67,7 @@ LineDiagram * LineDiagram::clone() const
 {
     LineDiagram* newDiagram = new LineDiagram( new Private( *d ) );
     newDiagram->setType( type() );
+    newDiagram->setMinMaxCompression( minMaxCompression() );
     return newDiagram;
 }
 
@@ -81,7 +83,8 @@ bool LineDiagram::compare( const LineDiagram* other ) const
             // compare own properties
             (type()             == other->type()) &&
             (centerDataPoints() == other->centerDataPoints()) &&
-            (reverseDatasetOrder() == other->reverseDatasetOrder());
+            (reverseDatasetOrder() == other->reverseDatasetOrder()) &&
+            (minMaxCompression() == other->minMaxCompression());
 }
 
 void LineDiagram::setType( const LineType type )
@@ -108,6 +111,7 @@ void LineDiagram::setType( const LineType type )
 
    // d->lineType = type;
    Q_ASSERT( d->implementor->type() == type );
+   d->updateApproximationMode();
 
    // AbstractAxis settings - see AbstractDiagram and CartesianAxis
    setPercentMode( type == LineDiagram::Percent );
@@ -151,6 +155,24 @@ bool LineDiagram::reverseDatasetOrder() const
     return d->reverseDatasetOrder;
 }
 
+void LineDiagram::setMinMaxCompression( bool enable )
+{
+    if ( d->minMaxCompression == enable ) {
+        return;
+    }
+
+    d->minMaxCompression = enable;
+    d->updateApproximationMode();
+    setDataBoundariesDirty();
+    Q_EMIT layoutChanged( this );
+    Q_EMIT propertiesChanged();
+}
+
+bool LineDiagram::minMaxCompression() const
+{
+    return d->minMaxCompression;
+}
+
 void LineDiagram::setLineAttributes( const LineAttributes& la )
 {
     d->attributesModel->setModelData(
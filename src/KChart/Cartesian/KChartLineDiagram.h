@@ -93,6 +93,23 @@ public:
     /** \see setReverseDatasetOrder */
     bool reverseDatasetOrder() const;
 
+    /** If the diagram is too narrow to show every data point, the data points
+     * falling onto the same pixel are combined. By default they are averaged,
+     * which smooths out spikes. With this property set to true, each pixel
+     * keeps the first, the minimum, the maximum and the last of its data points
+     * instead, so the line looks like the uncompressed one while no more than
+     * four points per pixel are painted. The data boundaries stay exact.
+     *
+     * This only has an effect on Normal line diagrams with one-dimensional
+     * datasets, since stacked and percent diagrams combine the datasets
+     * point by point.
+     *
+     * \sa minMaxCompression()
+     */
+    void setMinMaxCompression( bool enable );
+    /** @return option set by setMinMaxCompression() */
+    bool minMaxCompression() const;
+
  
     /**
       * Sets the global line attributes to \a la
@@ -20,6 +20,13 @@ LineDiagram::Private::Private( const Private& rhs )
 {
 }
 
+void LineDiagram::Private::updateApproximationMode()
+{
+    const bool minMax = minMaxCompression && implementor == normalDiagram;
+    compressor.setApproximationMode( minMax ? CartesianDiagramDataCompressor::MinMax
+                                            : CartesianDiagramDataCompressor::Precise );
+}
+
 AttributesModel* LineDiagram::LineDiagramType::attributesModel() const
 {
     return m_private->attributesModel;
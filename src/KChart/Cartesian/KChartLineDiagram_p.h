@@ -53,6 +53,10 @@ namespace KChart {
         LineDiagramType* percentDiagram;
         bool centerDataPoints;
         bool reverseDatasetOrder;
+        bool minMaxCompression;
+
+        // tells the compressor how to combine the data points of a pixel
+        void updateApproximationMode();
     };
 
     KCHART_IMPL_DERIVED_DIAGRAM( LineDiagram, AbstractCartesianDiagram, CartesianCoordinatePlane )
@@ -223,31 +223,19 @@ StockDiagram::Private::~Private()
 }
 
 /*
- * Projects a point onto the coordinate plane
+ * Projects points onto the coordinate plane, all in one go
  *
- * @param context The context to paint the point in
- * @point The point to project onto the coordinate plane
- * @return The projected point
+ * @param context The context to paint the points in
+ * @param keys The x values of the points
+ * @param values The y values of the points
+ * @param points Receives the projected points
+ * @param count The number of points
  */
-QPointF StockDiagram::Private::projectPoint( PaintContext *context, const QPointF &point ) const
+void StockDiagram::Private::projectPoints( PaintContext *context, const qreal *keys, const qreal *values,
+                                           QPointF *points, int count ) const
 {
-    return context->coordinatePlane()->translate( QPointF( point.x() + 0.5, point.y() ) );
-}
-
-/*
- * Projects a candlestick onto the coordinate plane
- *
- * @param context The context to paint the candlestick in
- * @param low The
- */
-QRectF StockDiagram::Private::projectCandlestick( PaintContext *context, const QPointF &open, const QPointF &close, qreal width ) const
-{
-    const QPointF leftHighPoint = context->coordinatePlane()->translate( QPointF( close.x() + 0.5 - width / 2.0, close.y() ) );
-    const QPointF rightLowPoint = context->coordinatePlane()->translate( QPointF( open.x() + 0.5 + width / 2.0, open.y() ) );
-    const QPointF rightHighPoint = context->coordinatePlane()->translate( QPointF( close.x() + 0.5 + width / 2.0, close.y() ) );
-
-    return QRectF( leftHighPoint, QSizeF( rightHighPoint.x() - leftHighPoint.x(),
-                                          rightLowPoint.y() - leftHighPoint.y() ) );
+    Q_ASSERT( dynamic_cast< CartesianCoordinatePlane* >( context->coordinatePlane() ) );
+    static_cast< CartesianCoordinatePlane* >( context->coordinatePlane() )->translatePoints( keys, values, points, count );
 }
 
 void StockDiagram::Private::drawOHLCBar( int dataset, const CartesianDiagramDataCompressor::DataPoint &open,
@@ -367,14 +355,27 @@ void StockDiagram::Private::drawCandlestick( int /*dataset*/, const CartesianDia
     StockBarAttributes attr = stockDiagram()->stockBarAttributes( col );
     ThreeDBarAttributes threeDAttr = stockDiagram()->threeDBarAttributes( col );
 
-    const QPointF lowPoint = projectPoint( context, QPointF( low.key, low.value ) );
-    const QPointF highPoint = projectPoint( context, QPointF( high.key, high.value ) );
-    const QLineF lowerLine = QLineF( lowPoint, projectPoint( context, bottomCandlestickPoint ) );
-    const QLineF upperLine = QLineF( projectPoint( context, topCandlestickPoint ), highPoint );
-
-    // Convert the data point into coordinates on the coordinate plane
-    QRectF candlestick = projectCandlestick( context, bottomCandlestickPoint,
-                                             topCandlestickPoint, attr.candlestickWidth() );
+    // Convert the data points into coordinates on the coordinate plane: the low and high
+    // points, the bottom and top of the candlestick, and its top left, bottom right and
+    // top right corners
+    const qreal halfWidth = attr.candlestickWidth() / 2.0;
+    const qreal keys[ 7 ] = { low.key + 0.5, high.key + 0.5,
+                              bottomCandlestickPoint.x() + 0.5, topCandlestickPoint.x() + 0.5,
+                              topCandlestickPoint.x() + 0.5 - halfWidth,
+                              bottomCandlestickPoint.x() + 0.5 + halfWidth,
+                              topCandlestickPoint.x() + 0.5 + halfWidth };
+    const qreal values[ 7 ] = { low.value, high.value,
+                                bottomCandlestickPoint.y(), topCandlestickPoint.y(),
+                                topCandlestickPoint.y(), bottomCandlestickPoint.y(), topCandlestickPoint.y() };
+    QPointF points[ 7 ];
+    projectPoints( context, keys, values, points, 7 );
+
+    const QPointF lowPoint = points[ 0 ];
+    const QPointF highPoint = points[ 1 ];
+    const QLineF lowerLine = QLineF( lowPoint, points[ 2 ] );
+    const QLineF upperLine = QLineF( points[ 3 ], highPoint );
+    QRectF candlestick( points[ 4 ], QSizeF( points[ 6 ].x() - points[ 4 ].x(),
+                                             points[ 5 ].y() - points[ 4 ].y() ) );
 
     // Remember the drawn polygon to add it to the ReverseMapper later
     QPolygonF drawnPolygon;
@@ -463,9 +464,11 @@ void StockDiagram::Private::drawLine( int dataset, int col, const QPointF &point
     const QBrush brush = diagram->brush( dataset );
     const ThreeDBarAttributes threeDBarAttr = stockDiagram()->threeDBarAttributes( col );
 
-    QPointF transP1 = context->coordinatePlane()->translate( point1 );
-    QPointF transP2 = context->coordinatePlane()->translate( point2 );
-    QLineF line = QLineF( transP1, transP2 );
+    const qreal keys[ 2 ] = { point1.x(), point2.x() };
+    const qreal values[ 2 ] = { point1.y(), point2.y() };
+    QPointF transPoints[ 2 ];
+    projectPoints( context, keys, values, transPoints, 2 );
+    QLineF line = QLineF( transPoints[ 0 ], transPoints[ 1 ] );
 
     if ( threeDBarAttr.isEnabled() ) {
         ThreeDPainter::ThreeDProperties threeDProps;
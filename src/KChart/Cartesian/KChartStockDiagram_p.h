@@ -59,8 +59,7 @@ public:
 
 private:
     void drawLine( int dataset, int col, const QPointF &point1, const QPointF &p2, PaintContext *context );
-    QPointF projectPoint( PaintContext *context, const QPointF &point ) const;
-    QRectF projectCandlestick( PaintContext *context, const QPointF &open, const QPointF &close, qreal width ) const;
+    void projectPoints( PaintContext *context, const qreal *keys, const qreal *values, QPointF *points, int count ) const;
     int openValueColumn() const;
     int highValueColumn() const;
     int lowValueColumn() const;
@@ -11,6 +11,7 @@
 #include "KChartGlobal.h"
 
 #include "KChartAbstractDiagram.h"
+#include "KChartAttributesModel.h"
 #include "KChartCartesianCoordinatePlane.h"
 #include "KChartLineDiagram.h"
 #include "KChartValueTrackerAttributes.h"
@@ -18,10 +19,16 @@
 #include "KChartPainterSaver_p.h"
 #include "KChartPlotter.h"
 #include "KChartPrintingParameters.h"
+#include "KChartRenderTracer_p.h"
 #include "KChartLineAttributes.h"
+#include "KChartModelDataCache_p.h"
 #include "KChartThreeDLineAttributes.h"
 #include "ReverseMapper.h"
 
+#include <QHash>
+#include <QScopedPointer>
+#include <QSet>
+
 namespace KChart {
 namespace PaintingHelpers {
 
@@ -191,44 +198,147 @@ static ValueTrackerAttributes valueTrackerAttributes( AbstractDiagram* diagram,
     return ValueTrackerAttributes();
 }
 
+// the attributes needed to paint a line segment
+class SegmentAttributes
+{
+public:
+    SegmentAttributes( AbstractDiagram* diagram, const QModelIndex& index )
+        : threeD( threeDLineAttributes( diagram, index ) ),
+          line( lineAttributes( diagram, index ) ),
+          valueTracker( valueTrackerAttributes( diagram, index ) ),
+          brush( diagram->brush( index ) ),
+          pen( diagram->pen( index ) )
+    {}
+
+    ThreeDLineAttributes threeD;
+    LineAttributes line;
+    ValueTrackerAttributes valueTracker;
+    QBrush brush;
+    QPen pen;
+};
+
+// Resolving attributes through the attributes model is expensive, so they are resolved once
+// per dataset, unless some cells of the dataset have their own, either set on the diagram or
+// returned by the source model. Whether the source model has any is remembered by the diagram
+// until the model changes.
+class SegmentAttributesCache
+{
+public:
+    explicit SegmentAttributesCache( AbstractDiagram::Private* diagramPrivate )
+        : m_diagram( diagramPrivate->diagram ),
+          m_sourceCellAttributes( diagramPrivate->sourceCellAttributes )
+    {}
+
+    const SegmentAttributes& attributes( const QModelIndex& index )
+    {
+        const int column = index.column();
+        QHash< int, SegmentAttributes >::const_iterator it = m_datasets.constFind( column );
+        if ( it != m_datasets.constEnd() ) {
+            return it.value();
+        }
+        if ( !m_cellColumns.contains( column ) ) {
+            if ( !hasCellOverrides( column ) ) {
+                return m_datasets.insert( column, SegmentAttributes( m_diagram, index ) ).value();
+            }
+            m_cellColumns.insert( column );
+        }
+        m_cell.reset( new SegmentAttributes( m_diagram, index ) );
+        return *m_cell;
+    }
+
+private:
+    bool hasCellOverrides( int column ) const
+    {
+        const AttributesModel* attributesModel = m_diagram->attributesModel();
+        for ( int role : roles ) {
+            if ( attributesModel->hasCellOverrides( column, role ) ) {
+                return true;
+            }
+        }
+
+        // the source model takes precedence, it is checked once until it changes
+        QHash< int, bool >::const_iterator it = m_sourceCellAttributes.constFind( column );
+        if ( it == m_sourceCellAttributes.constEnd() ) {
+            it = m_sourceCellAttributes.insert( column, sourceHasCellAttributes( column ) );
+        }
+        return it.value();
+    }
+
+    bool sourceHasCellAttributes( int column ) const
+    {
+        const QAbstractItemModel* model = m_diagram->model();
+        const QModelIndex root = m_diagram->rootIndex();
+        if ( !model ) {
+            return false;
+        }
+        if ( const BulkNumericSource* bulkSource = ModelDataCachePrivate::bulkNumericSource( model ) ) {
+            if ( !bulkSource->mayContainCellAttributes( column, ModelDataCachePrivate::mapToBulkNumericSource( model, root ) ) ) {
+                return false;
+            }
+        }
+        const int rowCount = model->rowCount( root );
+        for ( int row = 0; row < rowCount; ++row ) {
+            const QModelIndex index = model->index( row, column, root );
+            for ( int role : roles ) {
+                if ( model->data( index, role ).isValid() ) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    static const int roles[ 5 ];
+
+    AbstractDiagram* m_diagram;
+    QHash< int, bool >& m_sourceCellAttributes;
+    QHash< int, SegmentAttributes > m_datasets;
+    QSet< int > m_cellColumns;
+    QScopedPointer< SegmentAttributes > m_cell;
+};
+
+const int SegmentAttributesCache::roles[ 5 ] = { ThreeDLineAttributesRole, LineAttributesRole, ValueTrackerAttributesRole,
+                                                 DatasetBrushRole, DatasetPenRole };
+
 void paintElements( AbstractDiagram::Private *diagramPrivate, PaintContext* ctx,
                     const LabelPaintCache& lpc, const LineAttributesInfoList& lineList )
 {
     AbstractDiagram* diagram = diagramPrivate->diagram;
+    traceCount( "line segments painted", diagram, lineList.size() );
     // paint all lines and their attributes
     const PainterSaver painterSaver( ctx->painter() );
     ctx->painter()->setRenderHint( QPainter::Antialiasing, diagram->antiAliasing() );
 
+    SegmentAttributesCache attributesCache( diagramPrivate );
+    bool hasValueTrackers = false;
     QBrush curBrush;
     QPen curPen;
     QPolygonF points;
     for ( const LineAttributesInfo& lineInfo : lineList ) {
         const QModelIndex& index = lineInfo.index;
-        const ThreeDLineAttributes td = threeDLineAttributes( diagram, index );
-        const LineAttributes la = lineAttributes( diagram, index );
+        const SegmentAttributes& attributes = attributesCache.attributes( index );
+        hasValueTrackers = hasValueTrackers || attributes.valueTracker.isEnabled();
 
-        if ( !la.isVisible() ) {
+        if ( !attributes.line.isVisible() ) {
             // Do not draw lines, but do draw text and markers
-        } else if( td.isEnabled() ){
+        } else if( attributes.threeD.isEnabled() ){
             PaintingHelpers::paintThreeDLines( ctx, diagram, index, lineInfo.value,
-                                               lineInfo.nextValue, td, &diagramPrivate->reverseMapper );
+                                               lineInfo.nextValue, attributes.threeD, &diagramPrivate->reverseMapper );
         } else {
-            const QBrush brush( diagram->brush( index ) );
-            const QPen pen( diagram->pen( index ) );
-
             // line goes from lineInfo.value to lineInfo.nextValue
             diagramPrivate->reverseMapper.addLine( lineInfo.index.row(), lineInfo.index.column(),
                                                    lineInfo.value, lineInfo.nextValue );
 
-            if ( points.count() && points.last() == lineInfo.value && curBrush == brush && curPen == pen ) {
+            if ( points.count() && points.last() == lineInfo.value &&
+                 curBrush == attributes.brush && curPen == attributes.pen ) {
                 // continue the current run of lines
             } else {
                 // different painter settings or discontinuous line: start a new run of lines
                 if ( points.count() ) {
                     PaintingHelpers::paintPolyline( ctx, curBrush, curPen, points );
                 }
-                curBrush = brush;
-                curPen = pen;
+                curBrush = attributes.brush;
+                curPen = attributes.pen;
                 points.clear();
                 points << lineInfo.value;
             }
@@ -240,10 +350,12 @@ void paintElements( AbstractDiagram::Private *diagramPrivate, PaintContext* ctx,
         PaintingHelpers::paintPolyline( ctx, curBrush, curPen, points );
     }
 
-    for ( const LineAttributesInfo& lineInfo : lineList ) {
-        const ValueTrackerAttributes vt = valueTrackerAttributes( diagram, lineInfo.index );
-        if ( vt.isEnabled() ) {
-            PaintingHelpers::paintValueTracker( ctx, vt, lineInfo.nextValue );
+    if ( hasValueTrackers ) {
+        for ( const LineAttributesInfo& lineInfo : lineList ) {
+            const ValueTrackerAttributes& vt = attributesCache.attributes( lineInfo.index ).valueTracker;
+            if ( vt.isEnabled() ) {
+                PaintingHelpers::paintValueTracker( ctx, vt, lineInfo.nextValue );
+            }
         }
     }
 
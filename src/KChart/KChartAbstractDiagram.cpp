@@ -24,6 +24,7 @@
 #include "KChartAbstractThreeDAttributes.h"
 #include "KChartThreeDLineAttributes.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartRenderTracer_p.h"
 
 #include <limits>
 
@@ -89,6 +90,7 @@ bool AbstractDiagram::compare( const AbstractDiagram* other ) const
             (rootIndex().row()                == other->rootIndex().row()) &&
             (allowOverlappingDataValueTexts() == other->allowOverlappingDataValueTexts()) &&
             (antiAliasing()                   == other->antiAliasing()) &&
+            (hitTestingPolicy()               == other->hitTestingPolicy()) &&
             (percentMode()                    == other->percentMode()) &&
             (datasetDimension()               == other->datasetDimension());
 }
@@ -110,6 +112,7 @@ const QPair<QPointF, QPointF> AbstractDiagram::dataBoundaries () const
 void AbstractDiagram::setDataBoundariesDirty() const
 {
     d->databoundariesDirty = true;
+    d->sourceCellAttributes.clear();
     update();
 }
 
@@ -366,6 +369,17 @@ bool AbstractDiagram::antiAliasing() const
     return d->antiAliasing;
 }
 
+void AbstractDiagram::setHitTestingPolicy( HitTestingPolicy policy )
+{
+    d->hitTestingPolicy = policy;
+    Q_EMIT propertiesChanged();
+}
+
+AbstractDiagram::HitTestingPolicy AbstractDiagram::hitTestingPolicy() const
+{
+    return d->hitTestingPolicy;
+}
+
 void AbstractDiagram::setPercentMode ( bool percent )
 {
     d->percent = percent;
@@ -422,6 +436,9 @@ void AbstractDiagram::paintMarker( QPainter* painter,
     if ( !checkInvariants() || !a.isVisible() ) return;
     const MarkerAttributes ma = a.markerAttributes();
     if ( !ma.isVisible() ) return;
+    if ( ma.markerStyle() != MarkerAttributes::NoMarker ) {
+        traceCount( "markers painted", this );
+    }
 
     const PainterSaver painterSaver( painter );
 
@@ -485,6 +502,8 @@ void AbstractDiagram::paintMarker( QPainter* painter,
     // make sure to use the brush color - see above in those cases.
     const bool isFourPixels = (markerAttributes.markerStyle() == MarkerAttributes::Marker4Pixels);
     if ( isFourPixels || (markerAttributes.markerStyle() == MarkerAttributes::Marker1Pixel) ) {
+        // markers collected for a batch have to be painted below this one
+        d->flushMarkerBatch();
         // for high-performance point charts with tiny point markers:
         painter->setPen( PrintingParameters::scalePen( QPen( brush.color().lighter() ) ) );
         if ( isFourPixels ) {
@@ -498,299 +517,308 @@ void AbstractDiagram::paintMarker( QPainter* painter,
                                QPointF(x+1.0,y+1.0) );
         }
         painter->drawPoint( pos );
-    } else {
+    } else if ( !d->paintMarkerSprite( painter, markerAttributes, brush, pen, pos, maSize ) ) {
+        d->flushMarkerBatch();
         const PainterSaver painterSaver( painter );
         QPen painterPen( pen );
         painter->setPen( PrintingParameters::scalePen( painterPen ) );
         painter->setBrush( brush );
         painter->setRenderHint ( QPainter::Antialiasing );
         painter->translate( pos );
-        switch ( markerAttributes.markerStyle() ) {
-            case MarkerAttributes::MarkerCircle:
+        Private::paintMarkerShape( painter, markerAttributes, brush, maSize );
+    }
+    painter->setPen( oldPen );
+}
+
+void AbstractDiagram::Private::paintMarkerShape( QPainter* painter,
+                                                 const MarkerAttributes& markerAttributes,
+                                                 const QBrush& brush,
+                                                 const QSizeF& maSize )
+{
+    switch ( markerAttributes.markerStyle() ) {
+        case MarkerAttributes::MarkerCircle:
+        {
+            if ( markerAttributes.threeD() ) {
+                QRadialGradient grad;
+                grad.setCoordinateMode( QGradient::ObjectBoundingMode );
+                QColor drawColor = brush.color();
+                grad.setCenter( 0.5, 0.5 );
+                grad.setRadius( 1.0 );
+                grad.setFocalPoint( 0.35, 0.35 );
+                grad.setColorAt( 0.00, drawColor.lighter( 150 ) );
+                grad.setColorAt( 0.20, drawColor );
+                grad.setColorAt( 0.50, drawColor.darker( 150 ) );
+                grad.setColorAt( 0.75, drawColor.darker( 200 ) );
+                grad.setColorAt( 0.95, drawColor.darker( 250 ) );
+                grad.setColorAt( 1.00, drawColor.darker( 200 ) );
+                QBrush newBrush( grad );
+                newBrush.setTransform( brush.transform() );
+                painter->setBrush( newBrush );
+            }
+            painter->drawEllipse( QRectF( 0 - maSize.height()/2, 0 - maSize.width()/2,
+                        maSize.height(), maSize.width()) );
+        }
+            break;
+        case MarkerAttributes::MarkerSquare:
             {
-                if ( markerAttributes.threeD() ) {
-                    QRadialGradient grad;
-                    grad.setCoordinateMode( QGradient::ObjectBoundingMode );
-                    QColor drawColor = brush.color();
-                    grad.setCenter( 0.5, 0.5 );
-                    grad.setRadius( 1.0 );
-                    grad.setFocalPoint( 0.35, 0.35 );
-                    grad.setColorAt( 0.00, drawColor.lighter( 150 ) );
-                    grad.setColorAt( 0.20, drawColor );
-                    grad.setColorAt( 0.50, drawColor.darker( 150 ) );
-                    grad.setColorAt( 0.75, drawColor.darker( 200 ) );
-                    grad.setColorAt( 0.95, drawColor.darker( 250 ) );
-                    grad.setColorAt( 1.00, drawColor.darker( 200 ) );
-                    QBrush newBrush( grad );
-                    newBrush.setTransform( brush.transform() );
-                    painter->setBrush( newBrush );
-                }
+                QRectF rect( 0 - maSize.width()/2, 0 - maSize.height()/2,
+                            maSize.width(), maSize.height() );
+                painter->drawRect( rect );
+                break;
+            }
+        case MarkerAttributes::MarkerDiamond:
+            {
+                QVector <QPointF > diamondPoints;
+                QPointF top, left, bottom, right;
+                top    = QPointF( 0, 0 - maSize.height()/2 );
+                left   = QPointF( 0 - maSize.width()/2, 0 );
+                bottom = QPointF( 0, maSize.height()/2 );
+                right  = QPointF( maSize.width()/2, 0 );
+                diamondPoints << top << left << bottom << right;
+                painter->drawPolygon( diamondPoints );
+                break;
+            }
+        // both handled on top of the method:
+        case MarkerAttributes::Marker1Pixel:
+        case MarkerAttributes::Marker4Pixels:
+                break;
+        case MarkerAttributes::MarkerRing:
+            {
+                painter->setBrush( Qt::NoBrush );
+                painter->setPen( PrintingParameters::scalePen( QPen( brush.color() ) ) );
                 painter->drawEllipse( QRectF( 0 - maSize.height()/2, 0 - maSize.width()/2,
-                            maSize.height(), maSize.width()) );
+                                    maSize.height(), maSize.width()) );
+                break;
             }
+        case MarkerAttributes::MarkerCross:
+            {
+                // Note: Markers can have outline,
+                //       so just drawing two rects is NOT the solution here!
+                const qreal w02 = maSize.width() * 0.2;
+                const qreal w05 = maSize.width() * 0.5;
+                const qreal h02 = maSize.height()* 0.2;
+                const qreal h05 = maSize.height()* 0.5;
+                QVector <QPointF > crossPoints;
+                QPointF p[12];
+                p[ 0] = QPointF( -w02, -h05 );
+                p[ 1] = QPointF( w02, -h05 );
+                p[ 2] = QPointF( w02, -h02 );
+                p[ 3] = QPointF( w05, -h02 );
+                p[ 4] = QPointF( w05,  h02 );
+                p[ 5] = QPointF( w02,  h02 );
+                p[ 6] = QPointF( w02,  h05 );
+                p[ 7] = QPointF( -w02,  h05 );
+                p[ 8] = QPointF( -w02,  h02 );
+                p[ 9] = QPointF( -w05,  h02 );
+                p[10] = QPointF( -w05, -h02 );
+                p[11] = QPointF( -w02, -h02 );
+                for ( int i=0; i<12; ++i )
+                    crossPoints << p[i];
+                crossPoints << p[0];
+                painter->drawPolygon( crossPoints );
                 break;
-            case MarkerAttributes::MarkerSquare:
-                {
-                    QRectF rect( 0 - maSize.width()/2, 0 - maSize.height()/2,
-                                maSize.width(), maSize.height() );
-                    painter->drawRect( rect );
-                    break;
-                }
-            case MarkerAttributes::MarkerDiamond:
-                {
-                    QVector <QPointF > diamondPoints;
-                    QPointF top, left, bottom, right;
-                    top    = QPointF( 0, 0 - maSize.height()/2 );
-                    left   = QPointF( 0 - maSize.width()/2, 0 );
-                    bottom = QPointF( 0, maSize.height()/2 );
-                    right  = QPointF( maSize.width()/2, 0 );
-                    diamondPoints << top << left << bottom << right;
-                    painter->drawPolygon( diamondPoints );
-                    break;
-                }
-            // both handled on top of the method:
-            case MarkerAttributes::Marker1Pixel:
-            case MarkerAttributes::Marker4Pixels:
-                    break;
-            case MarkerAttributes::MarkerRing:
-                {
-                    painter->setBrush( Qt::NoBrush );
-                    painter->setPen( PrintingParameters::scalePen( QPen( brush.color() ) ) );
-                    painter->drawEllipse( QRectF( 0 - maSize.height()/2, 0 - maSize.width()/2,
-                                        maSize.height(), maSize.width()) );
-                    break;
-                }
-            case MarkerAttributes::MarkerCross:
-                {
-                    // Note: Markers can have outline,
-                    //       so just drawing two rects is NOT the solution here!
-                    const qreal w02 = maSize.width() * 0.2;
-                    const qreal w05 = maSize.width() * 0.5;
-                    const qreal h02 = maSize.height()* 0.2;
-                    const qreal h05 = maSize.height()* 0.5;
-                    QVector <QPointF > crossPoints;
-                    QPointF p[12];
-                    p[ 0] = QPointF( -w02, -h05 );
-                    p[ 1] = QPointF( w02, -h05 );
-                    p[ 2] = QPointF( w02, -h02 );
-                    p[ 3] = QPointF( w05, -h02 );
-                    p[ 4] = QPointF( w05,  h02 );
-                    p[ 5] = QPointF( w02,  h02 );
-                    p[ 6] = QPointF( w02,  h05 );
-                    p[ 7] = QPointF( -w02,  h05 );
-                    p[ 8] = QPointF( -w02,  h02 );
-                    p[ 9] = QPointF( -w05,  h02 );
-                    p[10] = QPointF( -w05, -h02 );
-                    p[11] = QPointF( -w02, -h02 );
-                    for ( int i=0; i<12; ++i )
-                        crossPoints << p[i];
-                    crossPoints << p[0];
-                    painter->drawPolygon( crossPoints );
-                    break;
-                }
-            case MarkerAttributes::MarkerFastCross:
-                {
-                    QPointF left, right, top, bottom;
-                    left  = QPointF( -maSize.width()/2, 0 );
-                    right = QPointF( maSize.width()/2, 0 );
-                    top   = QPointF( 0, -maSize.height()/2 );
-                    bottom= QPointF( 0, maSize.height()/2 );
-                    painter->setPen( PrintingParameters::scalePen( QPen( brush.color() ) ) );
-                    painter->drawLine( left, right );
-                    painter->drawLine( top, bottom );
-                    break;
-                }
-            case MarkerAttributes::MarkerArrowDown:
-                {
-                    QVector <QPointF > arrowPoints;
-                    QPointF topLeft, topRight, bottom;
-                    topLeft  = QPointF( 0 - maSize.width()/2, 0 - maSize.height()/2 );
-                    topRight = QPointF( maSize.width()/2, 0 - maSize.height()/2 );
-                    bottom   = QPointF( 0, maSize.height()/2 );
-                    arrowPoints << topLeft << bottom << topRight;
-                    painter->drawPolygon( arrowPoints );
-                    break;
-                }
-            case MarkerAttributes::MarkerArrowUp:
-                {
-                    QVector <QPointF > arrowPoints;
-                    QPointF top, bottomLeft, bottomRight;
-                    top         = QPointF( 0, 0 - maSize.height()/2 );
-                    bottomLeft  = QPointF( 0 - maSize.width()/2, maSize.height()/2 );
-                    bottomRight = QPointF( maSize.width()/2, maSize.height()/2 );
-                    arrowPoints << top << bottomLeft << bottomRight;
-                    painter->drawPolygon( arrowPoints );
-                    break;
-                }
-            case MarkerAttributes::MarkerArrowRight:
-                {
-                    QVector <QPointF > arrowPoints;
-                    QPointF right, topLeft, bottomLeft;
-                    right      = QPointF( maSize.width()/2, 0 );
-                    topLeft    = QPointF( 0 - maSize.width()/2, 0 - maSize.height()/2 );
-                    bottomLeft = QPointF( 0 - maSize.width()/2, maSize.height()/2 );
-                    arrowPoints << topLeft << bottomLeft << right;
-                    painter->drawPolygon( arrowPoints );
-                    break;
-                }
-            case MarkerAttributes::MarkerArrowLeft:
-                {
-                    QVector <QPointF > arrowPoints;
-                    QPointF left, topRight, bottomRight;
-                    left        = QPointF( 0 - maSize.width()/2, 0 );
-                    topRight    = QPointF( maSize.width()/2, 0 - maSize.height()/2 );
-                    bottomRight = QPointF( maSize.width()/2, maSize.height()/2 );
-                    arrowPoints << left << bottomRight << topRight;
-                    painter->drawPolygon( arrowPoints );
-                    break;
-                }
-            case MarkerAttributes::MarkerBowTie:
-            case MarkerAttributes::MarkerHourGlass:
-                {
-                    QVector <QPointF > points;
-                    QPointF topLeft, topRight, bottomLeft, bottomRight;
-                    topLeft     = QPointF( 0 - maSize.width()/2, 0 - maSize.height()/2);
-                    topRight    = QPointF( maSize.width()/2, 0 - maSize.height()/2 );
-                    bottomLeft  = QPointF( 0 - maSize.width()/2, maSize.height()/2 );
-                    bottomRight = QPointF( maSize.width()/2, maSize.height()/2 );
-                    if ( markerAttributes.markerStyle() == MarkerAttributes::MarkerBowTie)
-                        points << topLeft << bottomLeft << topRight << bottomRight;
-                    else
-                        points << topLeft << bottomRight << bottomLeft << topRight;
-                    painter->drawPolygon( points );
-                    break;
-                }
-            case MarkerAttributes::MarkerStar:
-                {
-                    const qreal w01 = maSize.width() * 0.1;
-                    const qreal w05 = maSize.width() * 0.5;
-                    const qreal h01 = maSize.height() * 0.1;
-                    const qreal h05 = maSize.height() * 0.5;
-                    QVector <QPointF > points;
-                    QPointF p1 = QPointF(    0, -h05 );
-                    QPointF p2 = QPointF( -w01, -h01 );
-                    QPointF p3 = QPointF( -w05,    0 );
-                    QPointF p4 = QPointF( -w01,  h01 );
-                    QPointF p5 = QPointF(    0,  h05 );
-                    QPointF p6 = QPointF(  w01,  h01 );
-                    QPointF p7 = QPointF( w05,    0 );
-                    QPointF p8 = QPointF( w01, -h01 );
-                    points << p1 << p2 << p3 << p4 << p5 << p6 << p7 << p8;
-                    painter->drawPolygon( points );
-                    break;
-                }
-            case MarkerAttributes::MarkerX:
-                {
-                    const qreal w01 = maSize.width() * 0.1;
-                    const qreal w04 = maSize.width() * 0.4;
-                    const qreal w05 = maSize.width() * 0.5;
-                    const qreal h01 = maSize.height() * 0.1;
-                    const qreal h04 = maSize.height() * 0.4;
-                    const qreal h05 = maSize.height() * 0.5;
-                    QVector <QPointF > crossPoints;
-                    QPointF p1 = QPointF( -w04, -h05 );
-                    QPointF p2 = QPointF( -w05, -h04 );
-                    QPointF p3 = QPointF( -w01,  0 );
-                    QPointF p4 = QPointF( -w05,  h04 );
-                    QPointF p5 = QPointF( -w04,  h05 );
-                    QPointF p6 = QPointF(  0,    h01 );
-                    QPointF p7 = QPointF(  w04,  h05 );
-                    QPointF p8 = QPointF(  w05,  h04 );
-                    QPointF p9 = QPointF(  w01,  0 );
-                    QPointF p10 = QPointF( w05, -h04 );
-                    QPointF p11 = QPointF( w04, -h05 );
-                    QPointF p12 = QPointF( 0,   -h01 );
-                    crossPoints << p1 << p2 << p3 << p4 << p5 << p6
-                                << p7 << p8 << p9 << p10 << p11 << p12;
-                    painter->drawPolygon( crossPoints );
-                    break;
-                }
-            case MarkerAttributes::MarkerAsterisk:
-                {
-                    // Note: Markers can have outline,
-                    //       so just drawing three lines is NOT the solution here!
-                    // The idea that we use is to draw 3 lines anyway, but convert their
-                    // outlines to QPainterPaths which are then united and filled.
-                    const qreal w04 = maSize.width() * 0.4;
-                    const qreal h02 = maSize.height() * 0.2;
-                    const qreal h05 = maSize.height() * 0.5;
-                    //QVector <QPointF > crossPoints;
-                    QPointF p1 = QPointF(    0, -h05 );
-                    QPointF p2 = QPointF( -w04, -h02 );
-                    QPointF p3 = QPointF( -w04,  h02 );
-                    QPointF p4 = QPointF(    0,  h05 );
-                    QPointF p5 = QPointF(  w04,  h02 );
-                    QPointF p6 = QPointF(  w04, -h02 );
-                    QPen pen = painter->pen();
-                    QPainterPathStroker stroker;
-                    stroker.setWidth( pen.widthF() );
-                    stroker.setCapStyle( pen.capStyle() );
-
-                    QPainterPath path;
-                    QPainterPath dummyPath;
-                    dummyPath.moveTo( p1 );
-                    dummyPath.lineTo( p4 );
-                    path = stroker.createStroke( dummyPath );
-
-                    dummyPath = QPainterPath();
-                    dummyPath.moveTo( p2 );
-                    dummyPath.lineTo( p5 );
-                    path = path.united( stroker.createStroke( dummyPath ) );
-
-                    dummyPath = QPainterPath();
-                    dummyPath.moveTo( p3 );
-                    dummyPath.lineTo( p6 );
-                    path = path.united( stroker.createStroke( dummyPath ) );
-
-                    painter->drawPath( path );
-                    break;
-                }
-            case MarkerAttributes::MarkerHorizontalBar:
-                {
-                    const qreal w05 = maSize.width() * 0.5;
-                    const qreal h02 = maSize.height()* 0.2;
-                    QVector <QPointF > points;
-                    QPointF p1 = QPointF( -w05, -h02 );
-                    QPointF p2 = QPointF( -w05,  h02 );
-                    QPointF p3 = QPointF(  w05,  h02 );
-                    QPointF p4 = QPointF(  w05, -h02 );
-                    points << p1 << p2 << p3 << p4;
-                    painter->drawPolygon( points );
-                    break;
-                }
-            case MarkerAttributes::MarkerVerticalBar:
-                {
-                    const qreal w02 = maSize.width() * 0.2;
-                    const qreal h05 = maSize.height()* 0.5;
-                    QVector <QPointF > points;
-                    QPointF p1 = QPointF( -w02, -h05 );
-                    QPointF p2 = QPointF( -w02,  h05 );
-                    QPointF p3 = QPointF(  w02,  h05 );
-                    QPointF p4 = QPointF(  w02, -h05 );
-                    points << p1 << p2 << p3 << p4;
-                    painter->drawPolygon( points );
-                    break;
-                }
-            case MarkerAttributes::NoMarker:
+            }
+        case MarkerAttributes::MarkerFastCross:
+            {
+                QPointF left, right, top, bottom;
+                left  = QPointF( -maSize.width()/2, 0 );
+                right = QPointF( maSize.width()/2, 0 );
+                top   = QPointF( 0, -maSize.height()/2 );
+                bottom= QPointF( 0, maSize.height()/2 );
+                painter->setPen( PrintingParameters::scalePen( QPen( brush.color() ) ) );
+                painter->drawLine( left, right );
+                painter->drawLine( top, bottom );
                 break;
-            case MarkerAttributes::PainterPathMarker:
-                {
-                    QPainterPath path = markerAttributes.customMarkerPath();
-                    const QRectF pathBoundingRect = path.boundingRect();
-                    const qreal xScaling = maSize.height() / pathBoundingRect.height();
-                    const qreal yScaling = maSize.width() / pathBoundingRect.width();
-                    const qreal scaling = qMin( xScaling, yScaling );
-                    painter->scale( scaling, scaling );
-                    painter->setPen( PrintingParameters::scalePen( QPen( brush.color() ) ) );
-                    painter->drawPath(path);
-                    break;
-                }
-            default:
-                Q_ASSERT_X ( false, "paintMarkers()",
-                            "Type item does not match a defined Marker Type." );
-        }
+            }
+        case MarkerAttributes::MarkerArrowDown:
+            {
+                QVector <QPointF > arrowPoints;
+                QPointF topLeft, topRight, bottom;
+                topLeft  = QPointF( 0 - maSize.width()/2, 0 - maSize.height()/2 );
+                topRight = QPointF( maSize.width()/2, 0 - maSize.height()/2 );
+                bottom   = QPointF( 0, maSize.height()/2 );
+                arrowPoints << topLeft << bottom << topRight;
+                painter->drawPolygon( arrowPoints );
+                break;
+            }
+        case MarkerAttributes::MarkerArrowUp:
+            {
+                QVector <QPointF > arrowPoints;
+                QPointF top, bottomLeft, bottomRight;
+                top         = QPointF( 0, 0 - maSize.height()/2 );
+                bottomLeft  = QPointF( 0 - maSize.width()/2, maSize.height()/2 );
+                bottomRight = QPointF( maSize.width()/2, maSize.height()/2 );
+                arrowPoints << top << bottomLeft << bottomRight;
+                painter->drawPolygon( arrowPoints );
+                break;
+            }
+        case MarkerAttributes::MarkerArrowRight:
+            {
+                QVector <QPointF > arrowPoints;
+                QPointF right, topLeft, bottomLeft;
+                right      = QPointF( maSize.width()/2, 0 );
+                topLeft    = QPointF( 0 - maSize.width()/2, 0 - maSize.height()/2 );
+                bottomLeft = QPointF( 0 - maSize.width()/2, maSize.height()/2 );
+                arrowPoints << topLeft << bottomLeft << right;
+                painter->drawPolygon( arrowPoints );
+                break;
+            }
+        case MarkerAttributes::MarkerArrowLeft:
+            {
+                QVector <QPointF > arrowPoints;
+                QPointF left, topRight, bottomRight;
+                left        = QPointF( 0 - maSize.width()/2, 0 );
+                topRight    = QPointF( maSize.width()/2, 0 - maSize.height()/2 );
+                bottomRight = QPointF( maSize.width()/2, maSize.height()/2 );
+                arrowPoints << left << bottomRight << topRight;
+                painter->drawPolygon( arrowPoints );
+                break;
+            }
+        case MarkerAttributes::MarkerBowTie:
+        case MarkerAttributes::MarkerHourGlass:
+            {
+                QVector <QPointF > points;
+                QPointF topLeft, topRight, bottomLeft, bottomRight;
+                topLeft     = QPointF( 0 - maSize.width()/2, 0 - maSize.height()/2);
+                topRight    = QPointF( maSize.width()/2, 0 - maSize.height()/2 );
+                bottomLeft  = QPointF( 0 - maSize.width()/2, maSize.height()/2 );
+                bottomRight = QPointF( maSize.width()/2, maSize.height()/2 );
+                if ( markerAttributes.markerStyle() == MarkerAttributes::MarkerBowTie)
+                    points << topLeft << bottomLeft << topRight << bottomRight;
+                else
+                    points << topLeft << bottomRight << bottomLeft << topRight;
+                painter->drawPolygon( points );
+                break;
+            }
+        case MarkerAttributes::MarkerStar:
+            {
+                const qreal w01 = maSize.width() * 0.1;
+                const qreal w05 = maSize.width() * 0.5;
+                const qreal h01 = maSize.height() * 0.1;
+                const qreal h05 = maSize.height() * 0.5;
+                QVector <QPointF > points;
+                QPointF p1 = QPointF(    0, -h05 );
+                QPointF p2 = QPointF( -w01, -h01 );
+                QPointF p3 = QPointF( -w05,    0 );
+                QPointF p4 = QPointF( -w01,  h01 );
+                QPointF p5 = QPointF(    0,  h05 );
+                QPointF p6 = QPointF(  w01,  h01 );
+                QPointF p7 = QPointF( w05,    0 );
+                QPointF p8 = QPointF( w01, -h01 );
+                points << p1 << p2 << p3 << p4 << p5 << p6 << p7 << p8;
+                painter->drawPolygon( points );
+                break;
+            }
+        case MarkerAttributes::MarkerX:
+            {
+                const qreal w01 = maSize.width() * 0.1;
+                const qreal w04 = maSize.width() * 0.4;
+                const qreal w05 = maSize.width() * 0.5;
+                const qreal h01 = maSize.height() * 0.1;
+                const qreal h04 = maSize.height() * 0.4;
+                const qreal h05 = maSize.height() * 0.5;
+                QVector <QPointF > crossPoints;
+                QPointF p1 = QPointF( -w04, -h05 );
+                QPointF p2 = QPointF( -w05, -h04 );
+                QPointF p3 = QPointF( -w01,  0 );
+                QPointF p4 = QPointF( -w05,  h04 );
+                QPointF p5 = QPointF( -w04,  h05 );
+                QPointF p6 = QPointF(  0,    h01 );
+                QPointF p7 = QPointF(  w04,  h05 );
+                QPointF p8 = QPointF(  w05,  h04 );
+                QPointF p9 = QPointF(  w01,  0 );
+                QPointF p10 = QPointF( w05, -h04 );
+                QPointF p11 = QPointF( w04, -h05 );
+                QPointF p12 = QPointF( 0,   -h01 );
+                crossPoints << p1 << p2 << p3 << p4 << p5 << p6
+                            << p7 << p8 << p9 << p10 << p11 << p12;
+                painter->drawPolygon( crossPoints );
+                break;
+            }
+        case MarkerAttributes::MarkerAsterisk:
+            {
+                // Note: Markers can have outline,
+                //       so just drawing three lines is NOT the solution here!
+                // The idea that we use is to draw 3 lines anyway, but convert their
+                // outlines to QPainterPaths which are then united and filled.
+                const qreal w04 = maSize.width() * 0.4;
+                const qreal h02 = maSize.height() * 0.2;
+                const qreal h05 = maSize.height() * 0.5;
+                //QVector <QPointF > crossPoints;
+                QPointF p1 = QPointF(    0, -h05 );
+                QPointF p2 = QPointF( -w04, -h02 );
+                QPointF p3 = QPointF( -w04,  h02 );
+                QPointF p4 = QPointF(    0,  h05 );
+                QPointF p5 = QPointF(  w04,  h02 );
+                QPointF p6 = QPointF(  w04, -h02 );
+                QPen pen = painter->pen();
+                QPainterPathStroker stroker;
+                stroker.setWidth( pen.widthF() );
+                stroker.setCapStyle( pen.capStyle() );
+
+                QPainterPath path;
+                QPainterPath dummyPath;
+                dummyPath.moveTo( p1 );
+                dummyPath.lineTo( p4 );
+                path = stroker.createStroke( dummyPath );
+
+                dummyPath = QPainterPath();
+                dummyPath.moveTo( p2 );
+                dummyPath.lineTo( p5 );
+                path = path.united( stroker.createStroke( dummyPath ) );
+
+                dummyPath = QPainterPath();
+                dummyPath.moveTo( p3 );
+                dummyPath.lineTo( p6 );
+                path = path.united( stroker.createStroke( dummyPath ) );
+
+                painter->drawPath( path );
+                break;
+            }
+        case MarkerAttributes::MarkerHorizontalBar:
+            {
+                const qreal w05 = maSize.width() * 0.5;
+                const qreal h02 = maSize.height()* 0.2;
+                QVector <QPointF > points;
+                QPointF p1 = QPointF( -w05, -h02 );
+                QPointF p2 = QPointF( -w05,  h02 );
+                QPointF p3 = QPointF(  w05,  h02 );
+                QPointF p4 = QPointF(  w05, -h02 );
+                points << p1 << p2 << p3 << p4;
+                painter->drawPolygon( points );
+                break;
+            }
+        case MarkerAttributes::MarkerVerticalBar:
+            {
+                const qreal w02 = maSize.width() * 0.2;
+                const qreal h05 = maSize.height()* 0.5;
+                QVector <QPointF > points;
+                QPointF p1 = QPointF( -w02, -h05 );
+                QPointF p2 = QPointF( -w02,  h05 );
+                QPointF p3 = QPointF(  w02,  h05 );
+                QPointF p4 = QPointF(  w02, -h05 );
+                points << p1 << p2 << p3 << p4;
+                painter->drawPolygon( points );
+                break;
+            }
+        case MarkerAttributes::NoMarker:
+            break;
+        case MarkerAttributes::PainterPathMarker:
+            {
+                QPainterPath path = markerAttributes.customMarkerPath();
+                const QRectF pathBoundingRect = path.boundingRect();
+                const qreal xScaling = maSize.height() / pathBoundingRect.height();
+                const qreal yScaling = maSize.width() / pathBoundingRect.width();
+                const qreal scaling = qMin( xScaling, yScaling );
+                painter->scale( scaling, scaling );
+                painter->setPen( PrintingParameters::scalePen( QPen( brush.color() ) ) );
+                painter->drawPath(path);
+                break;
+            }
+        default:
+            Q_ASSERT_X ( false, "paintMarkers()",
+                        "Type item does not match a defined Marker Type." );
     }
-    painter->setPen( oldPen );
 }
 
 void AbstractDiagram::paintMarkers( QPainter* painter )
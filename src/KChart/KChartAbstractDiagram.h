@@ -51,6 +51,22 @@ namespace KChart {
     public:
         ~AbstractDiagram() override;
 
+        /**
+         * Determines when the diagram records the geometry of its data points,
+         * which indexAt(), indexesAt(), indexesIn() and visualRect() rely on.
+         *
+         * \sa setHitTestingPolicy
+         */
+        enum HitTestingPolicy {
+            /// Nothing is recorded; hit testing finds no data points.
+            HitTestingOff,
+            /// Only the positions of the data points are recorded while painting.
+            /// The first query after painting computes the shapes to test from them.
+            HitTestingLazy,
+            /// The geometry is recorded while painting. This is the default.
+            HitTestingEager
+        };
+
 
         /**
          * Returns true if both diagrams have the same settings.
@@ -483,6 +499,25 @@ namespace KChart {
          */
         bool antiAliasing() const;
 
+        /**
+         * Set when the geometry needed for hit testing is recorded.
+         *
+         * Applications that never query the diagram for the data points at a
+         * position, like a service that exports charts as images, can save
+         * painting time and memory by switching hit testing off. Interactive
+         * charts that are only queried occasionally can use HitTestingLazy.
+         *
+         * The policy takes effect the next time the diagram is painted.
+         *
+         * @param policy The policy, HitTestingEager by default.
+         */
+        void setHitTestingPolicy( HitTestingPolicy policy );
+
+        /**
+         * @return When the geometry needed for hit testing is recorded.
+         */
+        HitTestingPolicy hitTestingPolicy() const;
+
         /**
          * Set the palette to be used, for painting datasets to the default
          * palette.
@@ -20,12 +20,18 @@
 #include "KChartAbstractDiagram_p.h"
 
 #include "KChartBarDiagram.h"
+#include "KChartChart_p.h"
 #include "KChartFrameAttributes.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartPaintContext.h"
+#include "KChartRenderTracer_p.h"
 
 #include <QAbstractTextDocumentLayout>
 #include <QTextBlock>
 #include <QApplication>
+#include <QPaintEngine>
+#include <QThread>
+#include <QPainter>
 
 
 using namespace KChart;
@@ -60,6 +66,7 @@ LabelPaintInfo::LabelPaintInfo( const LabelPaintInfo& other )
 AbstractDiagram::Private::Private()
   : diagram( nullptr )
   , doDumpPaintTime( false )
+  , hitTestingPolicy( AbstractDiagram::HitTestingEager )
   , plane( nullptr )
   , attributesModel( new PrivateAttributesModel(nullptr,nullptr) )
   , allowOverlappingDataValueTexts( false )
@@ -68,6 +75,8 @@ AbstractDiagram::Private::Private()
   , datasetDimension( 1 )
   , databoundariesDirty( true )
   , mCachedFontMetrics( QFontMetrics( qApp->font() ) )
+  , mMarkerBatchOpen( false )
+  , mMarkerBatchPainter( nullptr )
 {
 }
 
@@ -142,6 +151,7 @@ void AbstractDiagram::Private::setAttributesModel( AttributesModel* amodel )
 AbstractDiagram::Private::Private( const AbstractDiagram::Private& rhs ) :
     diagram( nullptr ),
     doDumpPaintTime( rhs.doDumpPaintTime ),
+    hitTestingPolicy( rhs.hitTestingPolicy ),
     // Do not copy the plane
     plane( nullptr ),
     attributesModelRootIndex( QModelIndex() ),
@@ -150,7 +160,9 @@ AbstractDiagram::Private::Private( const AbstractDiagram::Private& rhs ) :
     antiAliasing( rhs.antiAliasing ),
     percent( rhs.percent ),
     datasetDimension( rhs.datasetDimension ),
-    mCachedFontMetrics( rhs.cachedFontMetrics() )
+    mCachedFontMetrics( rhs.cachedFontMetrics() ),
+    mMarkerBatchOpen( false ),
+    mMarkerBatchPainter( nullptr )
 {
     attributesModel = new PrivateAttributesModel( nullptr, nullptr);
     attributesModel->initFrom( rhs.attributesModel );
@@ -180,10 +192,10 @@ void AbstractDiagram::Private::addLabel(
 
     QMap<QModelIndex, DataValueAttributes>::const_iterator it;
     for ( it = allAttrs.constBegin(); it != allAttrs.constEnd(); ++it ) {
-        DataValueAttributes dva = it.value();
-        if ( !dva.isVisible() ) {
+        if ( !it.value().isVisible() ) {
             continue;
         }
+        DataValueAttributes dva = it.value();
 
         const bool isPositive = ( value >= 0.0 );
 
@@ -229,18 +241,9 @@ void AbstractDiagram::Private::addLabel(
 
         // get the size of the label text using a subset of the information going into the final layout
         const QString text = formatDataValueText( dva, index, value );
-        QTextDocument doc;
-        doc.setDocumentMargin( 0 );
-        if ( Qt::mightBeRichText( text ) ) {
-            doc.setHtml( text );
-        } else {
-            doc.setPlainText( text );
-        }
         const QFont calculatedFont( dva.textAttributes()
                                     .calculatedFont( plane, KChartEnums::MeasureOrientationMinimum ) );
-        doc.setDefaultFont( calculatedFont );
-
-        const QRectF plainRect = doc.documentLayout()->frameBoundingRect( doc.rootFrame() );
+        const QRectF plainRect = labelLayoutCache()->boundingRect( text, calculatedFont, nullptr );
 
         /*
         * A few hints on how the positioning of the text frame is done:
@@ -339,6 +342,86 @@ const QFontMetrics AbstractDiagram::Private::cachedFontMetrics() const
     return mCachedFontMetrics;
 }
 
+TextLayoutCache* AbstractDiagram::Private::labelLayoutCache()
+{
+    Chart* chart = plane ? plane->parent() : nullptr;
+    return chart ? Chart::Private::get( chart )->labelLayoutCache.data() : &mLabelLayoutCache;
+}
+
+MarkerSpriteCache* AbstractDiagram::Private::markerSpriteCache()
+{
+    Chart* chart = plane ? plane->parent() : nullptr;
+    return chart ? Chart::Private::get( chart )->markerSpriteCache.data() : &mMarkerSpriteCache;
+}
+
+bool AbstractDiagram::Private::paintMarkerSprite( QPainter* painter, const MarkerAttributes& markerAttributes,
+                                                  const QBrush& brush, const QPen& pen,
+                                                  const QPointF& pos, const QSizeF& maSize )
+{
+    // sprites are bitmaps: vector devices like PDF, SVG and printers get the real shapes,
+    // and so does a painter that scales or rotates
+    const QPaintEngine* engine = painter->paintEngine();
+    if ( !engine || ( engine->type() != QPaintEngine::Raster && engine->type() != QPaintEngine::OpenGL2 ) ||
+         painter->combinedTransform().type() > QTransform::TxTranslate ) {
+        return false;
+    }
+    // pixmaps are not to be used outside of the GUI thread
+    if ( QThread::currentThread() != QCoreApplication::instance()->thread() ) {
+        return false;
+    }
+
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    const QPixmap* sprite = markerSpriteCache()->sprite( markerAttributes, brush, PrintingParameters::scalePen( pen ),
+                                                         maSize, devicePixelRatio, &paintMarkerShape );
+    if ( !sprite ) {
+        return false;
+    }
+
+    if ( !mMarkerBatchOpen ) {
+        const QSizeF spriteSize = QSizeF( sprite->size() ) / devicePixelRatio;
+        painter->drawPixmap( pos - QPointF( 0.5 * spriteSize.width(), 0.5 * spriteSize.height() ), *sprite );
+        return true;
+    }
+    if ( painter != mMarkerBatchPainter || painter->worldTransform() != mMarkerBatchTransform ||
+         sprite->cacheKey() != mMarkerBatchSprite.cacheKey() ) {
+        flushMarkerBatch();
+        mMarkerBatchPainter = painter;
+        mMarkerBatchTransform = painter->worldTransform();
+        mMarkerBatchSprite = *sprite;
+    }
+    // fragments are centered at pos and measured in pixels of the sprite
+    mMarkerBatch.append( QPainter::PixmapFragment::create( pos, QRectF( QPointF(), QSizeF( sprite->size() ) ),
+                                                           1.0 / devicePixelRatio, 1.0 / devicePixelRatio ) );
+    return true;
+}
+
+void AbstractDiagram::Private::beginMarkerBatch()
+{
+    Q_ASSERT( !mMarkerBatchOpen );
+    mMarkerBatchOpen = true;
+}
+
+void AbstractDiagram::Private::flushMarkerBatch()
+{
+    if ( !mMarkerBatch.isEmpty() ) {
+        QPainter* const painter = mMarkerBatchPainter;
+        // paint with the transformation the markers were added with, which the caller may have changed since
+        const QTransform transform = painter->worldTransform();
+        painter->setWorldTransform( mMarkerBatchTransform );
+        painter->drawPixmapFragments( mMarkerBatch.constData(), mMarkerBatch.size(), mMarkerBatchSprite );
+        painter->setWorldTransform( transform );
+        mMarkerBatch.clear();
+    }
+}
+
+void AbstractDiagram::Private::endMarkerBatch()
+{
+    flushMarkerBatch();
+    mMarkerBatchOpen = false;
+    mMarkerBatchPainter = nullptr;
+    mMarkerBatchSprite = QPixmap();
+}
+
 QString AbstractDiagram::Private::formatNumber( qreal value, int decimalDigits ) const
 {
     const int digits = qMax(decimalDigits, 0);
@@ -381,10 +464,14 @@ void AbstractDiagram::Private::paintDataValueTextsAndMarkers(
     const PainterSaver painterSaver( ctx->painter() );
     ctx->painter()->setClipping( false );
 
+    const TraceScope scope( justCalculateRect ? "data values layout" : "data values", diagram );
+
     if ( paintMarkers && !justCalculateRect ) {
+        beginMarkerBatch();
         for ( const LabelPaintInfo& info : qAsConst(cache.paintReplay) ) {
             diagram->paintMarker( ctx->painter(), info.index, info.markerPos );
         }
+        endMarkerBatch();
     }
 
     TextAttributes ta;
@@ -457,7 +544,8 @@ void AbstractDiagram::Private::paintDataValueText(
     bool justCalculateRect /* = false */,
     QRectF* cumulatedBoundingRect /* = 0 */ )
 {
-    const DataValueAttributes dva( diagram->dataValueAttributes( index ) );
+    QVariant buffer;
+    const DataValueAttributes& dva = attributes< DataValueAttributes >( index, DataValueLabelAttributesRole, &buffer );
     const QString text = formatDataValueText( dva, index, value );
     paintDataValueText( painter, dva, pos, value >= 0.0, text,
                         justCalculateRect, cumulatedBoundingRect );
@@ -482,26 +570,18 @@ void AbstractDiagram::Private::paintDataValueText(
     }
     prevPaintedDataValueText = text;
 
-    QTextDocument doc;
-    doc.setDocumentMargin( 0.0 );
-    if ( Qt::mightBeRichText( text ) ) {
-        doc.setHtml( text );
-    } else {
-        doc.setPlainText( text );
-    }
-
     const QFont calculatedFont( ta.calculatedFont( plane, KChartEnums::MeasureOrientationMinimum ) );
+    // laid out for the device already, the document stays valid as long as the cache is not used again
+    QTextDocument* const doc = labelLayoutCache()->document( text, calculatedFont, painter->device() );
 
     const PainterSaver painterSaver( painter );
     painter->setPen( PrintingParameters::scalePen( ta.pen() ) );
 
-    doc.setDefaultFont( calculatedFont );
     QAbstractTextDocumentLayout::PaintContext context;
     context.palette = diagram->palette();
     context.palette.setColor( QPalette::Text, ta.pen().color() );
 
-    QAbstractTextDocumentLayout* const layout = doc.documentLayout();
-    layout->setPaintDevice( painter->device() );
+    QAbstractTextDocumentLayout* const layout = doc->documentLayout();
 
     painter->translate( pos.x(), pos.y() );
     int rotation = ta.rotation();
@@ -519,33 +599,26 @@ void AbstractDiagram::Private::paintDataValueText(
     // values that she wants to have written in any case - so we just
     // do not test if such texts would cover some of the others.
     if ( !attrs.showOverlappingDataLabels() ) {
-        const QRectF br( layout->frameBoundingRect( doc.rootFrame() ) );
-        QPolygon pr = transform.mapToPolygon( br.toRect() );
-        // Using QPainterPath allows us to use intersects() (which has many early-exits)
-        // instead of QPolygon::intersected (which calculates a slow and precise intersection polygon)
-        QPainterPath path;
-        path.addPolygon( pr );
-
-        // iterate backwards because recently added items are more likely to overlap, so we spend
-        // less time checking irrelevant items when there is overlap
-        for ( int i = alreadyDrawnDataValueTexts.count() - 1; i >= 0; i-- ) {
-            if ( alreadyDrawnDataValueTexts.at( i ).intersects( path ) ) {
-                // qDebug() << "not painting this label due to overlap";
-                drawIt = false;
-                break;
+        const QRectF br( layout->frameBoundingRect( doc->rootFrame() ) );
+        const QPolygonF area( transform.mapToPolygon( br.toRect() ) );
+        if ( alreadyDrawnDataValueTexts.intersects( area ) ) {
+            // qDebug() << "not painting this label due to overlap";
+            drawIt = false;
+            if ( !justCalculateRect ) {
+                traceCount( "labels culled", diagram );
             }
-        }
-        if ( drawIt ) {
-            alreadyDrawnDataValueTexts << path;
+        } else {
+            alreadyDrawnDataValueTexts.insert( area );
         }
     }
 
     if ( drawIt ) {
-        QRectF rect = layout->frameBoundingRect( doc.rootFrame() );
+        QRectF rect = layout->frameBoundingRect( doc->rootFrame() );
         if ( cumulatedBoundingRect ) {
             (*cumulatedBoundingRect) |= transform.mapRect( rect );
         }
         if ( !justCalculateRect ) {
+            traceCount( "labels drawn", diagram );
             bool paintBack = false;
             BackgroundAttributes back( attrs.backgroundAttributes() );
             if ( back.isVisible() ) {
@@ -592,6 +665,16 @@ QModelIndexList AbstractDiagram::Private::indexesIn( const QRect& rect ) const
     return reverseMapper.indexesIn( rect );
 }
 
+void AbstractDiagram::Private::setUpReverseMapping()
+{
+    reverseMapper.setEnabled( hitTestingPolicy != AbstractDiagram::HitTestingOff );
+    reverseMapper.setDeferred( hitTestingPolicy == AbstractDiagram::HitTestingLazy );
+    if ( hitTestingPolicy == AbstractDiagram::HitTestingOff ) {
+        // drop whatever an earlier policy has recorded
+        reverseMapper.clear();
+    }
+}
+
 CartesianDiagramDataCompressor::AggregatedDataValueAttributes AbstractDiagram::Private::aggregatedAttrs(
     const QModelIndex& index,
     const CartesianDiagramDataCompressor::CachePosition* position ) const
@@ -22,6 +22,7 @@
 
 #include "KChartAbstractDiagram.h"
 #include "KChartAbstractCoordinatePlane.h"
+#include "KChartAttributesModel.h"
 #include "KChartDataValueAttributes.h"
 #include "KChartBackgroundAttributes.h"
 #include "KChartRelativePosition.h"
@@ -30,8 +31,12 @@
 #include "KChartPrintingParameters.h"
 #include "KChartChart.h"
 #include <KChartCartesianDiagramDataCompressor_p.h>
+#include "KChartLabelOverlapIndex_p.h"
+#include "KChartMarkerSpriteCache_p.h"
+#include "KChartTextLayoutCache_p.h"
 #include "ReverseMapper.h"
 
+#include <QHash>
 #include <QMap>
 #include <QPoint>
 #include <QPointer>
@@ -41,6 +46,10 @@
 #include <QPainterPath>
 #include <QModelIndex>
 #include <QPainterPath>
+#include <QPainter>
+#include <QPixmap>
+#include <QTransform>
+#include <QVector>
 
 
 namespace KChart {
@@ -112,6 +121,25 @@ namespace KChart {
         const QFontMetrics* cachedFontMetrics( const QFont& font, const QPaintDevice* paintDevice) const;
         const QFontMetrics cachedFontMetrics() const;
 
+        // laid out data value label texts, shared by all diagrams of the chart
+        TextLayoutCache* labelLayoutCache();
+
+        // paints the marker centered at ( 0, 0 ), with pen and brush already set
+        static void paintMarkerShape( QPainter* painter, const MarkerAttributes& markerAttributes,
+                                      const QBrush& brush, const QSizeF& maSize );
+        // blits the marker from the sprite cache, returns false if the painter or the
+        // marker need the vector shape
+        bool paintMarkerSprite( QPainter* painter, const MarkerAttributes& markerAttributes,
+                                const QBrush& brush, const QPen& pen,
+                                const QPointF& pos, const QSizeF& maSize );
+        // rendered markers, shared by all diagrams of the chart
+        MarkerSpriteCache* markerSpriteCache();
+        // between these, sprites are collected and painted by flushMarkerBatch() in one go,
+        // instead of one at a time. Anything else painted in between has to flush first.
+        void beginMarkerBatch();
+        void flushMarkerBatch();
+        void endMarkerBatch();
+
         QString formatNumber( qreal value, int decimalDigits ) const;
         QString formatDataValueText( const DataValueAttributes &dva,
                                      const QModelIndex& index, qreal value ) const;
@@ -150,6 +178,17 @@ namespace KChart {
 
         QModelIndexList indexesIn( const QRect& rect ) const;
 
+        // the attributes of a role for an index of the source model, or of the attributes model, like
+        // e.g. AbstractDiagram::dataValueAttributes() returns them, but without copying them, see
+        // AttributesModel::attributes()
+        template< typename T >
+        const T& attributes( const QModelIndex& index, int role, QVariant* buffer ) const
+        {
+            const QModelIndex attributesIndex = index.model() == attributesModel.data() ? index
+                                                : attributesModel->mapFromSource( index );
+            return attributesModel->attributes< T >( attributesIndex, role, buffer );
+        }
+
         virtual CartesianDiagramDataCompressor::AggregatedDataValueAttributes aggregatedAttrs(
                 const QModelIndex & index,
                 const CartesianDiagramDataCompressor::CachePosition * position ) const;
@@ -177,11 +216,21 @@ namespace KChart {
 
         static Private* get( AbstractDiagram *diagram ) { return diagram->_d; }
 
+        /**
+         * Prepares the reverse mapper for painting the diagram, according to the
+         * hit testing policy. Called by the coordinate planes.
+         */
+        void setUpReverseMapping();
+
         AbstractDiagram* diagram;
         ReverseMapper reverseMapper;
         /// The size of the diagram set by AbstractDiagram::resize()
         QSizeF diagramSize;
         bool doDumpPaintTime; // for use in performance testing code
+        AbstractDiagram::HitTestingPolicy hitTestingPolicy;
+        /// Whether the model has its own attributes in some cell of a column, see
+        /// PaintingHelpers. Cleared by AbstractDiagram::setDataBoundariesDirty().
+        mutable QHash< int, bool > sourceCellAttributes;
 
     protected:
         void init();
@@ -201,13 +250,22 @@ namespace KChart {
         QMap< Qt::Orientation, QString > unitPrefix;
         QMap< int, QMap< Qt::Orientation, QString > > unitSuffixMap;
         QMap< int, QMap< Qt::Orientation, QString > > unitPrefixMap;
-        QList< QPainterPath > alreadyDrawnDataValueTexts;
+        LabelOverlapIndex alreadyDrawnDataValueTexts;
 
     private:
         QString prevPaintedDataValueText;
         mutable QFontMetrics mCachedFontMetrics;
         mutable QFont mCachedFont;
         mutable QPaintDevice* mCachedPaintDevice;
+        // used as long as the diagram is not part of a chart
+        TextLayoutCache mLabelLayoutCache;
+        MarkerSpriteCache mMarkerSpriteCache;
+        // see beginMarkerBatch()
+        bool mMarkerBatchOpen;
+        QPainter* mMarkerBatchPainter;
+        QTransform mMarkerBatchTransform;
+        QPixmap mMarkerBatchSprite;
+        QVector< QPainter::PixmapFragment > mMarkerBatch;
     };
 
     inline AbstractDiagram::AbstractDiagram( Private * p ) : _d( p )
@@ -10,6 +10,7 @@
 #include "KChartPaintContext.h"
 
 #include "KChartMath_p.h"
+#include "KChartRenderTracer_p.h"
 
 #include <qglobal.h>
 
@@ -49,6 +50,7 @@ DataDimensionsList AbstractGrid::updateData( AbstractCoordinatePlane* plane )
         if ( mCachedRawDataDimensions.empty() || ( rawDataDimensions != mCachedRawDataDimensions ) ) {
             mCachedRawDataDimensions = rawDataDimensions;
             mPlane = plane;
+            const TraceScope scope( "grid", plane );
             mDataDimensions = calculateGrid( rawDataDimensions );
         }
     }
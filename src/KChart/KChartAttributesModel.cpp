@@ -12,6 +12,7 @@
 #include "KChartMath_p.h"
 
 #include <QDebug>
+#include <QHash>
 #include <QPen>
 #include <QPointer>
 
@@ -35,28 +36,81 @@
 using namespace KChart;
 
 
+// The attributes roles are consecutive, see KChart::DisplayRoles, so the attributes of a level
+// (global, dataset, cell) are kept in a table with one entry per role. Values are only looked
+// up in the sparse per cell storage if the column has any for the role.
 class Q_DECL_HIDDEN AttributesModel::Private
 {
 public:
     Private();
 
-    QMap< int, QMap< int, QMap< int, QVariant > > > dataMap;
-    QMap< int, QMap< int, QVariant > > horizontalHeaderDataMap;
+    enum { RoleCount = ValueTrackerAttributesRole - DatasetPenRole + 1 };
+    static int roleSlot( int role ) { return role - DatasetPenRole; }
+    // one value per attributes role, invalid if not set
+    typedef QVector< QVariant > RoleTable;
+
+    class ColumnData {
+    public:
+        ColumnData()
+            : attributes( RoleCount ),
+              cellCounts( RoleCount, 0 )
+              {}
+        RoleTable attributes; // set for the whole column, i.e. the horizontal header section
+        QHash< int, RoleTable > cells; // set for single cells, by row
+        QVector< int > cellCounts; // number of cells with a valid value, by role slot
+    };
+
+    const ColumnData* columnData( int column ) const
+    {
+        return column >= 0 && column < columns.size() ? &columns.at( column ) : nullptr;
+    }
+    ColumnData& columnData( int column )
+    {
+        Q_ASSERT( column >= 0 );
+        if ( column >= columns.size() ) {
+            columns.resize( column + 1 );
+        }
+        return columns[ column ];
+    }
+
+    QVector< ColumnData > columns;
     QMap< int, QMap< int, QVariant > > verticalHeaderDataMap;
-    QMap< int, QVariant > modelDataMap;
-    QMap< int, QVariant > defaultsMap;
+    RoleTable modelData;
+    QMap< int, QVariant > otherModelData; // roles that are not attributes roles
+    RoleTable defaults;
+    quint64 generation;
     int dataDimension;
     AttributesModel::PaletteType paletteType;
     Palette palette;
 };
 
 AttributesModel::Private::Private()
-  : dataDimension( 1 ),
+  : modelData( RoleCount ),
+    defaults( RoleCount ),
+    generation( 0 ),
+    dataDimension( 1 ),
     paletteType( AttributesModel::PaletteTypeDefault ),
     palette( Palette::defaultPalette() )
 {
 }
 
+static bool compareRoleTables( const AttributesModel* model, const QVector< QVariant >& tableA,
+                               const QVector< QVariant >& tableB )
+{
+    Q_ASSERT( tableA.size() == tableB.size() );
+    for ( int i = 0; i < tableA.size(); ++i ) {
+        const QVariant& a = tableA.at( i );
+        const QVariant& b = tableB.at( i );
+        if ( a.isValid() != b.isValid() ) {
+            return false;
+        }
+        if ( a.isValid() && !model->compareAttributes( DatasetPenRole + i, a, b ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
 #define d d_func()
 
 AttributesModel::AttributesModel( QAbstractItemModel* model, QObject * parent/* = 0 */ )
@@ -76,7 +130,9 @@ AttributesModel::~AttributesModel()
 
 void AttributesModel::initFrom( const AttributesModel* other )
 {
+    const quint64 generation = d->generation;
     *d = *other->d;
+    d->generation = generation + 1;
 }
 
 bool AttributesModel::compareHeaderDataMaps( const QMap< int, QMap< int, QVariant > >& mapA,
@@ -114,48 +170,42 @@ bool AttributesModel::compare( const AttributesModel* other ) const
         return false;
     }
 
-    {
-        if ( d->dataMap.count() != other->d->dataMap.count() ) {
+    const Private::ColumnData noColumn;
+    const int columnCount = qMax( d->columns.size(), other->d->columns.size() );
+    for ( int column = 0; column < columnCount; ++column ) {
+        const Private::ColumnData* columnA = d->columnData( column );
+        const Private::ColumnData* columnB = other->d->columnData( column );
+        const Private::ColumnData& a = columnA ? *columnA : noColumn;
+        const Private::ColumnData& b = columnB ? *columnB : noColumn;
+        if ( !compareRoleTables( this, a.attributes, b.attributes ) ) {
             return false;
         }
-        QMap< int, QMap< int, QMap<int, QVariant > > >::const_iterator itA = d->dataMap.constBegin();
-        QMap< int, QMap< int, QMap<int, QVariant > > >::const_iterator itB = other->d->dataMap.constBegin();
-        for ( ; itA != d->dataMap.constEnd(); ++itA, ++itB ) {
-            if ( itA->count() != itB->count() ) {
+        for ( QHash< int, Private::RoleTable >::const_iterator it = a.cells.constBegin(); it != a.cells.constEnd(); ++it ) {
+            if ( !compareRoleTables( this, it.value(), b.cells.value( it.key(), noColumn.attributes ) ) ) {
                 return false;
             }
-            QMap< int, QMap< int, QVariant > >::const_iterator it2A = itA->constBegin();
-            QMap< int, QMap< int, QVariant > >::const_iterator it2B = itB->constBegin();
-            for ( ; it2A != itA->constEnd(); ++it2A, ++it2B ) {
-                if ( it2A->count() != it2B->count() ) {
-                    return false;
-                }
-                QMap< int, QVariant >::const_iterator it3A = it2A->constBegin();
-                QMap< int, QVariant >::const_iterator it3B = it2B->constBegin();
-                for ( ; it3A != it2A->constEnd(); ++it3A, ++it3B ) {
-                    if ( it3A.key() != it3B.key() ) {
-                        return false;
-                    }
-                    if ( !compareAttributes( it3A.key(), it3A.value(), it3B.value() ) ) {
-                        return false;
-                    }
-                }
+        }
+        for ( QHash< int, Private::RoleTable >::const_iterator it = b.cells.constBegin(); it != b.cells.constEnd(); ++it ) {
+            if ( !a.cells.contains( it.key() ) && !compareRoleTables( this, noColumn.attributes, it.value() ) ) {
+                return false;
             }
         }
     }
 
-    if ( !compareHeaderDataMaps( d->horizontalHeaderDataMap, other->d->horizontalHeaderDataMap ) ||
-         !compareHeaderDataMaps( d->verticalHeaderDataMap, other->d->verticalHeaderDataMap ) ) {
+    if ( !compareHeaderDataMaps( d->verticalHeaderDataMap, other->d->verticalHeaderDataMap ) ) {
         return false;
     }
 
+    if ( !compareRoleTables( this, d->modelData, other->d->modelData ) ) {
+        return false;
+    }
     {
-        if ( d->modelDataMap.count() != other->d->modelDataMap.count() ) {
+        if ( d->otherModelData.count() != other->d->otherModelData.count() ) {
             return false;
         }
-        QMap< int, QVariant >::const_iterator itA = d->modelDataMap.constBegin();
-        QMap< int, QVariant >::const_iterator itB = other->d->modelDataMap.constBegin();
-        for ( ; itA != d->modelDataMap.constEnd(); ++itA, ++itB ) {
+        QMap< int, QVariant >::const_iterator itA = d->otherModelData.constBegin();
+        QMap< int, QVariant >::const_iterator itB = other->d->otherModelData.constBegin();
+        for ( ; itA != d->otherModelData.constEnd(); ++itA, ++itB ) {
             if ( itA.key() != itB.key() ) {
                 return false;
             }
@@ -240,14 +290,23 @@ QVariant AttributesModel::headerData( int section, Qt::Orientation orientation,
     }
 
     // the source model didn't have data set, let's use our stored values
-    const QMap< int, QMap< int, QVariant> >& map = orientation == Qt::Horizontal ?
-                                                   d->horizontalHeaderDataMap : d->verticalHeaderDataMap;
-    QMap< int, QMap< int, QVariant > >::const_iterator mapIt = map.find( section );
-    if ( mapIt != map.constEnd() ) {
-        const QMap< int, QVariant >& dataMap = mapIt.value();
-        QMap< int, QVariant >::const_iterator dataMapIt = dataMap.find( role );
-        if ( dataMapIt != dataMap.constEnd() ) {
-            return dataMapIt.value();
+    if ( orientation == Qt::Horizontal ) {
+        if ( isKnownAttributesRole( role ) ) {
+            if ( const Private::ColumnData* column = d->columnData( section ) ) {
+                const QVariant& v = column->attributes.at( Private::roleSlot( role ) );
+                if ( v.isValid() ) {
+                    return v;
+                }
+            }
+        }
+    } else {
+        QMap< int, QMap< int, QVariant > >::const_iterator mapIt = d->verticalHeaderDataMap.find( section );
+        if ( mapIt != d->verticalHeaderDataMap.constEnd() ) {
+            const QMap< int, QVariant >& dataMap = mapIt.value();
+            QMap< int, QVariant >::const_iterator dataMapIt = dataMap.find( role );
+            if ( dataMapIt != dataMap.constEnd() ) {
+                return dataMapIt.value();
+            }
         }
     }
 
@@ -329,15 +388,13 @@ QVariant AttributesModel::data( const QModelIndex& index, int role ) const
     }
 
     // check if we are storing a value for this role at this cell index
-    if ( d->dataMap.contains( index.column() ) ) {
-        const QMap< int,  QMap< int, QVariant > >& colDataMap = d->dataMap[ index.column() ];
-        if ( colDataMap.contains( index.row() ) ) {
-            const QMap< int, QVariant >& dataMap = colDataMap[ index.row() ];
-            if ( dataMap.contains( role ) ) {
-                const QVariant v = dataMap[ role ];
-                if ( v.isValid() ) {
-                    return v;
-                }
+    if ( index.isValid() && isKnownAttributesRole( role ) ) {
+        const int slot = Private::roleSlot( role );
+        const Private::ColumnData* column = d->columnData( index.column() );
+        if ( column && column->cellCounts.at( slot ) > 0 ) {
+            QHash< int, Private::RoleTable >::const_iterator it = column->cells.constFind( index.row() );
+            if ( it != column->cells.constEnd() && it->at( slot ).isValid() ) {
+                return it->at( slot );
             }
         }
     }
@@ -376,7 +433,7 @@ bool AttributesModel::isKnownAttributesRole( int role ) const
 QVariant AttributesModel::defaultsForRole( int role ) const
 {
     // returns default-constructed QVariant if not found
-    return d->defaultsMap.value( role );
+    return isKnownAttributesRole( role ) ? d->defaults.at( Private::roleSlot( role ) ) : QVariant();
 }
 
 bool AttributesModel::setData ( const QModelIndex & index, const QVariant & value, int role )
@@ -384,9 +441,22 @@ bool AttributesModel::setData ( const QModelIndex & index, const QVariant & valu
     if ( !isKnownAttributesRole( role ) ) {
         return sourceModel()->setData( mapToSource(index), value, role );
     } else {
-        QMap< int,  QMap< int, QVariant> > &colDataMap = d->dataMap[ index.column() ];
-        QMap< int, QVariant > &dataMap = colDataMap[ index.row() ];
-        dataMap.insert( role, value );
+        if ( !index.isValid() ) {
+            return false;
+        }
+        const int slot = Private::roleSlot( role );
+        Private::ColumnData& column = d->columnData( index.column() );
+        QHash< int, Private::RoleTable >::iterator it = column.cells.find( index.row() );
+        if ( it == column.cells.end() ) {
+            if ( !value.isValid() ) {
+                return true; // nothing to reset
+            }
+            it = column.cells.insert( index.row(), Private::RoleTable( Private::RoleCount ) );
+        }
+        QVariant& cellValue = ( *it )[ slot ];
+        column.cellCounts[ slot ] += int( value.isValid() ) - int( cellValue.isValid() );
+        cellValue = value;
+        ++d->generation;
         Q_EMIT attributesChanged( index, index );
         return true;
     }
@@ -397,6 +467,64 @@ bool AttributesModel::resetData ( const QModelIndex & index, int role )
     return setData( index, QVariant(), role );
 }
 
+const QVariant& AttributesModel::attributesData( const QModelIndex& index, int role, QVariant* buffer ) const
+{
+    Q_ASSERT( buffer );
+    if ( !sourceModel() || !index.isValid() || !isKnownAttributesRole( role ) ) {
+        *buffer = data( index, role );
+        return *buffer;
+    }
+    Q_ASSERT( index.model() == this );
+
+    // the same order of precedence as in data( const QModelIndex&, int ), without copies
+    *buffer = sourceModel()->data( mapToSource( index ), role );
+    if ( buffer->isValid() ) {
+        return *buffer;
+    }
+
+    const int slot = Private::roleSlot( role );
+    const Private::ColumnData* column = d->columnData( index.column() );
+    if ( column && column->cellCounts.at( slot ) > 0 ) {
+        QHash< int, Private::RoleTable >::const_iterator it = column->cells.constFind( index.row() );
+        if ( it != column->cells.constEnd() && it->at( slot ).isValid() ) {
+            return it->at( slot );
+        }
+    }
+
+    // the dataset, see headerData()
+    *buffer = sourceModel()->headerData( index.column(), Qt::Horizontal, role );
+    if ( buffer->isValid() ) {
+        return *buffer;
+    }
+    if ( column && column->attributes.at( slot ).isValid() ) {
+        return column->attributes.at( slot );
+    }
+    *buffer = defaultHeaderData( index.column(), Qt::Horizontal, role );
+    if ( buffer->isValid() ) {
+        return *buffer;
+    }
+
+    // the global level, see data( int )
+    if ( d->modelData.at( slot ).isValid() ) {
+        return d->modelData.at( slot );
+    }
+    return d->defaults.at( slot );
+}
+
+quint64 AttributesModel::attributesGeneration() const
+{
+    return d->generation;
+}
+
+bool AttributesModel::hasCellOverrides( int column, int role ) const
+{
+    if ( !isKnownAttributesRole( role ) ) {
+        return false;
+    }
+    const Private::ColumnData* columnData = d->columnData( column );
+    return columnData && columnData->cellCounts.at( Private::roleSlot( role ) ) > 0;
+}
+
 bool AttributesModel::setHeaderData ( int section, Qt::Orientation orientation,
                                       const QVariant & value, int role )
 {
@@ -407,11 +535,15 @@ bool AttributesModel::setHeaderData ( int section, Qt::Orientation orientation,
     if ( !isKnownAttributesRole( role ) ) {
         return sourceModel()->setHeaderData( section, orientation, value, role );
     } else {
-        QMap< int,  QMap<int, QVariant > > &sectionDataMap
-            = orientation == Qt::Horizontal ? d->horizontalHeaderDataMap : d->verticalHeaderDataMap;
-
-        QMap< int, QVariant > &dataMap = sectionDataMap[ section ];
-        dataMap.insert( role, value );
+        if ( orientation == Qt::Horizontal ) {
+            if ( section < 0 ) {
+                return false;
+            }
+            d->columnData( section ).attributes[ Private::roleSlot( role ) ] = value;
+        } else {
+            d->verticalHeaderDataMap[ section ].insert( role, value );
+        }
+        ++d->generation;
         if ( sourceModel() ) {
             int numRows = rowCount( QModelIndex() );
             int numCols = columnCount( QModelIndex() );
@@ -444,6 +576,7 @@ void AttributesModel::setPaletteType( AttributesModel::PaletteType type )
         return;
     }
     d->paletteType = type;
+    ++d->generation;
     switch ( type ) {
     case PaletteTypeDefault:
         d->palette = Palette::defaultPalette();
@@ -466,7 +599,12 @@ AttributesModel::PaletteType AttributesModel::paletteType() const
 
 bool KChart::AttributesModel::setModelData( const QVariant value, int role )
 {
-    d->modelDataMap.insert( role, value );
+    if ( isKnownAttributesRole( role ) ) {
+        d->modelData[ Private::roleSlot( role ) ] = value;
+    } else {
+        d->otherModelData.insert( role, value );
+    }
+    ++d->generation;
     int numRows = rowCount( QModelIndex() );
     int numCols = columnCount( QModelIndex() );
     if ( sourceModel() && numRows > 0 && numCols > 0 ) {
@@ -480,7 +618,10 @@ bool KChart::AttributesModel::setModelData( const QVariant value, int role )
 
 QVariant KChart::AttributesModel::modelData( int role ) const
 {
-    return d->modelDataMap.value( role, QVariant() );
+    if ( isKnownAttributesRole( role ) ) {
+        return d->modelData.at( Private::roleSlot( role ) );
+    }
+    return d->otherModelData.value( role, QVariant() );
 }
 
 int AttributesModel::rowCount( const QModelIndex& index ) const
@@ -602,31 +743,18 @@ void AttributesModel::slotRowsRemoved( const QModelIndex& parent, int start, int
 
 void AttributesModel::removeEntriesFromDataMap( int start, int end )
 {
-    QMap< int, QMap< int, QMap< int, QVariant > > >::iterator it = d->dataMap.find( end );
-    // check that the element was found
-    if ( it != d->dataMap.end() ) {
-        ++it;
-        QVector< int > indexesToDel;
-        for ( int i = start; i < end && it != d->dataMap.end(); ++i ) {
-            d->dataMap[ i ] = it.value();
-            indexesToDel << it.key();
-            ++it;
-        }
-        if ( indexesToDel.isEmpty() ) {
-            for ( int i = start; i < end; ++i ) {
-                indexesToDel << i;
-            }
-        }
-        for ( int i  = 0; i < indexesToDel.count(); ++i ) {
-            d->dataMap.remove( indexesToDel[ i ] );
-        }
+    // the columns after the removed ones move up
+    if ( start < d->columns.size() ) {
+        d->columns.remove( start, qMin( end + 1, d->columns.size() ) - start );
     }
+    ++d->generation;
 }
 
 void AttributesModel::removeEntriesFromDirectionDataMaps( Qt::Orientation dir, int start, int end )
 {
-    QMap<int,  QMap<int, QVariant> > &sectionDataMap
-        = dir == Qt::Horizontal ? d->horizontalHeaderDataMap : d->verticalHeaderDataMap;
+    Q_ASSERT( dir == Qt::Vertical ); // the horizontal sections are removed along with the columns
+    Q_UNUSED( dir );
+    QMap<int,  QMap<int, QVariant> > &sectionDataMap = d->verticalHeaderDataMap;
     QMap<int, QMap<int, QVariant> >::iterator it = sectionDataMap.upperBound( end );
     // check that the element was found
     if ( it != sectionDataMap.end() )
@@ -662,7 +790,6 @@ void AttributesModel::slotColumnsRemoved( const QModelIndex& parent, int start,
         d->verticalHeaderDataMap.remove( start );
     }
     removeEntriesFromDataMap( start, end );
-    removeEntriesFromDirectionDataMaps( Qt::Horizontal, start, end );
     removeEntriesFromDirectionDataMaps( Qt::Vertical, start, end );
 
     endRemoveColumns();
@@ -675,14 +802,10 @@ void AttributesModel::slotDataChanged( const QModelIndex& topLeft, const QModelI
 
 void AttributesModel::setDefaultForRole( int role, const QVariant& value )
 {
-    if ( value.isValid() ) {
-        d->defaultsMap.insert( role, value );
-    } else {
-        // erase the possibly existing value to not let the map grow:
-        QMap<int, QVariant>::iterator it = d->defaultsMap.find( role );
-        if ( it != d->defaultsMap.end() ) {
-            d->defaultsMap.erase( it );
-        }
+    // defaults are only ever used for attributes roles, see data( int role )
+    if ( isKnownAttributesRole( role ) ) {
+        d->defaults[ Private::roleSlot( role ) ] = value;
+        ++d->generation;
     }
 
     Q_ASSERT( defaultsForRole( role ).value<KChart::DataValueAttributes>()  == value.value<KChart::DataValueAttributes>() );
@@ -89,6 +89,43 @@ public:
     bool setData ( const QModelIndex & index, const QVariant & value, int role = Qt::DisplayRole) override;
     /** Remove any explicit attributes settings that might have been specified before. */
     bool resetData ( const QModelIndex & index, int role = Qt::DisplayRole);
+    /**
+     * Returns the value of the attributes @p role for @p index, just like data() does, but
+     * without copying it where possible.
+     *
+     * The returned reference points to the value stored in this model, or to @p buffer if the
+     * value comes from the source model or has to be computed. It stays valid until
+     * attributesGeneration() changes or @p buffer is used again.
+     */
+    const QVariant& attributesData( const QModelIndex& index, int role, QVariant* buffer ) const;
+
+    /**
+     * Typed version of attributesData(), for use in paint code, e.g.
+     * \code
+     * QVariant buffer;
+     * const LineAttributes& la = model->attributes< LineAttributes >( index, LineAttributesRole, &buffer );
+     * \endcode
+     */
+    template< typename T >
+    const T& attributes( const QModelIndex& index, int role, QVariant* buffer ) const
+    {
+        const QVariant& v = attributesData( index, role, buffer );
+        if ( v.userType() == qMetaTypeId< T >() ) {
+            return *static_cast< const T* >( v.constData() );
+        }
+        // not set or of a different type: convert, like QVariant::value() does
+        *buffer = QVariant::fromValue( v.value< T >() );
+        return *static_cast< const T* >( buffer->constData() );
+    }
+
+    /** Returns a counter that changes whenever attributes stored in this model change,
+        which invalidates the references returned by attributesData(). */
+    quint64 attributesGeneration() const;
+
+    /** Returns whether a value for @p role has been set on any single cell of @p column.
+        If not, data() returns the same value for all cells of the column, unless the
+        source model provides one itself. */
+    bool hasCellOverrides( int column, int role ) const;
     /** \reimpl */
     bool setHeaderData ( int section, Qt::Orientation orientation, const QVariant & value,
                          int role = Qt::DisplayRole) override;
@@ -0,0 +1,355 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KChartBatchExporter.h"
+
+#include <QAbstractItemModel>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QImageWriter>
+#include <QList>
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QPointer>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QSvgGenerator>
+#include <QThreadPool>
+
+#include <algorithm>
+
+#include "KChartAbstractCoordinatePlane.h"
+#include "KChartAbstractDiagram.h"
+#include "KChartChart.h"
+#include "KChartChart_p.h"
+#include "KChartMarkerSpriteCache_p.h"
+#include "KChartTextLayoutCache_p.h"
+
+
+using namespace KChart;
+
+namespace {
+// an image handed to the thread pool for encoding
+class EncodeTask
+{
+public:
+    EncodeTask()
+        : index( -1 )
+        , quality( -1 )
+        , encodeNanoseconds( 0 )
+    {}
+
+    int index;
+    QImage image;
+    QByteArray format;
+    int quality;
+
+    // results, valid after done has been released
+    QByteArray data;
+    QString errorString;
+    qint64 encodeNanoseconds;
+    QSemaphore done;
+};
+}
+
+static void encodeImage( EncodeTask* task )
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QBuffer buffer( &task->data );
+    buffer.open( QIODevice::WriteOnly );
+    QImageWriter writer( &buffer, task->format );
+    writer.setQuality( task->quality );
+    if ( !writer.write( task->image ) ) {
+        task->errorString = writer.errorString();
+    }
+    // the image is not needed anymore, don't keep it until the task is collected
+    task->image = QImage();
+
+    task->encodeNanoseconds = timer.nsecsElapsed();
+}
+
+class Q_DECL_HIDDEN BatchExporter::Private
+{
+public:
+    Private()
+        : labelLayoutCache( new TextLayoutCache )
+        , markerSpriteCache( new MarkerSpriteCache )
+    {}
+
+    // what prepareChart() changes on a chart, to be set back by restoreCharts()
+    class ChartState {
+    public:
+        QPointer< Chart > chart;
+        QSharedPointer< TextLayoutCache > labelLayoutCache;
+        QSharedPointer< MarkerSpriteCache > markerSpriteCache;
+        QVector< QPair< QPointer< AbstractDiagram >, QPointer< QAbstractItemModel > > > models;
+    };
+
+    void prepareChart( const Job& job );
+    void restoreCharts();
+    bool paintVector( const Job& job, Result* result );
+    QImage paintImage( const Job& job );
+
+    QThreadPool threadPool;
+    QSharedPointer< TextLayoutCache > labelLayoutCache;
+    QSharedPointer< MarkerSpriteCache > markerSpriteCache;
+    // the original state of the charts of the running exportCharts() call
+    QVector< ChartState > chartStates;
+};
+
+static qreal dotsPerInch( const BatchExporter::Job& job )
+{
+    return job.dotsPerInch > 0.0 ? job.dotsPerInch : qreal( job.chart->logicalDpiX() );
+}
+
+void BatchExporter::Private::prepareChart( const Job& job )
+{
+    // remember the original state once, jobs sharing a chart only differ in the model
+    auto saved = std::find_if( chartStates.cbegin(), chartStates.cend(), [ &job ]( const ChartState& state ) {
+        return state.chart == job.chart;
+    } );
+    Chart::Private* chartPrivate = Chart::Private::get( job.chart );
+    if ( saved == chartStates.cend() ) {
+        ChartState state;
+        state.chart = job.chart;
+        state.labelLayoutCache = chartPrivate->labelLayoutCache;
+        state.markerSpriteCache = chartPrivate->markerSpriteCache;
+        const CoordinatePlaneList planes = job.chart->coordinatePlanes();
+        for ( AbstractCoordinatePlane* plane : planes ) {
+            const AbstractDiagramList diagrams = plane->diagrams();
+            for ( AbstractDiagram* diagram : diagrams ) {
+                state.models.append( qMakePair( QPointer< AbstractDiagram >( diagram ),
+                                                QPointer< QAbstractItemModel >( diagram->model() ) ) );
+            }
+        }
+        chartStates.append( state );
+    }
+    chartPrivate->labelLayoutCache = labelLayoutCache;
+    chartPrivate->markerSpriteCache = markerSpriteCache;
+
+    if ( job.model ) {
+        const CoordinatePlaneList planes = job.chart->coordinatePlanes();
+        for ( AbstractCoordinatePlane* plane : planes ) {
+            const AbstractDiagramList diagrams = plane->diagrams();
+            for ( AbstractDiagram* diagram : diagrams ) {
+                if ( diagram->model() != job.model ) {
+                    diagram->setModel( job.model );
+                }
+            }
+        }
+    }
+}
+
+void BatchExporter::Private::restoreCharts()
+{
+    for ( const ChartState& state : qAsConst( chartStates ) ) {
+        if ( !state.chart ) {
+            continue;
+        }
+        Chart::Private* chartPrivate = Chart::Private::get( state.chart );
+        chartPrivate->labelLayoutCache = state.labelLayoutCache;
+        chartPrivate->markerSpriteCache = state.markerSpriteCache;
+        for ( const auto& model : state.models ) {
+            if ( model.first && model.first->model() != model.second ) {
+                model.first->setModel( model.second );
+            }
+        }
+    }
+    chartStates.clear();
+}
+
+bool BatchExporter::Private::paintVector( const Job& job, Result* result )
+{
+    const qreal resolution = dotsPerInch( job );
+    QPainter painter;
+    if ( job.format == Svg ) {
+        QSvgGenerator generator;
+        generator.setOutputDevice( job.device );
+        generator.setSize( job.size );
+        generator.setViewBox( QRect( QPoint( 0, 0 ), job.size ) );
+        generator.setResolution( qRound( resolution ) );
+        if ( !painter.begin( &generator ) ) {
+            result->errorString = BatchExporter::tr( "Could not write SVG output" );
+            return false;
+        }
+        job.chart->paint( &painter, QRect( QPoint( 0, 0 ), job.size ) );
+        painter.end();
+    } else {
+        QPdfWriter writer( job.device );
+        writer.setResolution( qRound( resolution ) );
+        writer.setPageSize( QPageSize( QSizeF( job.size ) * 72.0 / resolution, QPageSize::Point ) );
+        writer.setPageMargins( QMarginsF( 0.0, 0.0, 0.0, 0.0 ), QPageLayout::Point );
+        if ( !painter.begin( &writer ) ) {
+            result->errorString = BatchExporter::tr( "Could not write PDF output" );
+            return false;
+        }
+        job.chart->paint( &painter, QRect( 0, 0, writer.width(), writer.height() ) );
+        painter.end();
+    }
+    return true;
+}
+
+QImage BatchExporter::Private::paintImage( const Job& job )
+{
+    const int dotsPerMeter = qRound( dotsPerInch( job ) / 0.0254 );
+    QImage image( job.size, QImage::Format_ARGB32_Premultiplied );
+    image.setDotsPerMeterX( dotsPerMeter );
+    image.setDotsPerMeterY( dotsPerMeter );
+    // JPEG has no alpha channel, transparent pixels would come out black
+    image.fill( job.format == Jpeg ? Qt::white : Qt::transparent );
+
+    QPainter painter( &image );
+    painter.setRenderHint( QPainter::Antialiasing );
+    job.chart->paint( &painter, QRect( QPoint( 0, 0 ), job.size ) );
+    painter.end();
+    return image;
+}
+
+#define d d_func()
+
+BatchExporter::Job::Job()
+    : chart( nullptr )
+    , model( nullptr )
+    , format( Png )
+    , dotsPerInch( 0.0 )
+    , quality( -1 )
+    , device( nullptr )
+{
+}
+
+BatchExporter::Job::Job( Chart* chart_, const QSize& size_, Format format_, QIODevice* device_ )
+    : chart( chart_ )
+    , model( nullptr )
+    , size( size_ )
+    , format( format_ )
+    , dotsPerInch( 0.0 )
+    , quality( -1 )
+    , device( device_ )
+{
+}
+
+BatchExporter::Result::Result()
+    : success( false )
+    , renderNanoseconds( 0 )
+    , encodeNanoseconds( 0 )
+{
+}
+
+BatchExporter::BatchExporter( QObject* parent )
+    : QObject( parent )
+    , _d( new Private )
+{
+}
+
+BatchExporter::~BatchExporter()
+{
+    delete _d;
+}
+
+void BatchExporter::setMaxThreadCount( int count )
+{
+    d->threadPool.setMaxThreadCount( qMax( 1, count ) );
+}
+
+int BatchExporter::maxThreadCount() const
+{
+    return d->threadPool.maxThreadCount();
+}
+
+void BatchExporter::clearCaches()
+{
+    d->labelLayoutCache->clear();
+    d->markerSpriteCache->clear();
+}
+
+QVector< BatchExporter::Result > BatchExporter::exportCharts( const QVector< Job >& jobs )
+{
+    QVector< Result > results( jobs.size() );
+    QList< QSharedPointer< EncodeTask > > pending;
+    // bounds the memory taken by rendered images waiting for a thread
+    const int maxPending = 2 * qMax( 1, d->threadPool.maxThreadCount() );
+
+    // the devices opened here are closed again once their output has been written
+    QVector< bool > openedDevices( jobs.size(), false );
+    auto finishDevice = [ &jobs, &openedDevices ]( int index ) {
+        if ( openedDevices.at( index ) ) {
+            jobs.at( index ).device->close();
+        }
+    };
+
+    auto collect = [ this, &jobs, &results, &finishDevice ]( const QSharedPointer< EncodeTask >& task ) {
+        task->done.acquire();
+        Result& result = results[ task->index ];
+        result.encodeNanoseconds = task->encodeNanoseconds;
+        QIODevice* device = jobs.at( task->index ).device;
+        if ( !task->errorString.isEmpty() ) {
+            result.errorString = task->errorString;
+        } else if ( device->write( task->data ) != task->data.size() ) {
+            result.errorString = device->errorString();
+        } else {
+            result.success = true;
+        }
+        finishDevice( task->index );
+        Q_EMIT jobFinished( task->index, result );
+    };
+
+    for ( int i = 0; i < jobs.size(); ++i ) {
+        const Job& job = jobs.at( i );
+        Result& result = results[ i ];
+        if ( !job.chart || !job.device || job.size.isEmpty() ) {
+            result.errorString = tr( "Invalid export job" );
+            Q_EMIT jobFinished( i, result );
+            continue;
+        }
+        if ( !job.device->isOpen() ) {
+            if ( !job.device->open( QIODevice::WriteOnly ) ) {
+                result.errorString = job.device->errorString();
+                Q_EMIT jobFinished( i, result );
+                continue;
+            }
+            openedDevices[ i ] = true;
+        }
+
+        d->prepareChart( job );
+        QElapsedTimer timer;
+        timer.start();
+
+        if ( job.format == Svg || job.format == Pdf ) {
+            result.success = d->paintVector( job, &result );
+            result.renderNanoseconds = timer.nsecsElapsed();
+            finishDevice( i );
+            Q_EMIT jobFinished( i, result );
+            continue;
+        }
+
+        QSharedPointer< EncodeTask > task( new EncodeTask );
+        task->index = i;
+        task->image = d->paintImage( job );
+        task->format = job.format == Jpeg ? QByteArrayLiteral( "jpeg" ) : QByteArrayLiteral( "png" );
+        task->quality = job.quality;
+        result.renderNanoseconds = timer.nsecsElapsed();
+
+        d->threadPool.start( [ task ]() {
+            encodeImage( task.data() );
+            task->done.release();
+        } );
+        pending.append( task );
+        while ( pending.size() > maxPending ) {
+            collect( pending.takeFirst() );
+        }
+    }
+    while ( !pending.isEmpty() ) {
+        collect( pending.takeFirst() );
+    }
+    d->restoreCharts();
+    return results;
+}
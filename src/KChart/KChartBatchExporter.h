@@ -0,0 +1,154 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KCHARTBATCHEXPORTER_H
+#define KCHARTBATCHEXPORTER_H
+
+#include <QObject>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+#include "KChartGlobal.h"
+
+QT_BEGIN_NAMESPACE
+class QAbstractItemModel;
+class QIODevice;
+QT_END_NAMESPACE
+
+namespace KChart {
+
+    class Chart;
+
+    /**
+      * @brief Exports many charts into image, SVG or PDF files in one go
+      *
+      * Generating a large number of static charts one by one spends much of its
+      * time on work that is the same for every chart. BatchExporter takes a list
+      * of jobs, each naming a configured Chart, optionally a model to show in it,
+      * the size and the output format, and exports them all:
+      *
+      * \li The charts share one cache of laid out label texts and rendered
+      *     markers, so fonts are resolved and labels laid out only once for
+      *     the whole batch. The charts get their own caches back afterwards.
+      * \li The same Chart can be used for many jobs with different models,
+      *     which avoids building up planes, axes and diagrams for every job.
+      * \li PNG and JPEG images are encoded by a thread pool while the next
+      *     charts are rendered.
+      *
+      * \code
+      * KChart::BatchExporter exporter;
+      * QVector< KChart::BatchExporter::Job > jobs;
+      * for ( QAbstractItemModel* model : models ) {
+      *     KChart::BatchExporter::Job job( chart, QSize( 800, 600 ), KChart::BatchExporter::Png, files.takeFirst() );
+      *     job.model = model;
+      *     jobs.append( job );
+      * }
+      * const QVector< KChart::BatchExporter::Result > results = exporter.exportCharts( jobs );
+      * \endcode
+      *
+      * Charts are widgets, so they are rendered on the thread calling exportCharts(),
+      * which has to be the thread owning the charts. The output devices are only
+      * written to from that thread too.
+      */
+    class KCHART_EXPORT BatchExporter : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY( BatchExporter )
+
+    public:
+        enum Format {
+            Png,
+            Jpeg,
+            Svg,
+            Pdf
+        };
+
+        /**
+          * @brief Describes one chart to be exported
+          */
+        class KCHART_EXPORT Job
+        {
+        public:
+            Job();
+            Job( Chart* chart, const QSize& size, Format format, QIODevice* device );
+
+            /** The chart to export. */
+            Chart* chart;
+            /**
+              * If set, the model of all diagrams of the chart is replaced by this
+              * model before exporting. exportCharts() sets the original models back
+              * when it is done.
+              */
+            QAbstractItemModel* model;
+            /** The size of the output in pixels at the given resolution. */
+            QSize size;
+            Format format;
+            /** The resolution, 0 uses the logical resolution of the chart. */
+            qreal dotsPerInch;
+            /** The JPEG quality from 0 to 100, -1 uses the default. */
+            int quality;
+            /**
+              * Receives the output. If it is not open yet, it is opened for writing
+              * and closed again once the output has been written.
+              */
+            QIODevice* device;
+        };
+
+        /**
+          * @brief The outcome and the timing of one job
+          */
+        class KCHART_EXPORT Result
+        {
+        public:
+            Result();
+
+            bool success;
+            /** Describes the problem if success is false. */
+            QString errorString;
+            /** The time spent laying out and painting the chart. */
+            qint64 renderNanoseconds;
+            /** The time spent encoding the image, 0 for SVG and PDF. */
+            qint64 encodeNanoseconds;
+        };
+
+        explicit BatchExporter( QObject* parent = nullptr );
+        ~BatchExporter() override;
+
+        /**
+          * Sets the number of threads encoding images. The default is the
+          * number of processor cores.
+          */
+        void setMaxThreadCount( int count );
+        int maxThreadCount() const;
+
+        /**
+          * Exports all @p jobs in order and returns their results, in the same order.
+          *
+          * jobFinished() is emitted for every job as soon as its output has
+          * been written.
+          */
+        QVector< Result > exportCharts( const QVector< Job >& jobs );
+
+        /**
+          * Drops the label and marker caches shared by the exported charts.
+          */
+        void clearCaches();
+
+    Q_SIGNALS:
+        void jobFinished( int index, const KChart::BatchExporter::Result& result );
+
+    private:
+        class Private;
+        Private* d_func() { return _d; }
+        const Private* d_func() const { return _d; }
+        Private* const _d;
+    };
+}
+
+#endif
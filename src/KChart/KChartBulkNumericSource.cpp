@@ -0,0 +1,29 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KChartBulkNumericSource.h"
+
+using namespace KChart;
+
+BulkNumericSource::~BulkNumericSource()
+{
+}
+
+bool BulkNumericSource::mayContainHiddenData( int column, const QModelIndex& parent ) const
+{
+    Q_UNUSED( column );
+    Q_UNUSED( parent );
+    return true;
+}
+
+bool BulkNumericSource::mayContainCellAttributes( int column, const QModelIndex& parent ) const
+{
+    Q_UNUSED( column );
+    Q_UNUSED( parent );
+    return true;
+}
@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KCHARTBULKNUMERICSOURCE_H
+#define KCHARTBULKNUMERICSOURCE_H
+
+#include <QModelIndex>
+
+#include "KChartGlobal.h"
+
+namespace KChart {
+
+    /**
+      * @brief Optional interface for models that can hand out whole columns of numbers
+      *
+      * Cartesian diagrams normally read their data cell by cell through
+      * QAbstractItemModel::data(), which means one virtual call and one QVariant
+      * conversion per value. A model that keeps its numbers in contiguous memory
+      * can additionally inherit from BulkNumericSource; KChart then copies each
+      * column in one go instead.
+      *
+      * \code
+      * class TelemetryModel : public QAbstractTableModel, public KChart::BulkNumericSource
+      * {
+      *     ...
+      *     const double* columnData( int column, const QModelIndex& parent, int role ) const override
+      *     {
+      *         return role == Qt::DisplayRole ? m_columns.at( column ).constData() : nullptr;
+      *     }
+      * };
+      * \endcode
+      *
+      * The interface is looked up on the model set on the diagram, so it has to be implemented by
+      * that model itself and not by a model further down a chain of proxy models.
+      */
+    class KCHART_EXPORT BulkNumericSource
+    {
+    public:
+        virtual ~BulkNumericSource();
+
+        /**
+          * Returns a pointer to rowCount( @p parent ) values of @p column for the given @p role,
+          * or nullptr if the column is not available in bulk, in which case KChart falls back to
+          * QAbstractItemModel::data().
+          *
+          * Missing values are represented by NaN, just like a null QVariant is when the data
+          * are read through QAbstractItemModel::data().
+          *
+          * The pointer only needs to stay valid until the model emits its next change signal.
+          */
+        virtual const double* columnData( int column, const QModelIndex& parent, int role ) const = 0;
+
+        /**
+          * Returns whether any cell of @p column may have KChart::DataHiddenRole set.
+          *
+          * The default implementation returns true. Returning false allows KChart to skip
+          * querying the hidden flag for every single cell of the column.
+          */
+        virtual bool mayContainHiddenData( int column, const QModelIndex& parent ) const;
+
+        /**
+          * Returns whether the model may return attributes like KChart::DatasetPenRole or
+          * KChart::LineAttributesRole for single cells of @p column.
+          *
+          * The default implementation returns true, which makes KChart check every cell of
+          * the column once per paint. Returning false skips that check.
+          */
+        virtual bool mayContainCellAttributes( int column, const QModelIndex& parent ) const;
+    };
+}
+
+#endif
@@ -15,7 +15,14 @@
 #include <QLabel>
 #include <QHash>
 #include <QToolTip>
+#include <QImage>
 #include <QPainter>
+#include <QPaintEngine>
+#include <QPicture>
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThreadPool>
 #include <QPaintEvent>
 #include <QLayoutItem>
 #include <QPushButton>
@@ -24,6 +31,7 @@
 
 #include "KChartCartesianCoordinatePlane.h"
 #include "KChartAbstractCartesianDiagram.h"
+#include "KChartAttributesModel.h"
 #include "KChartHeaderFooter.h"
 #include "KChartEnums.h"
 #include "KChartLegend.h"
@@ -289,6 +297,13 @@ Chart::Private::Private( Chart* chart_ )
     , globalLeadingRight(0)
     , globalLeadingTop(0)
     , globalLeadingBottom(0)
+    , labelLayoutCache( new TextLayoutCache )
+    , markerSpriteCache( new MarkerSpriteCache )
+    , renderCacheEnabled( false )
+    , plotLayerDirty( true )
+    , parallelPlaneRendering( false )
+    , tracingEnabled( false )
+    , tracedFrames( 0 )
 {
     for ( int row = 0; row < 3; ++row ) {
         for ( int column = 0; column < 3; ++column ) {
@@ -642,6 +657,9 @@ QHash<AbstractCoordinatePlane*, PlaneInfo> Chart::Private::buildPlaneLayoutInfos
 
 void Chart::Private::slotLayoutPlanes()
 {
+    const RenderTracer::Activation tracing( activeTracer() );
+    const TraceScope scope( "layout planes" );
+
     /*TODO make sure this is really needed */
     const QBoxLayout::Direction oldPlanesDirection = planesLayout ? planesLayout->direction()
                                                                   : QBoxLayout::TopToBottom;
@@ -1073,6 +1091,8 @@ void Chart::Private::slotResizePlanes()
     if ( !dataAndLegendLayout ) {
         return;
     }
+    const RenderTracer::Activation tracing( activeTracer() );
+    const TraceScope scope( "resize planes" );
     if ( !overrideSize.isValid() ) {
         // activate() takes the size from the layout's parent QWidget, which is not updated when overrideSize
         // is set. So don't let the layout grab the wrong size in that case.
@@ -1111,9 +1131,15 @@ void Chart::Private::reapplyInternalLayouts()
     slotResizePlanes();
 }
 
-void Chart::Private::paintAll( QPainter* painter )
+void Chart::Private::paintAll( QPainter* painter, bool useRenderCache )
 {
-    updateDirtyLayouts();
+    const RenderTracer::Activation tracing( activeTracer() );
+    const qint64 frameStart = tracingEnabled ? RenderTracer::now() : 0;
+
+    {
+        const TraceScope scope( "layout" );
+        updateDirtyLayouts();
+    }
 
     QRect rect( QPoint( 0, 0 ), overrideSize.isValid() ? overrideSize : chart->size() );
 
@@ -1124,21 +1150,262 @@ void Chart::Private::paintAll( QPainter* painter )
     // Paint the frame (if any)
     AbstractAreaBase::paintFrameAttributes( *painter, rect, frameAttributes );
 
-    chart->reLayoutFloatingLegends();
+    {
+        const TraceScope scope( "floating legends layout" );
+        chart->reLayoutFloatingLegends();
+    }
 
-    for( AbstractLayoutItem* planeLayoutItem : qAsConst(planeLayoutItems) ) {
-        planeLayoutItem->paintAll( *painter );
+    if ( useRenderCache ) {
+        paintPlotLayer( painter, rect );
+    } else {
+        paintPlaneLayoutItems( painter, rect );
     }
     for( TextArea* textLayoutItem : qAsConst(textLayoutItems) ) {
+        const TraceScope scope( "text area", textLayoutItem );
         textLayoutItem->paintAll( *painter );
     }
     for ( Legend *legend : qAsConst(legends) ) {
         const bool hidden = legend->isHidden() && legend->testAttribute( Qt::WA_WState_ExplicitShowHide );
         if ( !hidden ) {
             //qDebug() << "painting legend at " << legend->geometry();
+            const TraceScope scope( "legend", legend );
             legend->paintIntoRect( *painter, legend->geometry() );
         }
     }
+
+    if ( tracingEnabled ) {
+        const qint64 frameEnd = RenderTracer::now();
+        tracer.addEvent( "frame", nullptr, frameStart, frameEnd );
+        Q_EMIT chart->frameTraced( tracer.takeTrace( ++tracedFrames, frameStart, frameEnd ) );
+    }
+}
+
+void Chart::Private::paintPlotLayer( QPainter* painter, const QRect& rect )
+{
+    const qreal devicePixelRatio = chart->devicePixelRatioF();
+    const QSize imageSize = ( QSizeF( rect.size() ) * devicePixelRatio ).toSize();
+    if ( imageSize.isEmpty() ) {
+        return;
+    }
+
+    // a relayout moves the planes and axes without necessarily telling us
+    QVector< QRect > geometries;
+    geometries.reserve( planeLayoutItems.size() );
+    for ( AbstractLayoutItem* planeLayoutItem : qAsConst(planeLayoutItems) ) {
+        geometries.append( planeLayoutItem->geometry() );
+    }
+
+    if ( plotLayerDirty || plotLayer.size() != imageSize || plotLayer.devicePixelRatio() != devicePixelRatio ||
+         geometries != plotLayerGeometries ) {
+        watchDiagrams();
+        if ( plotLayer.size() != imageSize ) {
+            plotLayer = QImage( imageSize, QImage::Format_ARGB32_Premultiplied );
+        }
+        plotLayer.setDevicePixelRatio( devicePixelRatio );
+        // fonts have to come out in the same size as when painting on the widget
+        plotLayer.setDotsPerMeterX( qRound( chart->logicalDpiX() / 0.0254 ) );
+        plotLayer.setDotsPerMeterY( qRound( chart->logicalDpiY() / 0.0254 ) );
+        plotLayer.fill( Qt::transparent );
+
+        QPainter layerPainter( &plotLayer );
+        layerPainter.setRenderHints( painter->renderHints() );
+        layerPainter.setFont( painter->font() );
+        paintPlaneLayoutItems( &layerPainter, rect );
+        layerPainter.end();
+
+        plotLayerGeometries = geometries;
+        // ignore changes announced while painting, they are part of the image already
+        plotLayerDirty = false;
+    }
+    painter->drawImage( rect.topLeft(), plotLayer );
+}
+
+static void paintLayoutItem( QPainter* painter, AbstractLayoutItem* item )
+{
+    if ( !RenderTracer::current() ) {
+        item->paintAll( *painter );
+        return;
+    }
+    const QObject* object = dynamic_cast< QObject* >( item );
+    const TraceScope scope( qobject_cast< const AbstractCoordinatePlane* >( object ) ? "plane" : "axis", object );
+    item->paintAll( *painter );
+}
+
+void Chart::Private::paintPlaneLayoutItems( QPainter* painter, const QRect& rect )
+{
+    if ( parallelPlaneRendering && paintPlanesInParallel( painter, rect ) ) {
+        return;
+    }
+    for( AbstractLayoutItem* planeLayoutItem : qAsConst(planeLayoutItems) ) {
+        paintLayoutItem( painter, planeLayoutItem );
+    }
+}
+
+namespace {
+struct PlaneRaster {
+    AbstractCoordinatePlane* plane;
+    QPicture picture;
+    QRect area;
+    QImage image;
+};
+
+// the planes to rasterize, shared with the pool's threads. Whoever comes first claims the next
+// plane, so the painting thread never waits for a task that has not started yet, and a task
+// that only starts once all planes are done finds nothing left to do.
+struct PlaneRasterJobs {
+    QVector< PlaneRaster > rasters;
+    qreal devicePixelRatio;
+    // the printing scale factor of the painting thread, which the pool's threads do not share
+    qreal scaleFactor;
+    QPainter::RenderHints renderHints;
+    QAtomicInt next;
+    // released once for each rasterized plane
+    QSemaphore done;
+
+    void rasterizeUnclaimed()
+    {
+        const qreal prevScaleFactor = PrintingParameters::scaleFactor();
+        PrintingParameters::setScaleFactor( scaleFactor );
+        for ( int i = next.fetchAndAddOrdered( 1 ); i < rasters.size(); i = next.fetchAndAddOrdered( 1 ) ) {
+            rasterize( &rasters[ i ] );
+            done.release();
+        }
+        PrintingParameters::setScaleFactor( prevScaleFactor );
+    }
+
+    void rasterize( PlaneRaster* raster ) const
+    {
+        if ( raster->area.isEmpty() ) {
+            return;
+        }
+        raster->image = QImage( ( QSizeF( raster->area.size() ) * devicePixelRatio ).toSize(),
+                                QImage::Format_ARGB32_Premultiplied );
+        raster->image.setDevicePixelRatio( devicePixelRatio );
+        raster->image.fill( Qt::transparent );
+        QPainter rasterPainter( &raster->image );
+        rasterPainter.setRenderHints( renderHints );
+        rasterPainter.translate( -raster->area.topLeft() );
+        raster->picture.play( &rasterPainter );
+    }
+};
+}
+
+bool Chart::Private::paintPlanesInParallel( QPainter* painter, const QRect& rect )
+{
+    // rasterizing in separate images only gives the same result on raster devices, with
+    // the same resolution as the recorded pictures
+    const QPaintEngine* engine = painter->paintEngine();
+    if ( !engine || engine->type() != QPaintEngine::Raster ||
+         painter->transform().type() > QTransform::TxTranslate ||
+         painter->device()->logicalDpiX() != QPicture().logicalDpiX() ||
+         painter->device()->logicalDpiY() != QPicture().logicalDpiY() ) {
+        return false;
+    }
+
+    // pictures can not carry pixmaps to other threads
+    QSharedPointer< PlaneRasterJobs > jobs( new PlaneRasterJobs );
+    QVector< PlaneRaster >& rasters = jobs->rasters;
+    for ( AbstractLayoutItem* planeLayoutItem : qAsConst(planeLayoutItems) ) {
+        AbstractCoordinatePlane* plane = dynamic_cast< AbstractCoordinatePlane* >( planeLayoutItem );
+        if ( plane && ( !plane->backgroundAttributes().isVisible() ||
+                        plane->backgroundAttributes().pixmapMode() == BackgroundAttributes::BackgroundPixmapModeNone ) ) {
+            PlaneRaster raster;
+            raster.plane = plane;
+            rasters.append( raster );
+        }
+    }
+    if ( rasters.size() < 2 ) {
+        return false;
+    }
+
+    // record on this thread, which is the only one allowed to read the models
+    for ( PlaneRaster& raster : rasters ) {
+        QPainter recorder( &raster.picture );
+        recorder.setRenderHints( painter->renderHints() );
+        recorder.setFont( painter->font() );
+        paintLayoutItem( &recorder, raster.plane );
+        recorder.end();
+        // leave room for antialiasing
+        raster.area = raster.picture.boundingRect().adjusted( -1, -1, 1, 1 ) & rect;
+    }
+    jobs->devicePixelRatio = painter->device()->devicePixelRatioF();
+    jobs->renderHints = painter->renderHints();
+    jobs->scaleFactor = PrintingParameters::scaleFactor();
+
+    // idle threads of the pool help out, this thread rasterizes whatever is left, so a busy
+    // pool, or painting from within one of its tasks, just means rasterizing sequentially
+    const TraceScope scope( "rasterize planes" );
+    for ( int i = 1; i < rasters.size(); ++i ) {
+        if ( !QThreadPool::globalInstance()->tryStart( [ jobs ]() { jobs->rasterizeUnclaimed(); } ) ) {
+            break;
+        }
+    }
+    jobs->rasterizeUnclaimed();
+    // all planes are claimed by now, the ones still being rasterized are about to be done
+    jobs->done.acquire( rasters.size() );
+
+    // composite in the original order, painting the axes and left out planes directly
+    int next = 0;
+    for ( AbstractLayoutItem* planeLayoutItem : qAsConst(planeLayoutItems) ) {
+        if ( next < rasters.size() && planeLayoutItem == rasters.at( next ).plane ) {
+            const PlaneRaster& raster = rasters.at( next++ );
+            if ( !raster.image.isNull() ) {
+                painter->drawImage( raster.area.topLeft(), raster.image );
+            }
+        } else {
+            paintLayoutItem( painter, planeLayoutItem );
+        }
+    }
+    return true;
+}
+
+void Chart::Private::watchDiagrams()
+{
+    // diagrams can be added to and removed from planes at any time, so they are
+    // (re)connected whenever the layer is rendered; Qt::UniqueConnection avoids duplicates
+    for ( AbstractCoordinatePlane* plane : qAsConst(coordinatePlanes) ) {
+        const AbstractDiagramList diagrams = plane->diagrams();
+        for ( AbstractDiagram* diagram : diagrams ) {
+            connect( diagram, &AbstractDiagram::modelsChanged,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( diagram, &AbstractDiagram::modelDataChanged,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( diagram, &AbstractDiagram::dataHidden,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( diagram, &AbstractDiagram::propertiesChanged,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( diagram, &AbstractDiagram::layoutChanged,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+
+            AttributesModel* attributesModel = diagram->attributesModel();
+            if ( !attributesModel ) {
+                continue;
+            }
+            connect( attributesModel, &AttributesModel::attributesChanged,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( attributesModel, &QAbstractItemModel::dataChanged,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( attributesModel, &QAbstractItemModel::headerDataChanged,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( attributesModel, &QAbstractItemModel::modelReset,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( attributesModel, &QAbstractItemModel::layoutChanged,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( attributesModel, &QAbstractItemModel::rowsInserted,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( attributesModel, &QAbstractItemModel::rowsRemoved,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( attributesModel, &QAbstractItemModel::columnsInserted,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+            connect( attributesModel, &QAbstractItemModel::columnsRemoved,
+                     this, &Private::slotInvalidatePlotLayer, Qt::UniqueConnection );
+        }
+    }
+}
+
+void Chart::Private::slotInvalidatePlotLayer()
+{
+    plotLayerDirty = true;
 }
 
 // ******** Chart interface implementation ***********
@@ -1254,6 +1521,14 @@ void Chart::insertCoordinatePlane( int index, AbstractCoordinatePlane* plane )
     connect( plane, &AbstractCoordinatePlane::needRelayout, d, &Private::slotResizePlanes ) ;
     connect( plane, &AbstractCoordinatePlane::needLayoutPlanes, d, &Private::slotLayoutPlanes ) ;
     connect( plane, &AbstractCoordinatePlane::propertiesChanged, this, &Chart::propertiesChanged );
+    // keep the rendered planes of setRenderCacheEnabled() up to date; axes and diagrams
+    // request repaints through their plane too
+    connect( plane, &AbstractCoordinatePlane::needUpdate, d, &Private::slotInvalidatePlotLayer );
+    connect( plane, &AbstractCoordinatePlane::needRelayout, d, &Private::slotInvalidatePlotLayer );
+    connect( plane, &AbstractCoordinatePlane::needLayoutPlanes, d, &Private::slotInvalidatePlotLayer );
+    connect( plane, &AbstractCoordinatePlane::propertiesChanged, d, &Private::slotInvalidatePlotLayer );
+    connect( plane, &AbstractCoordinatePlane::boundariesChanged, d, &Private::slotInvalidatePlotLayer );
+    connect( plane, &AbstractCoordinatePlane::geometryChanged, d, &Private::slotInvalidatePlotLayer );
     d->coordinatePlanes.insert( index, plane );
     plane->setParent( this );
     d->slotLayoutPlanes();
@@ -1288,6 +1563,7 @@ void Chart::takeCoordinatePlane( AbstractCoordinatePlane* plane )
         plane->setParent( nullptr );
         d->mouseClickedPlanes.removeAll(plane);
     }
+    d->plotLayerDirty = true;
     d->slotLayoutPlanes();
     // Need to emit the signal: In case somebody has connected the signal
     // to her own slot for e.g. calling update() on a widget containing the chart.
@@ -1358,13 +1634,16 @@ void Chart::paint( QPainter* painter, const QRect& rect )
 
     QPaintDevice* prevDevice = GlobalMeasureScaling::paintDevice();
     GlobalMeasureScaling::setPaintDevice( painter->device() );
-    int prevScaleFactor = PrintingParameters::scaleFactor();
+    const qreal prevScaleFactor = PrintingParameters::scaleFactor();
 
     PrintingParameters::setScaleFactor( qreal( painter->device()->logicalDpiX() ) / qreal( logicalDpiX() ) );
 
-    const QRect oldGeometry( geometry() );
-    if ( oldGeometry != rect ) {
-        setGeometry( rect );
+    // lay out for the target size without resizing the widget, which would send
+    // resize events and update the widget's window
+    const bool resized = rect.size() != size();
+    if ( resized ) {
+        d->overrideSize = rect.size();
+        d->layout->setGeometry( QRect( QPoint( 0, 0 ), rect.size() ) );
         d->isPlanesLayoutDirty = true;
         d->isFloatingLegendsLayoutDirty = true;
     }
@@ -1376,8 +1655,9 @@ void Chart::paint( QPainter* painter, const QRect& rect )
     // painter->drawRect( rect );
 
     painter->translate( -rect.left(), -rect.top() );
-    if ( oldGeometry != rect ) {
-        setGeometry( oldGeometry );
+    if ( resized ) {
+        d->overrideSize = QSize();
+        d->layout->setGeometry( QRect( QPoint( 0, 0 ), size() ) );
         d->isPlanesLayoutDirty = true;
         d->isFloatingLegendsLayoutDirty = true;
     }
@@ -1386,6 +1666,28 @@ void Chart::paint( QPainter* painter, const QRect& rect )
     GlobalMeasureScaling::setPaintDevice( prevDevice );
 }
 
+QImage Chart::renderToImage( const QSize& size, qreal dotsPerInch, QImage::Format format )
+{
+    if ( size.isEmpty() ) {
+        return QImage();
+    }
+    QImage image( size, format );
+    if ( dotsPerInch > 0.0 ) {
+        image.setDotsPerMeterX( qRound( dotsPerInch / 0.0254 ) );
+        image.setDotsPerMeterY( qRound( dotsPerInch / 0.0254 ) );
+    } else {
+        image.setDotsPerMeterX( qRound( logicalDpiX() / 0.0254 ) );
+        image.setDotsPerMeterY( qRound( logicalDpiY() / 0.0254 ) );
+    }
+    image.fill( Qt::transparent );
+
+    QPainter painter( &image );
+    painter.setRenderHint( QPainter::Antialiasing );
+    paint( &painter, QRect( QPoint( 0, 0 ), size ) );
+    painter.end();
+    return image;
+}
+
 void Chart::resizeEvent ( QResizeEvent* event )
 {
     d->isPlanesLayoutDirty = true;
@@ -1403,7 +1705,7 @@ void Chart::reLayoutFloatingLegends()
             legend->setGeometry( QRect( legend->geometry().topLeft(), legendSize ) );
             // find the legends corner point (reference point plus any paddings)
             const RelativePosition relPos( legend->floatingPosition() );
-            QPointF pt( relPos.calculatedPoint( size() ) );
+            QPointF pt( relPos.calculatedPoint( d->overrideSize.isValid() ? d->overrideSize : size() ) );
             //qDebug() << pt;
             // calculate the legend's top left point
             const Qt::Alignment alignTopLeft = Qt::AlignBottom | Qt::AlignLeft;
@@ -1428,10 +1730,64 @@ void Chart::reLayoutFloatingLegends()
 void Chart::paintEvent( QPaintEvent* )
 {
     QPainter painter( this );
-    d->paintAll( &painter );
+    d->paintAll( &painter, d->renderCacheEnabled );
     Q_EMIT finishedDrawing();
 }
 
+void Chart::setRenderCacheEnabled( bool enabled )
+{
+    if ( d->renderCacheEnabled == enabled ) {
+        return;
+    }
+    d->renderCacheEnabled = enabled;
+    // free the memory when disabled, start from scratch when enabled
+    d->plotLayer = QImage();
+    d->plotLayerGeometries.clear();
+    d->plotLayerDirty = true;
+    update();
+}
+
+bool Chart::isRenderCacheEnabled() const
+{
+    return d->renderCacheEnabled;
+}
+
+void Chart::setParallelPlaneRenderingEnabled( bool enabled )
+{
+    d->parallelPlaneRendering = enabled;
+    d->plotLayerDirty = true;
+    update();
+}
+
+bool Chart::isParallelPlaneRenderingEnabled() const
+{
+    return d->parallelPlaneRendering;
+}
+
+void Chart::setTracingEnabled( bool enabled )
+{
+    if ( enabled == d->tracingEnabled ) {
+        return;
+    }
+    // for queued connections to frameTraced()
+    qRegisterMetaType< RenderTrace >();
+    d->tracingEnabled = enabled;
+    d->tracedFrames = 0;
+    // drop what was collected since the last frame
+    d->tracer.takeTrace( 0, 0, 0 );
+}
+
+bool Chart::isTracingEnabled() const
+{
+    return d->tracingEnabled;
+}
+
+void Chart::invalidateRenderCache()
+{
+    d->plotLayerDirty = true;
+    update();
+}
+
 void Chart::addHeaderFooter( HeaderFooter* hf )
 {
     Q_ASSERT( hf->type() == HeaderFooter::Header || hf->type() == HeaderFooter::Footer );
@@ -9,10 +9,12 @@
 #ifndef KCHARTCHART_H
 #define KCHARTCHART_H
 
+#include <QImage>
 #include <QWidget>
 
 #include "kchart_export.h"
 #include "KChartGlobal.h"
+#include "KChartRenderTrace.h"
 
 /*
 Simplified(*) overview of object ownership in a chart:
@@ -429,6 +431,116 @@ namespace KChart {
           */
         void paint( QPainter* painter, const QRect& rect );
 
+        /**
+          * Renders the chart into a new image, e.g. for reports generated without
+          * showing the chart on screen.
+          *
+          * The chart is laid out for the size of the image, independently of the
+          * size of the widget, which is neither resized nor repainted. Fonts, pens
+          * and marker sizes are scaled like in paint() according to the resolution.
+          *
+          * \param size The size of the image in pixels.
+          * \param dotsPerInch The resolution of the image, or 0 to use the logical
+          * resolution of the widget.
+          * \param format The format of the image, it must support transparency if
+          * the chart has no background.
+          *
+          * \return The image, or a null image if size is empty.
+          *
+          * \sa paint
+          */
+        QImage renderToImage( const QSize& size, qreal dotsPerInch = 0.0,
+                              QImage::Format format = QImage::Format_ARGB32_Premultiplied );
+
+        /**
+          * Enables or disables caching of the rendered coordinate planes.
+          *
+          * When enabled, the coordinate planes with their diagrams, grids and axes
+          * are rendered into an image that is kept between repaints of the widget,
+          * and only rendered again after a change of the planes, the diagrams, their
+          * attributes or their models, or after a resize. Repaints for other reasons,
+          * like exposing the widget or changes of headers, footers and legends, only
+          * copy the image to the screen, which makes them much faster for charts with
+          * many data points.
+          *
+          * The cache is only used for painting the widget itself, paint() always
+          * draws all parts of the chart.
+          *
+          * By default the cache is disabled.
+          *
+          * \sa invalidateRenderCache
+          */
+        void setRenderCacheEnabled( bool enabled );
+
+        /**
+          * @return Whether the rendered coordinate planes are cached between repaints.
+          *
+          * \sa setRenderCacheEnabled
+          */
+        bool isRenderCacheEnabled() const;
+
+        /**
+          * Discards the cached rendering of the coordinate planes and schedules a repaint.
+          *
+          * Call this after changes that affect the diagrams without being announced
+          * by them or their models, e.g. in a reimplemented paint method of a
+          * derived diagram class.
+          *
+          * \sa setRenderCacheEnabled
+          */
+        void invalidateRenderCache();
+
+        /**
+          * Enables or disables rasterizing the coordinate planes in parallel.
+          *
+          * Charts with several coordinate planes, e.g. many planes sharing an
+          * abscissa, spend most of their painting time rasterizing the planes one
+          * after the other. When enabled, the drawing commands of each plane are
+          * recorded first, and then rasterized concurrently into separate images
+          * by the painting thread and idle threads of the global QThreadPool, which
+          * are finally composited in the usual order. The models are only accessed while recording, on the thread
+          * owning the chart, so they need not be thread-safe.
+          *
+          * This only applies when painting into raster paint devices, like the
+          * widget itself or a QImage, and only to charts with more than one plane.
+          * Planes with a background pixmap are always painted directly.
+          *
+          * By default parallel rendering is disabled.
+          *
+          * \sa setRenderCacheEnabled
+          */
+        void setParallelPlaneRenderingEnabled( bool enabled );
+
+        /**
+          * @return Whether coordinate planes are rasterized in parallel.
+          *
+          * \sa setParallelPlaneRenderingEnabled
+          */
+        bool isParallelPlaneRenderingEnabled() const;
+
+        /**
+          * Enables or disables tracing the repaints of the chart.
+          *
+          * When enabled, frameTraced() is emitted after every repaint with the
+          * time spent in its stages and counts like the number of bars and line
+          * segments painted and of data value labels drawn and culled, for every
+          * plane and diagram.
+          * When disabled, the only cost left is a check of a pointer at the
+          * places that are traced.
+          *
+          * By default tracing is disabled.
+          *
+          * \sa RenderTrace
+          */
+        void setTracingEnabled( bool enabled );
+
+        /**
+          * @return Whether the repaints of the chart are traced.
+          *
+          * \sa setTracingEnabled
+          */
+        bool isTracingEnabled() const;
+
         void reLayoutFloatingLegends();
 
     Q_SIGNALS:
@@ -436,6 +548,13 @@ namespace KChart {
         void propertiesChanged();
         void finishedDrawing();
 
+        /**
+          * Emitted after every repaint while tracing is enabled.
+          *
+          * \sa setTracingEnabled, RenderTrace::toChromeTraceJson
+          */
+        void frameTraced( const KChart::RenderTrace& trace );
+
     protected:
         /**
           * Adjusts the internal layout when the chart is resized.
@@ -550,13 +669,6 @@ namespace KChart {
  * Please consult the respective Qt documentation for details:
  * <A HREF="http://doc.trolltech.com/">http://doc.trolltech.com/</A>
  */
-/**
- * @class QGraphicsPolygonItem "(do not include)"
- * @brief Class only listed here to document inheritance of some KChart classes.
- *
- * Please consult the respective Qt documentation for details:
- * <A HREF="http://doc.trolltech.com/">http://doc.trolltech.com/</A>
- */
 
 
 #endif
@@ -21,6 +21,8 @@
 //
 
 #include <QObject>
+#include <QImage>
+#include <QSharedPointer>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 
@@ -31,6 +33,9 @@
 #include "KChartBackgroundAttributes.h"
 #include "KChartLayoutItems.h"
 #include "KChartMath_p.h"
+#include "KChartMarkerSpriteCache_p.h"
+#include "KChartRenderTracer_p.h"
+#include "KChartTextLayoutCache_p.h"
 
 
 namespace KChart {
@@ -151,14 +156,39 @@ class Q_DECL_HIDDEN Chart::Private : public QObject
 
         Qt::LayoutDirection layoutDirection;
 
+        // laid out data value labels and rendered markers of all diagrams, kept across repaints;
+        // BatchExporter shares them between the charts it exports
+        QSharedPointer< TextLayoutCache > labelLayoutCache;
+        QSharedPointer< MarkerSpriteCache > markerSpriteCache;
+
+        // the coordinate planes and axes rendered by the last paintEvent(), see setRenderCacheEnabled()
+        bool renderCacheEnabled;
+        QImage plotLayer;
+        bool plotLayerDirty;
+        QVector< QRect > plotLayerGeometries;
+
+        bool parallelPlaneRendering;
+
+        // see setTracingEnabled(); the tracer collects between two frameTraced() signals
+        bool tracingEnabled;
+        int tracedFrames;
+        RenderTracer tracer;
+
         Private( Chart* );
 
+        static Private* get( Chart* chart ) { return chart->d_func(); }
+
         ~Private() override;
 
         void createLayouts();
         void updateDirtyLayouts();
         void reapplyInternalLayouts(); // TODO: see if this can be merged with updateDirtyLayouts()
-        void paintAll( QPainter* painter );
+        void paintAll( QPainter* painter, bool useRenderCache = false );
+        void paintPlotLayer( QPainter* painter, const QRect& rect );
+        void paintPlaneLayoutItems( QPainter* painter, const QRect& rect );
+        bool paintPlanesInParallel( QPainter* painter, const QRect& rect );
+        void watchDiagrams();
+        RenderTracer* activeTracer() { return tracingEnabled ? &tracer : nullptr; }
 
         struct AxisInfo {
             AxisInfo()
@@ -177,6 +207,7 @@ class Q_DECL_HIDDEN Chart::Private : public QObject
         void slotUnregisterDestroyedLegend( KChart::Legend * legend );
         void slotUnregisterDestroyedHeaderFooter( KChart::HeaderFooter* headerFooter );
         void slotUnregisterDestroyedPlane( KChart::AbstractCoordinatePlane* plane );
+        void slotInvalidatePlotLayer();
 };
 
 }
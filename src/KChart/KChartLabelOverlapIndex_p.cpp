@@ -0,0 +1,232 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KChartLabelOverlapIndex_p.h"
+
+#include <math.h>
+#include <limits>
+
+
+using namespace KChart;
+
+// labels that would be stored in more cells than this are kept in a separate list
+static const int maxCellsPerLabel = 64;
+
+static bool isAxisAligned( const QPolygonF& polygon )
+{
+    for ( int i = 0; i < polygon.size(); ++i ) {
+        const QPointF& p = polygon.at( i );
+        const QPointF& q = polygon.at( ( i + 1 ) % polygon.size() );
+        if ( p.x() != q.x() && p.y() != q.y() ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// true if one of the edges of a separates the convex polygons a and b
+static bool hasSeparatingEdge( const QPolygonF& a, const QPolygonF& b )
+{
+    for ( int i = 0; i < a.size(); ++i ) {
+        const QPointF& p = a.at( i );
+        const QPointF& q = a.at( ( i + 1 ) % a.size() );
+        if ( p == q ) {
+            continue;
+        }
+        const QPointF normal( p.y() - q.y(), q.x() - p.x() );
+        qreal minA = std::numeric_limits< qreal >::max();
+        qreal maxA = -minA;
+        for ( const QPointF& point : a ) {
+            const qreal projection = QPointF::dotProduct( point, normal );
+            minA = qMin( minA, projection );
+            maxA = qMax( maxA, projection );
+        }
+        qreal minB = std::numeric_limits< qreal >::max();
+        qreal maxB = -minB;
+        for ( const QPointF& point : b ) {
+            const qreal projection = QPointF::dotProduct( point, normal );
+            minB = qMin( minB, projection );
+            maxB = qMax( maxB, projection );
+        }
+        if ( maxA <= minB || maxB <= minA ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+LabelOverlapIndex::LabelOverlapIndex( qreal cellSize )
+    : m_cellSize( cellSize )
+    , m_visitStamp( 0 )
+{
+    Q_ASSERT( cellSize > 0.0 );
+}
+
+void LabelOverlapIndex::clear()
+{
+    m_labels.clear();
+    m_cells.clear();
+    m_largeLabels.clear();
+    m_visited.clear();
+    m_visitStamp = 0;
+}
+
+int LabelOverlapIndex::count() const
+{
+    return m_labels.size();
+}
+
+quint64 LabelOverlapIndex::cellKey( int column, int row )
+{
+    return ( quint64( quint32( column ) ) << 32 ) | quint32( row );
+}
+
+LabelOverlapIndex::Label LabelOverlapIndex::makeLabel( const QPolygonF& area ) const
+{
+    Label label;
+    label.boundingRect = area.boundingRect();
+    if ( !isAxisAligned( area ) ) {
+        label.polygon = area;
+    }
+
+    const qreal columnCount = ceil( label.boundingRect.right() / m_cellSize ) -
+                              floor( label.boundingRect.left() / m_cellSize );
+    const qreal rowCount = ceil( label.boundingRect.bottom() / m_cellSize ) -
+                           floor( label.boundingRect.top() / m_cellSize );
+    // also catches NaN and coordinates too large for the cell grid
+    if ( !( columnCount * rowCount <= maxCellsPerLabel ) ||
+         qAbs( label.boundingRect.left() / m_cellSize ) > 1e9 || qAbs( label.boundingRect.top() / m_cellSize ) > 1e9 ) {
+        label.firstColumn = label.endColumn = label.firstRow = label.endRow = 0;
+    } else {
+        label.firstColumn = int( floor( label.boundingRect.left() / m_cellSize ) );
+        label.endColumn = label.firstColumn + qMax( 1, int( columnCount ) );
+        label.firstRow = int( floor( label.boundingRect.top() / m_cellSize ) );
+        label.endRow = label.firstRow + qMax( 1, int( rowCount ) );
+    }
+    return label;
+}
+
+void LabelOverlapIndex::addToCells( int id )
+{
+    const Label& label = m_labels.at( id );
+    if ( label.firstColumn == label.endColumn ) {
+        m_largeLabels.append( id );
+        return;
+    }
+    for ( int row = label.firstRow; row < label.endRow; ++row ) {
+        for ( int column = label.firstColumn; column < label.endColumn; ++column ) {
+            m_cells[ cellKey( column, row ) ].append( id );
+        }
+    }
+}
+
+void LabelOverlapIndex::removeFromCells( int id )
+{
+    const Label& label = m_labels.at( id );
+    if ( label.firstColumn == label.endColumn ) {
+        m_largeLabels.removeOne( id );
+        return;
+    }
+    for ( int row = label.firstRow; row < label.endRow; ++row ) {
+        for ( int column = label.firstColumn; column < label.endColumn; ++column ) {
+            QHash< quint64, QVector< int > >::iterator it = m_cells.find( cellKey( column, row ) );
+            Q_ASSERT( it != m_cells.end() );
+            it->removeOne( id );
+            if ( it->isEmpty() ) {
+                m_cells.erase( it );
+            }
+        }
+    }
+}
+
+int LabelOverlapIndex::insert( const QPolygonF& area )
+{
+    const int id = m_labels.size();
+    m_labels.append( makeLabel( area ) );
+    m_visited.append( 0 );
+    addToCells( id );
+    return id;
+}
+
+int LabelOverlapIndex::insert( const QRectF& area )
+{
+    return insert( QPolygonF( area ) );
+}
+
+void LabelOverlapIndex::update( int id, const QPolygonF& area )
+{
+    Q_ASSERT( id >= 0 && id < m_labels.size() );
+    removeFromCells( id );
+    m_labels[ id ] = makeLabel( area );
+    addToCells( id );
+}
+
+bool LabelOverlapIndex::overlaps( const Label& label, const Label& other ) const
+{
+    if ( !label.boundingRect.intersects( other.boundingRect ) ) {
+        return false;
+    }
+    if ( label.polygon.isEmpty() && other.polygon.isEmpty() ) {
+        return true;
+    }
+    const QPolygonF a = label.polygon.isEmpty() ? QPolygonF( label.boundingRect ) : label.polygon;
+    const QPolygonF b = other.polygon.isEmpty() ? QPolygonF( other.boundingRect ) : other.polygon;
+    return !hasSeparatingEdge( a, b ) && !hasSeparatingEdge( b, a );
+}
+
+bool LabelOverlapIndex::intersects( const Label& label, int ignoredId ) const
+{
+    for ( int id : m_largeLabels ) {
+        if ( id != ignoredId && overlaps( label, m_labels.at( id ) ) ) {
+            return true;
+        }
+    }
+    if ( label.firstColumn == label.endColumn ) {
+        // too large for the cells, check everything
+        for ( int id = 0; id < m_labels.size(); ++id ) {
+            if ( id != ignoredId && overlaps( label, m_labels.at( id ) ) ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if ( ++m_visitStamp == 0 ) {
+        // wrapped around, forget old stamps
+        m_visited.fill( 0 );
+        m_visitStamp = 1;
+    }
+    for ( int row = label.firstRow; row < label.endRow; ++row ) {
+        for ( int column = label.firstColumn; column < label.endColumn; ++column ) {
+            QHash< quint64, QVector< int > >::const_iterator it = m_cells.constFind( cellKey( column, row ) );
+            if ( it == m_cells.constEnd() ) {
+                continue;
+            }
+            for ( int id : *it ) {
+                if ( id == ignoredId || m_visited.at( id ) == m_visitStamp ) {
+                    continue;
+                }
+                m_visited[ id ] = m_visitStamp;
+                if ( overlaps( label, m_labels.at( id ) ) ) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool LabelOverlapIndex::intersects( const QPolygonF& area, int ignoredId ) const
+{
+    return intersects( makeLabel( area ), ignoredId );
+}
+
+bool LabelOverlapIndex::intersects( const QRectF& area, int ignoredId ) const
+{
+    return intersects( QPolygonF( area ), ignoredId );
+}
@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KCHARTLABELOVERLAPINDEX_H
+#define KCHARTLABELOVERLAPINDEX_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QHash>
+#include <QPolygonF>
+#include <QRectF>
+#include <QVector>
+
+#include "kchart_export.h"
+
+namespace KChart {
+
+    // - finds out whether a label would overlap labels placed before, in
+    // constant time per label for labels of about the same size
+    // - labels are convex polygons, usually rotated rectangles; the common
+    // axis aligned ones are compared as rectangles
+    // - labels are kept in a spatial hash of square cells, labels that would
+    // cover too many cells are checked one by one
+    // - touching labels do not overlap
+
+    // KCHART_EXPORT is needed as long there's a test using
+    // this class directly
+    class KCHART_EXPORT LabelOverlapIndex
+    {
+    public:
+        explicit LabelOverlapIndex( qreal cellSize = 64.0 );
+
+        void clear();
+        int count() const;
+
+        // adds a label, returns its id
+        int insert( const QPolygonF& area );
+        int insert( const QRectF& area );
+        // moves the label with the given id to a new place
+        void update( int id, const QPolygonF& area );
+
+        // true if area overlaps any label but the one with id ignoredId
+        bool intersects( const QPolygonF& area, int ignoredId = -1 ) const;
+        bool intersects( const QRectF& area, int ignoredId = -1 ) const;
+
+    private:
+        class Label {
+        public:
+            QRectF boundingRect;
+            // empty if the label is its bounding rect
+            QPolygonF polygon;
+            // covered cells, [firstColumn, endColumn) x [firstRow, endRow), all empty for large labels
+            int firstColumn;
+            int endColumn;
+            int firstRow;
+            int endRow;
+        };
+
+        Label makeLabel( const QPolygonF& area ) const;
+        void addToCells( int id );
+        void removeFromCells( int id );
+        bool overlaps( const Label& label, const Label& other ) const;
+        bool intersects( const Label& label, int ignoredId ) const;
+
+        static quint64 cellKey( int column, int row );
+
+        qreal m_cellSize;
+        QVector< Label > m_labels;
+        QHash< quint64, QVector< int > > m_cells;
+        QVector< int > m_largeLabels;
+        // avoids checking labels stored in several cells more than once
+        mutable QVector< uint > m_visited;
+        mutable uint m_visitStamp;
+    };
+}
+
+#endif
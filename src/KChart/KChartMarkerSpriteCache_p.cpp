@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KChartMarkerSpriteCache_p.h"
+
+#include <QPainter>
+
+#include "KChartMarkerAttributes.h"
+#include "KChartPrintingParameters.h"
+
+#include <math.h>
+
+
+using namespace KChart;
+
+bool MarkerSpriteCache::Key::operator==( const Key& other ) const
+{
+    return style == other.style && threeD == other.threeD &&
+           width == other.width && height == other.height &&
+           brushColor == other.brushColor && brushStyle == other.brushStyle &&
+           penColor == other.penColor && penWidth == other.penWidth && penStyle == other.penStyle &&
+           penCapStyle == other.penCapStyle && penJoinStyle == other.penJoinStyle &&
+           devicePixelRatio == other.devicePixelRatio && scaleFactor == other.scaleFactor;
+}
+
+MarkerSpriteCache::MarkerSpriteCache( int maxSprites )
+    : m_sprites( qMax( 1, maxSprites ) )
+    , m_hits( 0 )
+    , m_misses( 0 )
+{
+}
+
+const QPixmap* MarkerSpriteCache::sprite( const MarkerAttributes& markerAttributes, const QBrush& brush,
+                                          const QPen& pen, const QSizeF& size, qreal devicePixelRatio,
+                                          ShapePainter paintShape )
+{
+    const uint style = markerAttributes.markerStyle();
+    if ( style == MarkerAttributes::PainterPathMarker || style == MarkerAttributes::NoMarker ) {
+        return nullptr;
+    }
+    // only plain colors are the same wherever the marker is placed
+    if ( ( brush.style() != Qt::SolidPattern && brush.style() != Qt::NoBrush ) ||
+         pen.brush().style() != Qt::SolidPattern ) {
+        return nullptr;
+    }
+
+    const qreal scaleFactor = PrintingParameters::scaleFactor();
+    // room for the outline, and for pens the marker styles set themselves
+    const qreal margin = qMax( pen.style() == Qt::NoPen ? 0.0 : qMax( pen.widthF(), qreal( 1.0 ) ),
+                               scaleFactor ) / 2.0 + 1.0;
+    // circles swap width and height, see AbstractDiagram::paintMarker()
+    const qreal extent = qMax( size.width(), size.height() ) + 2.0 * margin;
+    const int deviceExtent = int( ceil( extent * devicePixelRatio ) );
+    if ( !( size.width() > 0.0 && size.height() > 0.0 ) || deviceExtent > maxSpriteSize ) {
+        return nullptr;
+    }
+
+    Key key;
+    key.style = style;
+    key.threeD = markerAttributes.threeD();
+    key.width = size.width();
+    key.height = size.height();
+    key.brushColor = brush.color().rgba();
+    key.brushStyle = brush.style();
+    key.penColor = pen.color().rgba();
+    key.penWidth = pen.widthF();
+    key.penStyle = pen.style();
+    key.penCapStyle = pen.capStyle();
+    key.penJoinStyle = pen.joinStyle();
+    key.devicePixelRatio = devicePixelRatio;
+    key.scaleFactor = scaleFactor;
+
+    if ( const QPixmap* cached = m_sprites.object( key ) ) {
+        ++m_hits;
+        return cached;
+    }
+    ++m_misses;
+
+    QPixmap* pixmap = new QPixmap( deviceExtent, deviceExtent );
+    pixmap->setDevicePixelRatio( devicePixelRatio );
+    pixmap->fill( Qt::transparent );
+    {
+        QPainter painter( pixmap );
+        painter.setRenderHint( QPainter::Antialiasing );
+        painter.setPen( pen );
+        painter.setBrush( brush );
+        const qreal center = 0.5 * deviceExtent / devicePixelRatio;
+        painter.translate( center, center );
+        paintShape( &painter, markerAttributes, brush, size );
+    }
+    m_sprites.insert( key, pixmap );
+    return pixmap;
+}
+
+void MarkerSpriteCache::clear()
+{
+    m_sprites.clear();
+}
+
+int MarkerSpriteCache::count() const
+{
+    return int( m_sprites.count() );
+}
+
+int MarkerSpriteCache::hits() const
+{
+    return m_hits;
+}
+
+int MarkerSpriteCache::misses() const
+{
+    return m_misses;
+}
@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KCHARTMARKERSPRITECACHE_H
+#define KCHARTMARKERSPRITECACHE_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QBrush>
+#include <QCache>
+#include <QPen>
+#include <QPixmap>
+#include <QSizeF>
+
+namespace KChart {
+
+    class MarkerAttributes;
+
+    // - keeps markers rendered into small pixmaps, so that charts with many
+    // markers blit them instead of building and antialiasing their shapes
+    // again for every data point
+    // - a sprite is made for each distinct style, size, brush, pen and device
+    // pixel ratio; markers with gradient or texture brushes, custom paths or
+    // sizes larger than maxSpriteSize are not cached
+    // - one instance is shared by all diagrams of a Chart
+    class MarkerSpriteCache
+    {
+    public:
+        // paints the marker centered at ( 0, 0 ), with pen and brush already set
+        typedef void (*ShapePainter)( QPainter* painter, const MarkerAttributes& markerAttributes,
+                                      const QBrush& brush, const QSizeF& size );
+
+        explicit MarkerSpriteCache( int maxSprites = 256 );
+
+        // returns the sprite of the marker with its center in the middle of the
+        // pixmap, rendering it with paintShape if needed, or nullptr if the
+        // marker can not be cached. The pixmap is valid until the next call.
+        const QPixmap* sprite( const MarkerAttributes& markerAttributes, const QBrush& brush,
+                               const QPen& pen, const QSizeF& size, qreal devicePixelRatio,
+                               ShapePainter paintShape );
+
+        void clear();
+        int count() const;
+
+        // statistics, for performance testing code
+        int hits() const;
+        int misses() const;
+
+        // in device pixels
+        static const int maxSpriteSize = 128;
+
+    private:
+        Q_DISABLE_COPY( MarkerSpriteCache )
+
+        class Key {
+        public:
+            uint style;
+            bool threeD;
+            qreal width;
+            qreal height;
+            QRgb brushColor;
+            int brushStyle;
+            QRgb penColor;
+            qreal penWidth;
+            int penStyle;
+            int penCapStyle;
+            int penJoinStyle;
+            qreal devicePixelRatio;
+            // PrintingParameters::scaleFactor(), which some marker styles apply to their own pens
+            qreal scaleFactor;
+
+            bool operator==( const Key& other ) const;
+        };
+        friend inline uint qHash( const Key& key )
+        {
+            return uint( qHash( key.style ) ^ qHash( key.width ) ^ ( qHash( key.height ) << 1 ) ^
+                         qHash( key.brushColor ) ^ ( qHash( key.penColor ) << 2 ) ^ qHash( key.penWidth ) );
+        }
+
+        QCache< Key, QPixmap > m_sprites;
+        int m_hits;
+        int m_misses;
+    };
+}
+
+#endif
@@ -182,7 +182,8 @@ GlobalMeasureScaling::~GlobalMeasureScaling()
 
 GlobalMeasureScaling* GlobalMeasureScaling::instance()
 {
-    static GlobalMeasureScaling instance;
+    // one per thread, so that charts can be painted in several threads at once
+    static thread_local GlobalMeasureScaling instance;
     return &instance;
 }
 
@@ -122,6 +122,9 @@ private:
  * rectangle's size.
  *
  * Default factors are (1.0, 1.0)
+ *
+ * The factors and the paint device are kept per thread, so setting them
+ * while painting a chart does not affect charts painted in other threads.
  */
 class GlobalMeasureScaling
 {
@@ -8,9 +8,27 @@
 
 #include "KChartModelDataCache_p.h"
 
+#include "KChartAttributesModel.h"
 
+using namespace KChart;
 using namespace KChart::ModelDataCachePrivate;
 
+const BulkNumericSource* KChart::ModelDataCachePrivate::bulkNumericSource( const QAbstractItemModel* model )
+{
+    if ( const AttributesModel* attributesModel = qobject_cast< const AttributesModel* >( model ) ) {
+        model = attributesModel->sourceModel();
+    }
+    return dynamic_cast< const BulkNumericSource* >( model );
+}
+
+QModelIndex KChart::ModelDataCachePrivate::mapToBulkNumericSource( const QAbstractItemModel* model, const QModelIndex& index )
+{
+    if ( const AttributesModel* attributesModel = qobject_cast< const AttributesModel* >( model ) ) {
+        return attributesModel->mapToSource( index );
+    }
+    return index;
+}
+
 ModelSignalMapperConnector::ModelSignalMapperConnector( ModelSignalMapper& mapper )
     : QObject( nullptr ),
       m_mapper( mapper )
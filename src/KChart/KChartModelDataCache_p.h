@@ -15,6 +15,8 @@
 #include <QModelIndex>
 #include <QVector>
 
+#include "KChartBulkNumericSource.h"
+
 #include "kchart_export.h"
 
 QT_BEGIN_NAMESPACE
@@ -77,6 +79,12 @@ namespace KChart
         {
             return std::numeric_limits< qreal >::quiet_NaN();
         }
+
+        // returns the BulkNumericSource implemented by @p model, looking through the
+        // diagram's AttributesModel since that doesn't change the data layout
+        KCHART_EXPORT const BulkNumericSource* bulkNumericSource( const QAbstractItemModel* model );
+        // maps @p index of @p model to the model returned by bulkNumericSource()
+        KCHART_EXPORT QModelIndex mapToBulkNumericSource( const QAbstractItemModel* model, const QModelIndex& index );
     }
 
     template< class T, int ROLE >
@@ -85,7 +93,9 @@ namespace KChart
     public:
         ModelDataCache()
             : m_model( nullptr ),
-              m_connector( *this )
+              m_connector( *this ),
+              m_bulkSource( nullptr ),
+              m_rowCount( 0 )
         {
         }
 
@@ -98,28 +108,28 @@ namespace KChart
             if ( !index.isValid() || index.parent() != m_rootIndex || index.row() >= m_model->rowCount(m_rootIndex) || index.column() >= m_model->columnCount(m_rootIndex) )
                 return ModelDataCachePrivate::nan< T >();
 
-            if ( index.row() >= m_data.count() )
+            if ( index.row() >= m_rowCount )
             {
                 qWarning( "KChart didn't receive signal rowsInserted, resetModel or layoutChanged, "
                           "but an index with a row outside of the known bounds." );
 
                 // apparently, data were added behind our back (w/o signals)
                 const_cast< ModelDataCache< T, ROLE >* >( this )->rowsInserted( m_rootIndex,
-                                                                                m_data.count(),
+                                                                                m_rowCount,
                                                                                 m_model->rowCount( m_rootIndex ) - 1 );
-                Q_ASSERT( index.row() < m_data.count() );
+                Q_ASSERT( index.row() < m_rowCount );
             }
 
-            if ( index.column() >= m_data.first().count() )
+            if ( index.column() >= m_data.count() )
             {
                 qWarning( "KChart didn't got signal columnsInserted, resetModel or layoutChanged, "
                           "but an index with a column outside of the known bounds." );
 
                 // apparently, data were added behind our back (w/o signals)
                 const_cast< ModelDataCache< T, ROLE >* >( this )->columnsInserted( m_rootIndex,
-                                                                                   m_data.first().count(),
+                                                                                   m_data.count(),
                                                                                    m_model->columnCount( m_rootIndex ) - 1 );
-                Q_ASSERT( index.column() < m_data.first().count() );
+                Q_ASSERT( index.column() < m_data.count() );
             }
 
             return data( index.row(), index.column() );
@@ -133,15 +143,54 @@ namespace KChart
             Q_ASSERT( row < m_model->rowCount(m_rootIndex) );
             Q_ASSERT( column < m_model->columnCount(m_rootIndex) );
 
-            Q_ASSERT( row < m_data.count() );
-            Q_ASSERT( column < m_data.first().count() );
+            Q_ASSERT( row < m_rowCount );
+            Q_ASSERT( column < m_data.count() );
 
             if ( isCached( row, column ) )
-                return m_data.at( row ).at( column );
+                return m_data.at( column ).at( row );
+
+            if ( m_bulkSource != nullptr && fetchColumnFromBulkSource( column ) )
+                return m_data.at( column ).at( row );
 
             return fetchFromModel( row, column, ROLE );
         }
 
+        // Returns the cached values of @p column as one contiguous buffer of rowCount() entries,
+        // missing values being NaN. Only the rows in [firstRow, endRow) are guaranteed to be
+        // up to date; they are fetched from the model if necessary.
+        const T* columnData( int column, int firstRow, int endRow ) const
+        {
+            Q_ASSERT( column >= 0 && column < m_data.count() );
+            Q_ASSERT( firstRow >= 0 && firstRow <= endRow && endRow <= m_rowCount );
+
+            if ( endRow > m_validRows.at( column ) )
+            {
+                if ( m_bulkSource == nullptr || !fetchColumnFromBulkSource( column ) )
+                {
+                    for ( int row = firstRow; row < endRow; ++row )
+                    {
+                        if ( !isCached( row, column ) )
+                            fetchFromModel( row, column, ROLE );
+                    }
+                    if ( firstRow <= m_validRows.at( column ) )
+                        m_validRows[ column ] = endRow;
+                }
+            }
+
+            return m_data.at( column ).constData();
+        }
+
+        int rowCount() const
+        {
+            return m_rowCount;
+        }
+
+        // The model's bulk interface, or nullptr if it doesn't implement one.
+        const BulkNumericSource* bulkSource() const
+        {
+            return m_bulkSource;
+        }
+
         void setModel( QAbstractItemModel* model )
         {
             if ( m_model != nullptr )
@@ -175,7 +224,7 @@ namespace KChart
     protected:
         bool isCached( int row, int column ) const
         {
-            return m_cacheValid.at( row ).at( column );
+            return row < m_validRows.at( column ) || m_cacheValid.at( column ).at( row );
         }
 
         T fetchFromModel( int row, int column, int role ) const
@@ -187,12 +236,44 @@ namespace KChart
             const T value = data.isNull() ? ModelDataCachePrivate::nan< T >()
                                           : ( data.value< T >() );
 
-            m_data[ row ][ column ] = value;
-            m_cacheValid[ row ][ column ] = true;
+            m_data[ column ][ row ] = value;
+            m_cacheValid[ column ][ row ] = true;
 
             return value;
         }
 
+        // copies the not yet valid part of the column from the bulk interface, if it provides it
+        bool fetchColumnFromBulkSource( int column ) const
+        {
+            Q_ASSERT( m_bulkSource != nullptr );
+
+            const QModelIndex sourceRoot = ModelDataCachePrivate::mapToBulkNumericSource( m_model, m_rootIndex );
+            const double* values = m_bulkSource->columnData( column, sourceRoot, ROLE );
+            if ( values == nullptr )
+                return false;
+
+            T* cache = m_data[ column ].data();
+            for ( int row = m_validRows.at( column ); row < m_rowCount; ++row )
+                cache[ row ] = T( values[ row ] );
+            m_validRows[ column ] = m_rowCount;
+
+            return true;
+        }
+
+        // moves the end of the valid leading rows of the column back to @p row,
+        // recording the validity of the rows behind it per cell
+        void truncateValidRows( int column, int row ) const
+        {
+            const int validRows = m_validRows.at( column );
+            if ( row >= validRows )
+                return;
+
+            bool* valid = m_cacheValid[ column ].data();
+            for ( int i = row; i < validRows; ++i )
+                valid[ i ] = true;
+            m_validRows[ column ] = row;
+        }
+
         void columnsInserted( const QModelIndex& parent, int start, int end ) override
         {
             Q_ASSERT( m_model != nullptr );
@@ -204,14 +285,12 @@ namespace KChart
             Q_ASSERT( start <= end );
             Q_ASSERT( start <= m_model->columnCount(m_rootIndex) );
 
-            const int rowCount = m_data.count();
-            for ( int row = 0; row < rowCount; ++row )
-            {
-                m_data[ row ].insert( start, end - start + 1, T() );
-                m_cacheValid[ row ].insert( start, end - start + 1, false );
-                Q_ASSERT( m_data.at( row ).count() == m_model->columnCount( m_rootIndex ) );
-                Q_ASSERT( m_cacheValid.at( row ).count() == m_model->columnCount( m_rootIndex ) );
-            }
+            m_data.insert( start, end - start + 1, QVector< T >( m_rowCount ) );
+            m_cacheValid.insert( start, end - start + 1, QVector< bool >( m_rowCount, false ) );
+            m_validRows.insert( start, end - start + 1, 0 );
+
+            Q_ASSERT( m_data.count() == m_model->columnCount( m_rootIndex ) );
+            Q_ASSERT( m_cacheValid.count() == m_model->columnCount( m_rootIndex ) );
         }
 
         void columnsRemoved( const QModelIndex& parent, int start, int end ) override
@@ -224,14 +303,12 @@ namespace KChart
 
             Q_ASSERT( start <= end );
 
-            const int rowCount = m_data.count();
-            for ( int row = 0; row < rowCount; ++row )
-            {
-                m_data[ row ].remove( start, end - start + 1 );
-                m_cacheValid[ row ].remove( start, end - start + 1 );
-                Q_ASSERT( m_data.at( row ).count() == m_model->columnCount( m_rootIndex ) );
-                Q_ASSERT( m_cacheValid.at( row ).count() == m_model->columnCount( m_rootIndex ) );
-            }
+            m_data.remove( start, end - start + 1 );
+            m_cacheValid.remove( start, end - start + 1 );
+            m_validRows.remove( start, end - start + 1 );
+
+            Q_ASSERT( m_data.count() == m_model->columnCount( m_rootIndex ) );
+            Q_ASSERT( m_cacheValid.count() == m_model->columnCount( m_rootIndex ) );
         }
 
         void dataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight ) override
@@ -256,11 +333,14 @@ namespace KChart
             Q_ASSERT( maxRow < m_model->rowCount( m_rootIndex ) );
             Q_ASSERT( maxCol < m_model->columnCount( m_rootIndex ) );
 
-            for ( int row = minRow; row <= maxRow; ++row )
+            for ( int col = minCol; col <= maxCol; ++col )
             {
-                for ( int col = minCol; col <= maxCol; ++col )
+                // everything but the changed rows is still valid
+                truncateValidRows( col, minRow );
+                bool* valid = m_cacheValid[ col ].data();
+                for ( int row = minRow; row <= maxRow; ++row )
                 {
-                    m_cacheValid[ row ][ col ] = false;
+                    valid[ row ] = false;
                     Q_ASSERT( !isCached( row, col ) );
                 }
             }
@@ -275,15 +355,23 @@ namespace KChart
         {
             m_data.clear();
             m_cacheValid.clear();
+            m_validRows.clear();
+            m_rowCount = 0;
+
+            // the source model of an AttributesModel may have changed, too
+            m_bulkSource = ModelDataCachePrivate::bulkNumericSource( m_model );
 
             if ( m_model == nullptr )
                 return;
 
-            m_data.fill( QVector< T >( m_model->columnCount( m_rootIndex ) ), m_model->rowCount( m_rootIndex ) );
-            m_cacheValid.fill( QVector< bool >( m_model->columnCount( m_rootIndex ), false ), m_model->rowCount( m_rootIndex ) );
+            m_rowCount = m_model->rowCount( m_rootIndex );
+            const int columnCount = m_model->columnCount( m_rootIndex );
+            m_data.fill( QVector< T >( m_rowCount ), columnCount );
+            m_cacheValid.fill( QVector< bool >( m_rowCount, false ), columnCount );
+            m_validRows.fill( 0, columnCount );
 
-            Q_ASSERT( m_data.count() == m_model->rowCount( m_rootIndex ) );
-            Q_ASSERT( m_cacheValid.count() == m_model->rowCount( m_rootIndex ) );
+            Q_ASSERT( m_data.count() == m_model->columnCount( m_rootIndex ) );
+            Q_ASSERT( m_cacheValid.count() == m_model->columnCount( m_rootIndex ) );
         }
 
         void rowsInserted( const QModelIndex& parent, int start, int end ) override
@@ -297,11 +385,18 @@ namespace KChart
             Q_ASSERT( start <= end );
             Q_ASSERT( end - start + 1 <= m_model->rowCount(m_rootIndex) );
 
-            m_data.insert( start, end - start + 1, QVector< T >( m_model->columnCount( m_rootIndex ) ) );
-            m_cacheValid.insert( start, end - start + 1, QVector< bool >( m_model->columnCount( m_rootIndex ), false ) );
+            const int count = end - start + 1;
+            const int columnCount = m_data.count();
+            for ( int col = 0; col < columnCount; ++col )
+            {
+                // rows appended at the end leave the valid leading rows alone
+                truncateValidRows( col, start );
+                m_data[ col ].insert( start, count, T() );
+                m_cacheValid[ col ].insert( start, count, false );
+            }
+            m_rowCount += count;
 
-            Q_ASSERT( m_data.count() == m_model->rowCount( m_rootIndex ) );
-            Q_ASSERT( m_cacheValid.count() == m_model->rowCount( m_rootIndex ) );
+            Q_ASSERT( m_rowCount == m_model->rowCount( m_rootIndex ) );
         }
 
         void rowsRemoved( const QModelIndex& parent, int start, int end ) override
@@ -309,16 +404,22 @@ namespace KChart
             Q_ASSERT( m_model != nullptr );
             Q_ASSERT( parent.model() == m_model || !parent.isValid() );
 
-            if ( parent != m_rootIndex || start >= m_data.count() )
+            if ( parent != m_rootIndex || start >= m_rowCount )
                 return;
 
             Q_ASSERT( start <= end );
 
-            m_data.remove( start, end - start + 1 );
-            m_cacheValid.remove( start, end - start + 1 );
+            const int count = end - start + 1;
+            const int columnCount = m_data.count();
+            for ( int col = 0; col < columnCount; ++col )
+            {
+                truncateValidRows( col, start );
+                m_data[ col ].remove( start, count );
+                m_cacheValid[ col ].remove( start, count );
+            }
+            m_rowCount -= count;
 
-            Q_ASSERT( m_data.count() == m_model->rowCount( m_rootIndex ) );
-            Q_ASSERT( m_cacheValid.count() == m_model->rowCount( m_rootIndex ) );
+            Q_ASSERT( m_rowCount == m_model->rowCount( m_rootIndex ) );
         }
 
         void resetModel() override
@@ -332,8 +433,14 @@ namespace KChart
         QAbstractItemModel* m_model;
         QModelIndex m_rootIndex;
         ModelDataCachePrivate::ModelSignalMapperConnector m_connector;
+        const BulkNumericSource* m_bulkSource;
+        int m_rowCount;
+        // one flat buffer per column, i.e. per dataset (column-major)
         mutable QVector< QVector< T > > m_data;
+        // per-cell validity, only consulted for rows behind m_validRows
         mutable QVector< QVector< bool > > m_cacheValid;
+        // per column, the number of leading rows which are all valid
+        mutable QVector< int > m_validRows;
     };
 }
 
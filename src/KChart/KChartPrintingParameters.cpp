@@ -17,7 +17,8 @@ PrintingParameters::PrintingParameters()
 
 PrintingParameters* PrintingParameters::instance()
 {
-    static PrintingParameters instance;
+    // one per thread, so that charts can be painted in several threads at once
+    static thread_local PrintingParameters instance;
     return &instance;
 }
 
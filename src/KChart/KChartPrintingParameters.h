@@ -27,6 +27,7 @@ namespace KChart {
     /**
      * PrintingParameters stores the scale factor which lines has to been scaled with when printing.
      * It's essentially printer's logical DPI / widget's logical DPI
+     * The scale factor is kept per thread.
      * \internal
      */
     class PrintingParameters {
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KChartRenderTrace.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+
+using namespace KChart;
+
+RenderTrace::Event::Event()
+    : startNanoseconds( 0 )
+    , durationNanoseconds( 0 )
+{
+}
+
+RenderTrace::Counter::Counter()
+    : value( 0 )
+{
+}
+
+RenderTrace::RenderTrace()
+    : frame( 0 )
+    , startNanoseconds( 0 )
+    , durationNanoseconds( 0 )
+{
+}
+
+qint64 RenderTrace::count( const QString& name, const QString& object ) const
+{
+    qint64 sum = 0;
+    for ( const Counter& counter : counters ) {
+        if ( counter.name == name && ( object.isEmpty() || counter.object == object ) ) {
+            sum += counter.value;
+        }
+    }
+    return sum;
+}
+
+QByteArray RenderTrace::toChromeTraceJson() const
+{
+    return toChromeTraceJson( QVector< RenderTrace >() << *this );
+}
+
+// trace event timestamps are in microseconds
+static double microseconds( qint64 nanoseconds )
+{
+    return nanoseconds / 1000.0;
+}
+
+QByteArray RenderTrace::toChromeTraceJson( const QVector< RenderTrace >& traces )
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+    for ( const RenderTrace& trace : traces ) {
+        for ( const Event& event : trace.events ) {
+            QJsonObject args;
+            args.insert( QStringLiteral( "frame" ), trace.frame );
+            if ( !event.object.isEmpty() ) {
+                args.insert( QStringLiteral( "object" ), event.object );
+            }
+            QJsonObject traceEvent;
+            traceEvent.insert( QStringLiteral( "name" ), event.stage );
+            traceEvent.insert( QStringLiteral( "cat" ), QStringLiteral( "KChart" ) );
+            traceEvent.insert( QStringLiteral( "ph" ), QStringLiteral( "X" ) );
+            traceEvent.insert( QStringLiteral( "ts" ), microseconds( event.startNanoseconds ) );
+            traceEvent.insert( QStringLiteral( "dur" ), microseconds( event.durationNanoseconds ) );
+            traceEvent.insert( QStringLiteral( "pid" ), pid );
+            traceEvent.insert( QStringLiteral( "tid" ), 0 );
+            traceEvent.insert( QStringLiteral( "args" ), args );
+            traceEvents.append( traceEvent );
+        }
+
+        // one series per object, sampled at the end of the repaint
+        QJsonObject counterSeries;
+        for ( const Counter& counter : trace.counters ) {
+            QJsonObject series = counterSeries.value( counter.name ).toObject();
+            series.insert( counter.object.isEmpty() ? QStringLiteral( "chart" ) : counter.object, counter.value );
+            counterSeries.insert( counter.name, series );
+        }
+        for ( auto it = counterSeries.constBegin(); it != counterSeries.constEnd(); ++it ) {
+            QJsonObject traceEvent;
+            traceEvent.insert( QStringLiteral( "name" ), it.key() );
+            traceEvent.insert( QStringLiteral( "cat" ), QStringLiteral( "KChart" ) );
+            traceEvent.insert( QStringLiteral( "ph" ), QStringLiteral( "C" ) );
+            traceEvent.insert( QStringLiteral( "ts" ),
+                               microseconds( trace.startNanoseconds + trace.durationNanoseconds ) );
+            traceEvent.insert( QStringLiteral( "pid" ), pid );
+            traceEvent.insert( QStringLiteral( "tid" ), 0 );
+            traceEvent.insert( QStringLiteral( "args" ), it.value() );
+            traceEvents.append( traceEvent );
+        }
+    }
+
+    QJsonObject document;
+    document.insert( QStringLiteral( "traceEvents" ), traceEvents );
+    document.insert( QStringLiteral( "displayTimeUnit" ), QStringLiteral( "ms" ) );
+    return QJsonDocument( document ).toJson( QJsonDocument::Compact );
+}
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KCHARTRENDERTRACE_H
+#define KCHARTRENDERTRACE_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+#include "KChartGlobal.h"
+
+namespace KChart {
+
+    /**
+      * @brief The timings and counts recorded while a chart was painted
+      *
+      * When tracing is enabled with Chart::setTracingEnabled(), the chart emits
+      * Chart::frameTraced() with one RenderTrace after every repaint. It holds
+      * the time spent in the stages of the repaint, like laying out the planes,
+      * calculating the grids, compressing the data and painting the planes,
+      * axes, diagrams, data value labels and legends, and counters like the
+      * number of bars, line segments and markers painted, labels drawn and
+      * culled because of overlaps, and hits and misses of the label and marker
+      * caches.
+      *
+      * Stages and counters name the plane, axis, diagram or legend they belong
+      * to: its QObject::objectName() if set, otherwise its class name and address.
+      *
+      * The traces can be saved in the Chrome trace event format with
+      * toChromeTraceJson() and viewed in chrome://tracing or Perfetto.
+      */
+    class KCHART_EXPORT RenderTrace
+    {
+    public:
+        /**
+          * @brief The time spent in one stage of a repaint
+          */
+        class KCHART_EXPORT Event
+        {
+        public:
+            Event();
+
+            /** What was done, e.g. "layout", "grid", "diagram" or "data values". */
+            QString stage;
+            /** The object the stage worked on, empty for the chart as a whole. */
+            QString object;
+            /** The start, on a monotonic clock shared by all traces of the process. */
+            qint64 startNanoseconds;
+            qint64 durationNanoseconds;
+        };
+
+        /**
+          * @brief A count of things done during a repaint
+          */
+        class KCHART_EXPORT Counter
+        {
+        public:
+            Counter();
+
+            /** What was counted, e.g. "bars painted" or "labels culled". */
+            QString name;
+            /** The object the counter belongs to, empty for the chart as a whole. */
+            QString object;
+            qint64 value;
+        };
+
+        RenderTrace();
+
+        /** The number of the repaint, counting from 1 when tracing is enabled. */
+        int frame;
+        /** The start of the repaint, on the same clock as the events. */
+        qint64 startNanoseconds;
+        qint64 durationNanoseconds;
+        /**
+          * The stages in the order they finished. Stages nest, a diagram is
+          * painted while its plane is painted. Layout work done between two
+          * repaints belongs to the next one.
+          */
+        QVector< Event > events;
+        QVector< Counter > counters;
+
+        /**
+          * @return the value of the counter @p name of @p object, or the sum of
+          * the counters @p name of all objects if @p object is empty.
+          */
+        qint64 count( const QString& name, const QString& object = QString() ) const;
+
+        /**
+          * @return the trace as a JSON document in the Chrome trace event format
+          */
+        QByteArray toChromeTraceJson() const;
+
+        /**
+          * @return @p traces as one JSON document in the Chrome trace event format
+          */
+        static QByteArray toChromeTraceJson( const QVector< RenderTrace >& traces );
+    };
+}
+
+Q_DECLARE_METATYPE( KChart::RenderTrace )
+
+#endif
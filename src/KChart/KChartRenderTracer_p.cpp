@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KChartRenderTracer_p.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+
+#include "KChartAbstractDiagram.h"
+#include "KChartAbstractDiagram_p.h"
+#include "KChartMarkerSpriteCache_p.h"
+#include "KChartTextLayoutCache_p.h"
+
+
+using namespace KChart;
+
+thread_local RenderTracer* RenderTracer::s_current = nullptr;
+
+static QString traceName( const QObject* object )
+{
+    if ( !object ) {
+        return QString();
+    }
+    if ( !object->objectName().isEmpty() ) {
+        return object->objectName();
+    }
+    return QStringLiteral( "%1(0x%2)" ).arg( QLatin1String( object->metaObject()->className() ) )
+                                         .arg( quintptr( object ), 0, 16 );
+}
+
+RenderTracer::RenderTracer()
+{
+}
+
+qint64 RenderTracer::now()
+{
+    static const QElapsedTimer reference = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return reference.nsecsElapsed();
+}
+
+void RenderTracer::addEvent( const char* stage, const QObject* object, qint64 start, qint64 end )
+{
+    RenderTrace::Event event;
+    event.stage = QLatin1String( stage );
+    event.object = traceName( object );
+    event.startNanoseconds = start;
+    event.durationNanoseconds = end - start;
+    m_events.append( event );
+}
+
+void RenderTracer::count( const char* name, const QObject* object, qint64 amount )
+{
+    RenderTrace::Counter& counter = m_counters[ qMakePair( name, object ) ];
+    if ( counter.name.isEmpty() ) {
+        counter.name = QLatin1String( name );
+        counter.object = traceName( object );
+    }
+    counter.value += amount;
+}
+
+RenderTrace RenderTracer::takeTrace( int frame, qint64 start, qint64 end )
+{
+    RenderTrace trace;
+    trace.frame = frame;
+    trace.startNanoseconds = start;
+    trace.durationNanoseconds = end - start;
+    trace.events.swap( m_events );
+
+    // the same name can come from string literals at different addresses
+    for ( const RenderTrace::Counter& counter : qAsConst( m_counters ) ) {
+        bool merged = false;
+        for ( RenderTrace::Counter& existing : trace.counters ) {
+            if ( existing.name == counter.name && existing.object == counter.object ) {
+                existing.value += counter.value;
+                merged = true;
+                break;
+            }
+        }
+        if ( !merged ) {
+            trace.counters.append( counter );
+        }
+    }
+    m_counters.clear();
+    return trace;
+}
+
+void DiagramTraceScope::begin()
+{
+    AbstractDiagram::Private* diagramPrivate = AbstractDiagram::Private::get( m_diagram );
+    m_layoutHits = diagramPrivate->labelLayoutCache()->hits();
+    m_layoutMisses = diagramPrivate->labelLayoutCache()->misses();
+    m_spriteHits = diagramPrivate->markerSpriteCache()->hits();
+    m_spriteMisses = diagramPrivate->markerSpriteCache()->misses();
+    m_start = RenderTracer::now();
+}
+
+void DiagramTraceScope::end()
+{
+    const qint64 end = RenderTracer::now();
+    m_tracer->addEvent( "diagram", m_diagram, m_start, end );
+
+    AbstractDiagram::Private* diagramPrivate = AbstractDiagram::Private::get( m_diagram );
+    m_tracer->count( "label layout cache hits", m_diagram, diagramPrivate->labelLayoutCache()->hits() - m_layoutHits );
+    m_tracer->count( "label layout cache misses", m_diagram,
+                     diagramPrivate->labelLayoutCache()->misses() - m_layoutMisses );
+    m_tracer->count( "marker sprite cache hits", m_diagram, diagramPrivate->markerSpriteCache()->hits() - m_spriteHits );
+    m_tracer->count( "marker sprite cache misses", m_diagram,
+                     diagramPrivate->markerSpriteCache()->misses() - m_spriteMisses );
+}
@@ -0,0 +1,153 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KCHARTRENDERTRACER_H
+#define KCHARTRENDERTRACER_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QHash>
+#include <QPair>
+
+#include "KChartRenderTrace.h"
+
+QT_BEGIN_NAMESPACE
+class QObject;
+QT_END_NAMESPACE
+
+namespace KChart {
+
+    class AbstractDiagram;
+
+    // - collects the stages and counters of one repaint of a Chart into a RenderTrace
+    // - a Chart with tracing enabled makes its tracer the current one of the thread
+    // while it paints or lays out, see Activation; the code being traced only ever
+    // looks at current(), which is a null pointer when nothing is traced
+    class RenderTracer
+    {
+    public:
+        RenderTracer();
+
+        static RenderTracer* current() { return s_current; }
+
+        // nanoseconds on a monotonic clock shared by all tracers
+        static qint64 now();
+
+        void addEvent( const char* stage, const QObject* object, qint64 start, qint64 end );
+        void count( const char* name, const QObject* object, qint64 amount );
+
+        // hands out what has been collected since the last call
+        RenderTrace takeTrace( int frame, qint64 start, qint64 end );
+
+        // makes a tracer, or no tracer, the current one of the thread while in scope
+        class Activation
+        {
+        public:
+            explicit Activation( RenderTracer* tracer )
+                : m_previous( s_current )
+            {
+                s_current = tracer;
+            }
+            ~Activation()
+            {
+                s_current = m_previous;
+            }
+
+        private:
+            Q_DISABLE_COPY( Activation )
+            RenderTracer* m_previous;
+        };
+
+    private:
+        Q_DISABLE_COPY( RenderTracer )
+
+        static thread_local RenderTracer* s_current;
+
+        QVector< RenderTrace::Event > m_events;
+        // string literals as keys, the names are looked up once per repaint
+        QHash< QPair< const char*, const QObject* >, RenderTrace::Counter > m_counters;
+    };
+
+    // records the time spent in the scope as a stage, if a tracer is current
+    class TraceScope
+    {
+    public:
+        explicit TraceScope( const char* stage, const QObject* object = nullptr )
+            : m_tracer( RenderTracer::current() )
+            , m_stage( stage )
+            , m_object( object )
+            , m_start( m_tracer ? RenderTracer::now() : 0 )
+        {}
+        ~TraceScope()
+        {
+            if ( m_tracer ) {
+                m_tracer->addEvent( m_stage, m_object, m_start, RenderTracer::now() );
+            }
+        }
+
+    private:
+        Q_DISABLE_COPY( TraceScope )
+        RenderTracer* const m_tracer;
+        const char* const m_stage;
+        const QObject* const m_object;
+        const qint64 m_start;
+    };
+
+    // like TraceScope, and counts the hits and misses of the label and marker
+    // caches while the diagram paints
+    class DiagramTraceScope
+    {
+    public:
+        explicit DiagramTraceScope( AbstractDiagram* diagram )
+            : m_tracer( RenderTracer::current() )
+            , m_diagram( diagram )
+            , m_start( 0 )
+        {
+            if ( m_tracer ) {
+                begin();
+            }
+        }
+        ~DiagramTraceScope()
+        {
+            if ( m_tracer ) {
+                end();
+            }
+        }
+
+    private:
+        Q_DISABLE_COPY( DiagramTraceScope )
+        void begin();
+        void end();
+
+        RenderTracer* const m_tracer;
+        AbstractDiagram* const m_diagram;
+        qint64 m_start;
+        int m_layoutHits;
+        int m_layoutMisses;
+        int m_spriteHits;
+        int m_spriteMisses;
+    };
+
+    inline void traceCount( const char* name, const QObject* object, qint64 amount = 1 )
+    {
+        if ( RenderTracer* tracer = RenderTracer::current() ) {
+            tracer->count( name, object, amount );
+        }
+    }
+}
+
+#endif
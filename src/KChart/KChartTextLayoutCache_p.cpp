@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KChartTextLayoutCache_p.h"
+
+#include <QAbstractTextDocumentLayout>
+#include <QPaintDevice>
+#include <QTextDocument>
+
+
+using namespace KChart;
+
+class TextLayoutCache::Entry
+{
+public:
+    QTextDocument document;
+    QRectF boundingRect;
+};
+
+TextLayoutCache::TextLayoutCache( int maxEntries )
+    : m_entries( qMax( 1, maxEntries ) )
+    , m_hits( 0 )
+    , m_misses( 0 )
+{
+}
+
+TextLayoutCache::~TextLayoutCache()
+{
+}
+
+TextLayoutCache::Entry* TextLayoutCache::entry( const QString& text, const QFont& font, QPaintDevice* device )
+{
+    Key key;
+    key.text = text;
+    key.font = font;
+    key.dpiX = device ? device->logicalDpiX() : 0;
+    key.dpiY = device ? device->logicalDpiY() : 0;
+
+    Entry* cached = m_entries.object( key );
+    if ( cached ) {
+        ++m_hits;
+        // the layout only uses the device while laying out, which has happened already, but
+        // it must not keep pointing to a device that may have been deleted since
+        cached->document.documentLayout()->setPaintDevice( device );
+        return cached;
+    }
+    ++m_misses;
+
+    Entry* created = new Entry;
+    QTextDocument& doc = created->document;
+    doc.setDocumentMargin( 0.0 );
+    if ( Qt::mightBeRichText( text ) ) {
+        doc.setHtml( text );
+    } else {
+        doc.setPlainText( text );
+    }
+    doc.setDefaultFont( font );
+    QAbstractTextDocumentLayout* const layout = doc.documentLayout();
+    layout->setPaintDevice( device );
+    created->boundingRect = layout->frameBoundingRect( doc.rootFrame() );
+
+    m_entries.insert( key, created );
+    return created;
+}
+
+QTextDocument* TextLayoutCache::document( const QString& text, const QFont& font, QPaintDevice* device )
+{
+    return &entry( text, font, device )->document;
+}
+
+QRectF TextLayoutCache::boundingRect( const QString& text, const QFont& font, QPaintDevice* device )
+{
+    return entry( text, font, device )->boundingRect;
+}
+
+void TextLayoutCache::setMaxEntries( int maxEntries )
+{
+    // QCache would drop new entries right away with a maximum cost of 0
+    m_entries.setMaxCost( qMax( 1, maxEntries ) );
+}
+
+int TextLayoutCache::maxEntries() const
+{
+    return int( m_entries.maxCost() );
+}
+
+int TextLayoutCache::count() const
+{
+    return int( m_entries.count() );
+}
+
+void TextLayoutCache::clear()
+{
+    m_entries.clear();
+}
+
+int TextLayoutCache::hits() const
+{
+    return m_hits;
+}
+
+int TextLayoutCache::misses() const
+{
+    return m_misses;
+}
+
+void TextLayoutCache::resetStatistics()
+{
+    m_hits = 0;
+    m_misses = 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KCHARTTEXTLAYOUTCACHE_H
+#define KCHARTTEXTLAYOUTCACHE_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QCache>
+#include <QFont>
+#include <QRectF>
+#include <QString>
+
+#include "kchart_export.h"
+
+QT_BEGIN_NAMESPACE
+class QPaintDevice;
+class QTextDocument;
+QT_END_NAMESPACE
+
+namespace KChart {
+
+    // - keeps data value label texts laid out across repaints, so that
+    // painting a label does not have to build and lay out a QTextDocument
+    // every time
+    // - entries are keyed by text, font and the resolution of the paint
+    // device, the least recently used ones are dropped first
+    // - rotation and colors are applied when painting and do not affect
+    // the layout, so labels differing only in those share an entry
+    // - one instance is shared by all diagrams of a Chart
+
+    // KCHART_EXPORT is needed as long there's a test using
+    // this class directly
+    class KCHART_EXPORT TextLayoutCache
+    {
+    public:
+        explicit TextLayoutCache( int maxEntries = 2048 );
+        ~TextLayoutCache();
+
+        // returns @p text laid out in @p font for @p device, as rich text if
+        // Qt::mightBeRichText( text ) says so; device may be nullptr for the
+        // default resolution.
+        // The document is owned by the cache and valid until the next call.
+        QTextDocument* document( const QString& text, const QFont& font, QPaintDevice* device );
+        // the frame bounding rect of the document returned by document()
+        QRectF boundingRect( const QString& text, const QFont& font, QPaintDevice* device );
+
+        void setMaxEntries( int maxEntries );
+        int maxEntries() const;
+        int count() const;
+        void clear();
+
+        // statistics, for performance testing code
+        int hits() const;
+        int misses() const;
+        void resetStatistics();
+
+    private:
+        Q_DISABLE_COPY( TextLayoutCache )
+
+        class Key {
+        public:
+            QString text;
+            QFont font;
+            int dpiX;
+            int dpiY;
+
+            bool operator==( const Key& other ) const
+            {
+                return dpiX == other.dpiX && dpiY == other.dpiY &&
+                       text == other.text && font == other.font;
+            }
+        };
+        friend inline uint qHash( const Key& key )
+        {
+            return uint( qHash( key.text ) ^ qHash( key.font ) ) ^ uint( key.dpiX * 31 + key.dpiY );
+        }
+
+        class Entry;
+        Entry* entry( const QString& text, const QFont& font, QPaintDevice* device );
+
+        QCache< Key, Entry > m_entries;
+        int m_hits;
+        int m_misses;
+    };
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include "KChartPolarCoordinatePlane_p.h"
 #include "KChartThreeDPieAttributes.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartLabelOverlapIndex_p.h"
 #include "KChartMath_p.h"
 
 #include <QDebug>
@@ -289,12 +290,10 @@ static int wraparound( int i, int size )
 void PieDiagram::shuffleLabels( QRectF* textBoundingRect )
 {
     // things that could be improved here:
-    // - use a variable number (chosen using angle information) of neighbors to check
     // - try harder to arrange the labels to look nice
 
     // ideas:
     // - leave labels that don't collide alone (only if they their offset is zero)
-    // - use a graphics view for collision detection
 
     LabelPaintCache& lpc = d->labelPaintCache;
     const int n = lpc.paintReplay.size();
@@ -303,37 +302,35 @@ void PieDiagram::shuffleLabels( QRectF* textBoundingRect )
     QVector< qreal > offsets;
     offsets.fill( 0.0, n );
 
+    // the ids of the labels in the index are their positions in paintReplay
+    LabelOverlapIndex labels;
+    for ( int i = 0; i < n; i++ ) {
+        labels.insert( lpc.paintReplay[ i ].labelArea.toFillPolygon() );
+    }
+
     for ( bool lastRoundModified = true; lastRoundModified; ) {
         lastRoundModified = false;
 
         for ( int i = 0; i < n; i++ ) {
-            const int neighborsToCheck = qMax( 10, lpc.paintReplay.size() - 1 );
-            const int minComp = wraparound( i - neighborsToCheck / 2, n );
-            const int maxComp = wraparound( i + ( neighborsToCheck + 1 ) / 2, n );
-
             QPainterPath& path = lpc.paintReplay[ i ].labelArea;
+            QPolygonF area = path.toFillPolygon();
 
-            for ( int j = minComp; j != maxComp; j = wraparound( j + 1, n ) ) {
-                if ( i == j ) {
-                    continue;
-                }
-                QPainterPath& otherPath = lpc.paintReplay[ j ].labelArea;
-
-                while ( ( offsets[ i ] + direction > 0 ) && otherPath.intersects( path ) ) {
+            while ( ( offsets[ i ] + direction > 0 ) && labels.intersects( area, i ) ) {
 #ifdef SHUFFLE_DEBUG
-                    qDebug() << "collision involving" << j << "and" << i << " -- n =" << n;
-                    TextAttributes ta = lpc.paintReplay[ i ].attrs.textAttributes();
-                    ta.setPen( QPen( Qt::white ) );
-                    lpc.paintReplay[ i ].attrs.setTextAttributes( ta );
+                qDebug() << "collision involving" << i << " -- n =" << n;
+                TextAttributes ta = lpc.paintReplay[ i ].attrs.textAttributes();
+                ta.setPen( QPen( Qt::white ) );
+                lpc.paintReplay[ i ].attrs.setTextAttributes( ta );
 #endif
-                    uint slice = lpc.paintReplay[ i ].index.column();
-                    qreal angle = DEGTORAD( d->startAngles[ slice ] + d->angleLens[ slice ] / 2.0 );
-                    qreal dx = cos( angle ) * direction;
-                    qreal dy = -sin( angle ) * direction;
-                    offsets[ i ] += direction;
-                    path.translate( dx, dy );
-                    lastRoundModified = true;
-                }
+                uint slice = lpc.paintReplay[ i ].index.column();
+                qreal angle = DEGTORAD( d->startAngles[ slice ] + d->angleLens[ slice ] / 2.0 );
+                qreal dx = cos( angle ) * direction;
+                qreal dy = -sin( angle ) * direction;
+                offsets[ i ] += direction;
+                path.translate( dx, dy );
+                area.translate( dx, dy );
+                labels.update( i, area );
+                lastRoundModified = true;
             }
         }
         direction *= -1.07; // this can "overshoot", but avoids getting trapped in local minimums
@@ -13,9 +13,11 @@
 #include "KChartChart.h"
 #include "KChartPaintContext.h"
 #include "KChartAbstractDiagram.h"
+#include "KChartAbstractDiagram_p.h"
 #include "KChartAbstractPolarDiagram.h"
 #include "KChartPolarDiagram.h"
 #include "KChartMath_p.h"
+#include "KChartRenderTracer_p.h"
 
 #include <QFont>
 #include <QList>
@@ -77,6 +79,7 @@ void PolarCoordinatePlane::paint ( QPainter* painter )
     d->newZoomX = oldZoomX;
     d->newZoomY = oldZoomY;
     for ( int i = 0; i < diags.size(); i++ ) {
+        AbstractDiagram::Private::get( diags[ i ] )->setUpReverseMapping();
         d->currentTransformation = & ( d->coordinateTransformations[i] );
         qreal zoomX;
         qreal zoomY;
@@ -105,6 +108,7 @@ void PolarCoordinatePlane::paint ( QPainter* painter )
     for ( int i = 0; i < diags.size(); i++ ) {
         d->currentTransformation = & ( d->coordinateTransformations[i] );
         PainterSaver painterSaver( painter );
+        const DiagramTraceScope scope( diags[ i ] );
         PolarDiagram* polarDia = dynamic_cast<PolarDiagram*>( diags[i] );
         if ( polarDia ) {
             qreal dummy1, dummy2;
@@ -9,34 +9,38 @@
 #include "ReverseMapper.h"
 
 #include <math.h>
+#include <algorithm>
+#include <functional>
 
 #include <QRect>
+#include <QSet>
 #include <QtDebug>
 #include <QPolygonF>
 #include <QPainterPath>
-#include <QGraphicsScene>
 
 #include "KChartAbstractDiagram.h"
-#include "ChartGraphicsItem.h"
 
 using namespace KChart;
 
+// the outline of a shape is one pixel wide, so hits up to half a pixel
+// outside of its polygon still count
+static const qreal outlineMargin = 0.5;
+// shapes that would be stored in more bins than this are kept in a separate list
+static const int maxBinsPerShape = 64;
+static const int maxGridSize = 1024;
+
 ReverseMapper::ReverseMapper()
     : m_diagram( nullptr )
-    , m_scene( nullptr )
 {
 }
 
 ReverseMapper::ReverseMapper( AbstractDiagram* diagram )
     : m_diagram( diagram )
-    , m_scene( nullptr )
 {
 }
 
 ReverseMapper::~ReverseMapper()
 {
-    delete m_scene;
-    m_scene = nullptr;
 }
 
 void ReverseMapper::setDiagram( AbstractDiagram* diagram )
@@ -46,59 +50,111 @@ void ReverseMapper::setDiagram( AbstractDiagram* diagram )
 
 void ReverseMapper::clear()
 {
-    m_polygons.clear();
-    if (m_scene)
-        m_scene->clear();
-    m_sceneDirty = true;
+    m_shapes.clear();
+    m_points.clear();
+    m_deferredShapeCount = 0;
+    m_indexDirty = true;
+}
+
+void ReverseMapper::setEnabled( bool enabled )
+{
+    m_enabled = enabled;
+}
+
+bool ReverseMapper::isEnabled() const
+{
+    return m_enabled;
+}
+
+void ReverseMapper::setDeferred( bool deferred )
+{
+    m_deferred = deferred;
+}
+
+bool ReverseMapper::isDeferred() const
+{
+    return m_deferred;
 }
 
 QModelIndexList ReverseMapper::indexesIn( const QRect& rect ) const
 {
-    populateScene();
+    buildIndex();
 
-    if ( m_scene->sceneRect().intersects( rect ) ) {
-        const QList<QGraphicsItem *> items = m_scene->items( rect );
-        QModelIndexList indexes;
-        for ( QGraphicsItem* item : items ) {
-            ChartGraphicsItem* i = qgraphicsitem_cast<ChartGraphicsItem*>( item );
-            if ( i ) {
-                QModelIndex index ( m_diagram->model()->index( i->row(), i->column(), m_diagram->rootIndex() ) ); // checked
-                indexes << index;
+    const QRectF area = QRectF( rect ).adjusted( -outlineMargin, -outlineMargin, outlineMargin, outlineMargin );
+    if ( m_shapes.isEmpty() || !m_gridRect.intersects( area ) ) {
+        return QModelIndexList();
+    }
+
+    QVector<int> hits;
+    int firstColumn, endColumn, firstRow, endRow;
+    binRange( area, &firstColumn, &endColumn, &firstRow, &endRow );
+    for ( int binRow = firstRow; binRow < endRow; ++binRow ) {
+        for ( int binColumn = firstColumn; binColumn < endColumn; ++binColumn ) {
+            const int bin = binRow * m_gridColumns + binColumn;
+            for ( int i = m_binStart.at( bin ); i < m_binStart.at( bin + 1 ); ++i ) {
+                hits.append( m_binShapes.at( i ) );
             }
         }
-        return indexes;
-    } else {
-        return QModelIndexList();
     }
+    // shapes covering several bins have been found more than once
+    std::sort( hits.begin(), hits.end() );
+    hits.erase( std::unique( hits.begin(), hits.end() ), hits.end() );
+    hits += m_largeShapes;
+
+    QVector<int> shapes;
+    for ( int shape : qAsConst( hits ) ) {
+        if ( shapeIntersects( shape, area ) ) {
+            shapes.append( shape );
+        }
+    }
+    return indexesOf( &shapes );
 }
 
 QModelIndexList ReverseMapper::indexesAt( const QPointF& point ) const
 {
-    populateScene();
-
-    if ( m_scene->sceneRect().contains( point ) ) {
-        const QList<QGraphicsItem *> items = m_scene->items( point );
-        QModelIndexList indexes;
-        for ( QGraphicsItem* item : items ) {
-            ChartGraphicsItem* i = qgraphicsitem_cast<ChartGraphicsItem*>( item );
-            if ( i ) {
-                QModelIndex index ( m_diagram->model()->index( i->row(), i->column(), m_diagram->rootIndex() ) ); // checked
-                if ( !indexes.contains(index) )
-                    indexes << index;
-            }
-        }
-        return indexes;
-    } else {
+    buildIndex();
+
+    if ( m_shapes.isEmpty() || !m_gridRect.contains( point ) ) {
         return QModelIndexList();
     }
+
+    // shapes are stored in all bins their outline overlaps, so the bin of the point is enough
+    QVector<int> shapes;
+    int firstColumn, endColumn, firstRow, endRow;
+    binRange( QRectF( point, QSizeF() ), &firstColumn, &endColumn, &firstRow, &endRow );
+    const int bin = firstRow * m_gridColumns + firstColumn;
+    for ( int i = m_binStart.at( bin ); i < m_binStart.at( bin + 1 ); ++i ) {
+        if ( shapeContains( m_binShapes.at( i ), point ) ) {
+            shapes.append( m_binShapes.at( i ) );
+        }
+    }
+    for ( int shape : qAsConst( m_largeShapes ) ) {
+        if ( shapeContains( shape, point ) ) {
+            shapes.append( shape );
+        }
+    }
+    return indexesOf( &shapes );
 }
 
 QPolygonF ReverseMapper::polygon( int row, int column ) const
 {
     if ( !m_diagram->model()->hasIndex( row, column, m_diagram->rootIndex() ) )
         return QPolygon();
-    const QModelIndex index = m_diagram->model()->index( row, column, m_diagram->rootIndex() ); // checked
-    return m_polygons.value(index);
+
+    buildIndex();
+    const auto lessThan = [this]( int shape, const QPair<int, int>& cell ) {
+        const Shape& s = m_shapes.at( shape );
+        return s.row < cell.first || ( s.row == cell.first && s.column < cell.second );
+    };
+    const QPair<int, int> cell( row, column );
+    auto it = std::lower_bound( m_shapesByCell.constBegin(), m_shapesByCell.constEnd(), cell, lessThan );
+
+    // several polygons added for the same cell are united
+    QPolygonF result;
+    for ( ; it != m_shapesByCell.constEnd() && m_shapes.at( *it ).row == row && m_shapes.at( *it ).column == column; ++it ) {
+        result = result.isEmpty() ? shapePolygon( *it ) : result.united( shapePolygon( *it ) );
+    }
+    return result;
 }
 
 QRectF ReverseMapper::boundingRect( int row, int column ) const
@@ -113,33 +169,33 @@ void ReverseMapper::addRect( int row, int column, const QRectF& rect )
 
 void ReverseMapper::addPolygon( int row, int column, const QPolygonF& polygon )
 {
-    const auto index = m_diagram->model()->index( row, column, m_diagram->rootIndex() );
-    auto &value = m_polygons[index];
-    if (value.isEmpty()) {
-        value = polygon;
-    } else {
-        value = value.united(polygon);
+    if ( !m_enabled || polygon.isEmpty() ) {
+        return;
     }
 
-    m_sceneDirty = true;
+    Shape shape;
+    shape.kind = Shape::Polygon;
+    shape.boundingRect = polygon.boundingRect();
+    shape.row = row;
+    shape.column = column;
+    shape.firstPoint = m_points.size();
+    shape.pointCount = polygon.size();
+    m_shapes.append( shape );
+    m_points += polygon;
+
+    m_indexDirty = true;
 }
 
-void ReverseMapper::addCircle( int row, int column, const QPointF& location, const QSizeF& diameter )
+static QPolygonF circlePolygon( const QPointF& location, const QSizeF& diameter )
 {
     QPainterPath path;
     QPointF ossfet( -0.5*diameter.width(), -0.5*diameter.height() );
     path.addEllipse( QRectF( location + ossfet, diameter ) );
-    addPolygon( row, column, QPolygonF( path.toFillPolygon() ) );
+    return path.toFillPolygon();
 }
 
-void ReverseMapper::addLine( int row, int column, const QPointF& from, const QPointF& to )
+static QPolygonF linePolygon( const QPointF& from, const QPointF& to )
 {
-    // that's no line, dude... make a small circle around that point, instead
-    if ( from == to )
-    {
-        addCircle( row, column, from, QSizeF( 1.5, 1.5 ) );
-        return;
-    }
     // lines do not make good polygons to click on. we calculate a 2
     // pixel wide rectangle, where the original line is exactly
     // centered in.
@@ -161,31 +217,240 @@ void ReverseMapper::addLine( int row, int column, const QPointF& from, const QPo
     const QPointF two( left - lineVectorUnit - normOfLineVectorUnit );
     const QPointF three( right + lineVectorUnit - normOfLineVectorUnit );
     const QPointF four( right + lineVectorUnit + normOfLineVectorUnit );
-    addPolygon( row, column, QPolygonF() << one << two << three << four );
+    return QPolygonF() << one << two << three << four;
+}
+
+void ReverseMapper::addCircle( int row, int column, const QPointF& location, const QSizeF& diameter )
+{
+    if ( !m_enabled )
+        return;
+    if ( !m_deferred ) {
+        addPolygon( row, column, circlePolygon( location, diameter ) );
+        return;
+    }
+    // keep the painting code fast, the outline is computed by resolveDeferredShapes()
+    Shape shape;
+    shape.kind = Shape::Circle;
+    shape.row = row;
+    shape.column = column;
+    shape.firstPoint = m_points.size();
+    shape.pointCount = 2;
+    m_shapes.append( shape );
+    m_points << location << QPointF( diameter.width(), diameter.height() );
+    ++m_deferredShapeCount;
+    m_indexDirty = true;
+}
+
+void ReverseMapper::addLine( int row, int column, const QPointF& from, const QPointF& to )
+{
+    if ( !m_enabled )
+        return;
+    // that's no line, dude... make a small circle around that point, instead
+    if ( from == to )
+    {
+        addCircle( row, column, from, QSizeF( 1.5, 1.5 ) );
+        return;
+    }
+    if ( !m_deferred ) {
+        addPolygon( row, column, linePolygon( from, to ) );
+        return;
+    }
+    Shape shape;
+    shape.kind = Shape::Line;
+    shape.row = row;
+    shape.column = column;
+    shape.firstPoint = m_points.size();
+    shape.pointCount = 2;
+    m_shapes.append( shape );
+    m_points << from << to;
+    ++m_deferredShapeCount;
+    m_indexDirty = true;
 }
 
-void ReverseMapper::populateScene() const
+void ReverseMapper::resolveDeferredShapes() const
 {
-    // we populate the scene lazily...
+    if ( m_deferredShapeCount == 0 ) {
+        return;
+    }
+    m_deferredShapeCount = 0;
+
+    // the polygons replace the stored positions, keeping the order of the shapes
+    QVector<QPointF> points;
+    points.reserve( m_points.size() );
+    for ( Shape& shape : m_shapes ) {
+        QPolygonF polygon;
+        switch ( shape.kind ) {
+        case Shape::Polygon:
+            polygon = QPolygonF( m_points.mid( shape.firstPoint, shape.pointCount ) );
+            break;
+        case Shape::Circle: {
+            const QPointF diameter = m_points.at( shape.firstPoint + 1 );
+            polygon = circlePolygon( m_points.at( shape.firstPoint ), QSizeF( diameter.x(), diameter.y() ) );
+            shape.boundingRect = polygon.boundingRect();
+            break;
+        }
+        case Shape::Line:
+            polygon = linePolygon( m_points.at( shape.firstPoint ), m_points.at( shape.firstPoint + 1 ) );
+            shape.boundingRect = polygon.boundingRect();
+            break;
+        }
+        shape.kind = Shape::Polygon;
+        shape.firstPoint = points.size();
+        shape.pointCount = polygon.size();
+        points += polygon;
+    }
+    m_points = points;
+}
+
+void ReverseMapper::buildIndex() const
+{
+    // we build the index lazily, in one go after painting...
 
     Q_ASSERT( m_diagram );
 
-    if (!m_sceneDirty) {
+    if ( !m_indexDirty ) {
         return;
     }
+    m_indexDirty = false;
+    resolveDeferredShapes();
+
+    const int shapeCount = m_shapes.size();
+    m_shapesByCell.resize( shapeCount );
+    for ( int i = 0; i < shapeCount; ++i ) {
+        m_shapesByCell[ i ] = i;
+    }
+    std::stable_sort( m_shapesByCell.begin(), m_shapesByCell.end(), [this]( int a, int b ) {
+        const Shape& sa = m_shapes.at( a );
+        const Shape& sb = m_shapes.at( b );
+        return sa.row < sb.row || ( sa.row == sb.row && sa.column < sb.column );
+    } );
+
+    QRectF gridRect;
+    for ( const Shape& shape : m_shapes ) {
+        gridRect |= shape.boundingRect;
+    }
+    m_gridRect = gridRect.adjusted( -outlineMargin, -outlineMargin, outlineMargin, outlineMargin );
+
+    // about one shape per bin, with roughly square bins
+    const qreal aspectRatio = m_gridRect.width() / m_gridRect.height();
+    m_gridColumns = qBound( 1, int( ceil( sqrt( shapeCount * aspectRatio ) ) ), maxGridSize );
+    m_gridRows = qBound( 1, ( shapeCount + m_gridColumns - 1 ) / m_gridColumns, maxGridSize );
+    const int binCount = m_gridColumns * m_gridRows;
+
+    // counting sort of the shapes into the bins they overlap
+    m_largeShapes.clear();
+    QVector<int> binCounts( binCount + 1, 0 );
+    QVector<bool> large( shapeCount, false );
+    for ( int i = 0; i < shapeCount; ++i ) {
+        int firstColumn, endColumn, firstRow, endRow;
+        binRange( m_shapes.at( i ).boundingRect.adjusted( -outlineMargin, -outlineMargin, outlineMargin, outlineMargin ),
+                  &firstColumn, &endColumn, &firstRow, &endRow );
+        if ( ( endColumn - firstColumn ) * ( endRow - firstRow ) > maxBinsPerShape ) {
+            large[ i ] = true;
+            m_largeShapes.append( i );
+            continue;
+        }
+        for ( int row = firstRow; row < endRow; ++row ) {
+            for ( int column = firstColumn; column < endColumn; ++column ) {
+                ++binCounts[ row * m_gridColumns + column ];
+            }
+        }
+    }
+    m_binStart.resize( binCount + 1 );
+    int total = 0;
+    for ( int bin = 0; bin <= binCount; ++bin ) {
+        m_binStart[ bin ] = total;
+        total += binCounts.at( bin );
+    }
+    m_binShapes.resize( total );
+    QVector<int> fill = m_binStart;
+    for ( int i = 0; i < shapeCount; ++i ) {
+        if ( large.at( i ) ) {
+            continue;
+        }
+        int firstColumn, endColumn, firstRow, endRow;
+        binRange( m_shapes.at( i ).boundingRect.adjusted( -outlineMargin, -outlineMargin, outlineMargin, outlineMargin ),
+                  &firstColumn, &endColumn, &firstRow, &endRow );
+        for ( int row = firstRow; row < endRow; ++row ) {
+            for ( int column = firstColumn; column < endColumn; ++column ) {
+                m_binShapes[ fill[ row * m_gridColumns + column ]++ ] = i;
+            }
+        }
+    }
+}
+
+void ReverseMapper::binRange( const QRectF& rect, int* firstColumn, int* endColumn, int* firstRow, int* endRow ) const
+{
+    const qreal binWidth = m_gridRect.width() / m_gridColumns;
+    const qreal binHeight = m_gridRect.height() / m_gridRows;
+    const auto bin = [] ( qreal offset, qreal size, int count ) {
+        return size > 0 ? qBound( 0, int( floor( offset / size ) ), count - 1 ) : 0;
+    };
+    const QRectF r = rect.normalized();
+    *firstColumn = bin( r.left() - m_gridRect.left(), binWidth, m_gridColumns );
+    *endColumn = bin( r.right() - m_gridRect.left(), binWidth, m_gridColumns ) + 1;
+    *firstRow = bin( r.top() - m_gridRect.top(), binHeight, m_gridRows );
+    *endRow = bin( r.bottom() - m_gridRect.top(), binHeight, m_gridRows ) + 1;
+}
+
+QPolygonF ReverseMapper::shapePolygon( int shape ) const
+{
+    const Shape& s = m_shapes.at( shape );
+    return QPolygonF( m_points.mid( s.firstPoint, s.pointCount ) );
+}
 
-    if (!m_scene) {
-        m_scene = new QGraphicsScene;
+static qreal distanceToSegment( const QPointF& point, const QPointF& from, const QPointF& to )
+{
+    const QPointF segment = to - from;
+    const qreal lengthSquared = QPointF::dotProduct( segment, segment );
+    qreal t = lengthSquared > 0 ? QPointF::dotProduct( point - from, segment ) / lengthSquared : 0;
+    t = qBound( qreal( 0 ), t, qreal( 1 ) );
+    const QPointF d = point - ( from + t * segment );
+    return sqrt( QPointF::dotProduct( d, d ) );
+}
+
+bool ReverseMapper::shapeContains( int shape, const QPointF& point ) const
+{
+    const Shape& s = m_shapes.at( shape );
+    if ( !s.boundingRect.adjusted( -outlineMargin, -outlineMargin, outlineMargin, outlineMargin ).contains( point ) ) {
+        return false;
+    }
+    const QPolygonF polygon = shapePolygon( shape );
+    if ( polygon.containsPoint( point, Qt::OddEvenFill ) ) {
+        return true;
+    }
+    for ( int i = 0; i < polygon.size(); ++i ) {
+        if ( distanceToSegment( point, polygon.at( i ), polygon.at( ( i + 1 ) % polygon.size() ) ) <= outlineMargin ) {
+            return true;
+        }
     }
+    return false;
+}
 
-    QRectF boundingRect;
-    for (auto it = m_polygons.constBegin(), end = m_polygons.constEnd(); it != end; ++it) {
-        auto* item = new ChartGraphicsItem( it.key().row(), it.key().column() );
-        item->setPolygon( it.value() );
-        m_scene->addItem( item );
-        boundingRect |= it.value().boundingRect();
+bool ReverseMapper::shapeIntersects( int shape, const QRectF& rect ) const
+{
+    // not QRectF::intersects(), bounding rects of lines may have no width or height
+    const QRectF& b = m_shapes.at( shape ).boundingRect;
+    if ( b.left() > rect.right() || b.right() < rect.left() || b.top() > rect.bottom() || b.bottom() < rect.top() ) {
+        return false;
+    }
+    if ( rect.contains( b ) ) {
+        return true;
     }
+    return shapePolygon( shape ).intersects( QPolygonF( rect ) );
+}
 
-    m_scene->setSceneRect(boundingRect);
-    m_sceneDirty = false;
+QModelIndexList ReverseMapper::indexesOf( QVector<int>* shapes ) const
+{
+    std::sort( shapes->begin(), shapes->end(), std::greater<int>() );
+    QModelIndexList indexes;
+    QSet< QPair<int, int> > cells;
+    for ( int shape : qAsConst( *shapes ) ) {
+        const Shape& s = m_shapes.at( shape );
+        if ( cells.contains( qMakePair( s.row, s.column ) ) )
+            continue;
+        cells.insert( qMakePair( s.row, s.column ) );
+        indexes << m_diagram->model()->index( s.row, s.column, m_diagram->rootIndex() ); // checked
+    }
+    return indexes;
 }
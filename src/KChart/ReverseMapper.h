@@ -10,18 +10,17 @@
 #define REVERSEMAPPER_H
 
 #include <QModelIndex>
-#include <QHash>
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
 
 QT_BEGIN_NAMESPACE
-class QRectF;
-class QGraphicsScene;
 class QPolygonF;
 QT_END_NAMESPACE
 
 namespace KChart {
 
     class AbstractDiagram;
-    class ChartGraphicsItem;
 
     /**
       * @brief The ReverseMapper stores information about objects on a chart and their respective model indexes
@@ -40,6 +39,15 @@ namespace KChart {
 
         void clear();
 
+        // while disabled, nothing is added
+        void setEnabled( bool enabled );
+        bool isEnabled() const;
+
+        // while deferred, circles and lines are only stored by their position,
+        // their outlines are computed by the first query
+        void setDeferred( bool deferred );
+        bool isDeferred() const;
+
         QModelIndexList indexesAt( const QPointF& point ) const;
         QModelIndexList indexesIn( const QRect& rect ) const;
 
@@ -53,12 +61,51 @@ namespace KChart {
         void addLine( int row, int column, const QPointF& from, const QPointF& to );
 
     private:
-        void populateScene() const;
+        // one added polygon, its points being m_points[ firstPoint, firstPoint + pointCount ).
+        // Deferred circles store their center and diameter there, deferred lines their end points.
+        class Shape {
+        public:
+            enum Kind { Polygon, Circle, Line };
+            Kind kind;
+            QRectF boundingRect;
+            int row;
+            int column;
+            int firstPoint;
+            int pointCount;
+        };
+
+        // builds the lookup structures below, lazily after shapes have been added
+        void buildIndex() const;
+        // replaces deferred circles and lines by their outline polygons
+        void resolveDeferredShapes() const;
+        QPolygonF shapePolygon( int shape ) const;
+        bool shapeContains( int shape, const QPointF& point ) const;
+        bool shapeIntersects( int shape, const QRectF& rect ) const;
+        // grid bins covered by the rect, as [*firstColumn, *endColumn) x [*firstRow, *endRow)
+        void binRange( const QRectF& rect, int* firstColumn, int* endColumn, int* firstRow, int* endRow ) const;
+        // the model indexes of the shapes, topmost (i.e. last added) first
+        QModelIndexList indexesOf( QVector<int>* shapes ) const;
 
         AbstractDiagram* m_diagram;
-        QHash<QModelIndex, QPolygonF> m_polygons;
-        mutable QGraphicsScene* m_scene;
-        mutable bool m_sceneDirty = true;
+        // mutable for resolveDeferredShapes()
+        mutable QVector<Shape> m_shapes;
+        mutable QVector<QPointF> m_points;
+        mutable int m_deferredShapeCount = 0;
+
+        // a uniform grid over all shapes: the shapes overlapping bin i are
+        // m_binShapes[ m_binStart[ i ], m_binStart[ i + 1 ] )
+        mutable QRectF m_gridRect;
+        mutable int m_gridColumns = 0;
+        mutable int m_gridRows = 0;
+        mutable QVector<int> m_binStart;
+        mutable QVector<int> m_binShapes;
+        // shapes that would cover too many bins are checked one by one
+        mutable QVector<int> m_largeShapes;
+        // all shapes, sorted by row and column, for polygon()
+        mutable QVector<int> m_shapesByCell;
+        mutable bool m_indexDirty = true;
+        bool m_enabled = true;
+        bool m_deferred = false;
     };
 
 }
@@ -30,7 +30,6 @@
 #include "KChartMath_p.h"
 
 #include "ReverseMapper.h"
-#include "ChartGraphicsItem.h"
 
 namespace KChart {
 
@@ -16,6 +16,8 @@
 #include "KChartPainterSaver_p.h"
 #include "KChartTernaryAxis.h"
 #include "KChartAbstractTernaryDiagram.h"
+#include "KChartAbstractDiagram_p.h"
+#include "KChartRenderTracer_p.h"
 
 #include "TernaryConstants.h"
 
@@ -161,6 +163,8 @@ void TernaryCoordinatePlane::paint( QPainter* painter )
         for ( int i = 0; i < diags.size(); i++ )
         {
             PainterSaver diagramPainterSaver( painter );
+            const DiagramTraceScope scope( diags[ i ] );
+            AbstractDiagram::Private::get( diags[ i ] )->setUpReverseMapping();
             diags[i]->paint ( &ctx );
         }
     }
@@ -11,39 +11,88 @@
 
 
 #include <cassert>
-#include <algorithm>
-#include <functional>
 
 using namespace KGantt;
 
 
 
 ConstraintModel::Private::Private()
+    : removedCount( 0 ), bulkUpdatesEnabled( false )
 {
 }
 
-void ConstraintModel::Private::addConstraintToIndex( const QModelIndex& idx, const Constraint& c )
+ConstraintModel::Private::Edge ConstraintModel::Private::edge( const Constraint& c )
 {
-    IndexType::iterator it = indexMap.find(idx);
-    while (it != indexMap.end() && it.key() == idx) {
-        // Check if we already have this
-        if ( *it == c ) return;
-        ++it;
+    return Edge( c.startIndex(), c.endIndex() );
+}
+
+int ConstraintModel::Private::indexOf( const Constraint& c ) const
+{
+    const Edge e = edge( c );
+    const QHash<Edge,int>::const_iterator it = positions.constFind( e );
+    if ( it != positions.constEnd() ) return *it;
+    if ( e.first.isValid() && e.second.isValid() ) return -1;
+
+    // An endpoint removed from its model is not the key it was added with
+    for ( int i = 0; i < constraints.count(); ++i ) {
+        if ( !removed.at( i ) && c.compareIndexes( constraints.at( i ) ) ) return i;
     }
+    return -1;
+}
+
+void ConstraintModel::Private::insert( const Constraint& c )
+{
+    const Edge e = edge( c );
+    positions.insert( e, constraints.count() );
+    constraints.push_back( c );
+    edges.push_back( e );
+    removed.push_back( false );
+    outgoing[e.first].push_back( e.second );
+    incoming[e.second].push_back( e.first );
+}
+
+void ConstraintModel::Private::removeEndpoint( AdjacencyType& adjacency,
+                                               const QPersistentModelIndex& from, const QPersistentModelIndex& to )
+{
+    AdjacencyType::iterator it = adjacency.find( from );
+    if ( it == adjacency.end() ) return;
+    it->removeOne( to );
+    if ( it->isEmpty() ) adjacency.erase( it );
+}
 
-    indexMap.insert( idx, c );
+Constraint ConstraintModel::Private::takeAt( int i )
+{
+    const Constraint c = constraints.at( i );
+    const Edge e = edges.at( i );
+    positions.remove( e );
+    removeEndpoint( outgoing, e.first, e.second );
+    removeEndpoint( incoming, e.second, e.first );
+
+    constraints[i] = Constraint();
+    edges[i] = Edge();
+    removed[i] = true;
+    ++removedCount;
+    if ( removedCount > constraints.count() / 2 ) compact();
+    return c;
 }
 
-void ConstraintModel::Private::removeConstraintFromIndex( const QModelIndex& idx,  const Constraint& c )
+void ConstraintModel::Private::compact() const
 {
-    IndexType::iterator it = indexMap.find(idx);
-    while (it != indexMap.end() && it.key() == idx) {
-        if ( c.compareIndexes(*it) ) {
-            it =indexMap.erase( it );
-        } else {
-            ++it;
+    if ( removedCount == 0 ) return;
+    int to = 0;
+    for ( int from = 0; from < constraints.count(); ++from ) {
+        if ( removed.at( from ) ) continue;
+        if ( to != from ) {
+            constraints[to] = constraints.at( from );
+            edges[to] = edges.at( from );
+            positions[edges.at( to )] = to;
         }
+        ++to;
     }
+    constraints.erase( constraints.begin() + to, constraints.end() );
+    edges.resize( to );
+    removed.fill( false, to );
+    removedCount = 0;
 }
 
 
@@ -72,38 +121,23 @@ void ConstraintModel::init()
 {
 }
 
-namespace {
-    struct compare_constraint_indexes_to {
-        compare_constraint_indexes_to( const Constraint& c )
-            : m_c( c ) {
-        }
-        bool operator()( const Constraint& c ) const
-        {
-            return m_c.compareIndexes( c );
-        }
-
-        const Constraint& m_c;
-    };
+static bool sameConstraint( const Constraint& c1, const Constraint& c2 )
+{
+    return c1.dataMap() == c2.dataMap() && c1.type() == c2.type() && c1.relationType() == c2.relationType();
 }
 
 void ConstraintModel::addConstraint( const Constraint& c )
 {
     //qDebug() << "ConstraintModel::addConstraint("<<c<<") (this="<<this<<") items=" << d->constraints.size();
-    QList<Constraint>::iterator it = std::find_if ( d->constraints.begin(),
-                                                    d->constraints.end(),
-                                                    compare_constraint_indexes_to(c) );
-
-    if ( it == d->constraints.end() ) {
-        d->constraints.push_back( c );
-        d->addConstraintToIndex( c.startIndex(), c );
-        d->addConstraintToIndex( c.endIndex(), c );
+    const int i = d->indexOf( c );
+
+    if ( i < 0 ) {
+        d->insert( c );
         Q_EMIT constraintAdded( c );
-    } else if ( ( *it ).dataMap() != c.dataMap() || ( *it ).type() != c.type() || ( *it ).relationType() != c.relationType() ) {
-        Constraint tmp( *it ); // save to avoid re-entrancy issues
+    } else if ( !sameConstraint( d->constraints.at( i ), c ) ) {
+        Constraint tmp( d->constraints.at( i ) ); // save to avoid re-entrancy issues
         removeConstraint( tmp );
-        d->constraints.push_back( c );
-        d->addConstraintToIndex( c.startIndex(), c );
-        d->addConstraintToIndex( c.endIndex(), c );
+        d->insert( c );
         Q_EMIT constraintAdded( c );
     }
 }
@@ -112,24 +146,70 @@ bool ConstraintModel::removeConstraint( const Constraint& c )
 {
     bool rc = false;
 
-    for (int i = 0; i < d->constraints.count(); i++)
-    {
-        if (c.compareIndexes(d->constraints.at(i)))
-        {
-            d->constraints.removeAt(i);
-            rc = true;
-        }
+    for ( int i = d->indexOf( c ); i >= 0; i = d->indexOf( c ) ) {
+        d->takeAt( i );
+        rc = true;
     }
 
     if ( rc ) {
-        d->removeConstraintFromIndex( c.startIndex(), c );
-        d->removeConstraintFromIndex( c.endIndex(), c );
         Q_EMIT constraintRemoved( c );
     }
 
     return rc;
 }
 
+void ConstraintModel::addConstraints( const QList<Constraint>& constraints )
+{
+    QList<Constraint> added;
+    QList<Constraint> removed;
+    for ( const Constraint& c : constraints ) {
+        const int i = d->indexOf( c );
+        if ( i >= 0 ) {
+            if ( sameConstraint( d->constraints.at( i ), c ) ) continue;
+            const Constraint old = d->takeAt( i );
+            // nobody has been told about a constraint added earlier in this call
+            if ( !added.removeOne( old ) ) removed.push_back( old );
+        }
+        d->insert( c );
+        added.push_back( c );
+    }
+
+    if ( !removed.isEmpty() ) {
+        Q_EMIT constraintsRemoved( removed );
+    }
+    if ( !added.isEmpty() ) {
+        Q_EMIT constraintsAdded( added );
+    }
+}
+
+int ConstraintModel::removeConstraints( const QList<Constraint>& constraints )
+{
+    QList<Constraint> removed;
+    for ( const Constraint& c : constraints ) {
+        bool rc = false;
+        for ( int i = d->indexOf( c ); i >= 0; i = d->indexOf( c ) ) {
+            d->takeAt( i );
+            rc = true;
+        }
+        if ( rc ) removed.push_back( c );
+    }
+
+    if ( !removed.isEmpty() ) {
+        Q_EMIT constraintsRemoved( removed );
+    }
+    return removed.count();
+}
+
+void ConstraintModel::setBulkUpdatesEnabled( bool enable )
+{
+    d->bulkUpdatesEnabled = enable;
+}
+
+bool ConstraintModel::bulkUpdatesEnabled() const
+{
+    return d->bulkUpdatesEnabled;
+}
+
 void ConstraintModel::clear()
 {
     const QList<Constraint> lst = constraints();
@@ -153,48 +233,44 @@ void ConstraintModel::cleanup()
 QList<Constraint> ConstraintModel::constraints() const
 {
     //return d->constraints.toList();
+    d->compact();
     return d->constraints;
 }
 
 QList<Constraint> ConstraintModel::constraintsForIndex( const QModelIndex& idx ) const
 {
-    // TODO: @Steffen: Please comment on this assert, it's long and not obvious (Johannes)
-    // TODO: Afaics indexMap is not used anymore, so remove it (danders)
-    //assert( !idx.isValid() || d->indexMap.isEmpty() || !d->indexMap.keys().front().model() || idx.model() == d->indexMap.keys().front().model() );
     if ( !idx.isValid() ) {
         // Because of a Qt bug we need to treat this as a special case
         QSet<Constraint> result;
-        for ( const Constraint& c : qAsConst(d->constraints) ) {
+        for ( int i = 0; i < d->constraints.count(); ++i ) {
+            const Constraint& c = d->constraints.at( i );
+            if ( d->removed.at( i ) ) continue;
             if ( !c.startIndex().isValid() || !c.endIndex().isValid() ) result.insert( c );
         }
         return result.values();
     } else {
         QList<Constraint> result;
-        for ( const Constraint& c : qAsConst(d->constraints) ) {
-            if ( c.startIndex() == idx || c.endIndex() == idx ) result.push_back( c );
+        const QPersistentModelIndex pidx( idx );
+        Private::AdjacencyType::const_iterator it = d->outgoing.constFind( pidx );
+        if ( it != d->outgoing.constEnd() ) {
+            for ( const QPersistentModelIndex& end : *it ) {
+                result.push_back( d->constraints.at( d->positions.value( Private::Edge( pidx, end ) ) ) );
+            }
+        }
+        it = d->incoming.constFind( pidx );
+        if ( it != d->incoming.constEnd() ) {
+            for ( const QPersistentModelIndex& start : *it ) {
+                if ( start == pidx ) continue; // already found as outgoing
+                result.push_back( d->constraints.at( d->positions.value( Private::Edge( start, pidx ) ) ) );
+            }
         }
         return result;
     }
-
-    //return d->indexMap.values( idx );
 }
 
 bool ConstraintModel::hasConstraint( const Constraint& c ) const
 {
-    /*
-    // Because of a Qt bug we have to search like this
-    for ( Constraint c2 : qAsConst(d->constraints) ) {
-        if ( c==c2 ) return true;
-    }
-    return false;
-    */
-    bool hc = false;
-
-    for (int i = 0; i < d->constraints.count(); i++)
-        if (c.compareIndexes(d->constraints.at(i)))
-            hc = true;
-
-    return hc;
+    return d->indexOf( c ) >= 0;
 }
 
 #ifndef QT_NO_DEBUG_STREAM
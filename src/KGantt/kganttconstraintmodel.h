@@ -58,6 +58,45 @@ namespace KGantt {
          */
         virtual bool removeConstraint( const Constraint& c );
 
+        /*! Adds the Constraints \a constraints to this ConstraintModel,
+         * like addConstraint() does for each of them, and emits
+         * constraintsAdded() once with the Constraints that were added.
+         * Constraints that are replaced are announced by one
+         * constraintsRemoved() signal before that.
+         *
+         * addConstraint() is not called, and constraintAdded() is not emitted.
+         * Use this to add many Constraints at once.
+         * \sa setBulkUpdatesEnabled()
+         */
+        void addConstraints( const QList<Constraint>& constraints );
+
+        /*! Removes the Constraints \a constraints from this ConstraintModel
+         * and emits constraintsRemoved() once with the Constraints that
+         * were found and removed.
+         *
+         * removeConstraint() is not called, and constraintRemoved() is not emitted.
+         * \sa setBulkUpdatesEnabled()
+         *
+         * \returns the number of Constraints that were removed.
+         */
+        int removeConstraints( const QList<Constraint>& constraints );
+
+        /*! Lets the constraints of a View be passed to this model with
+         * addConstraints() and removeConstraints(), when it is kept in sync
+         * with the model of another view. Otherwise addConstraint() and
+         * removeConstraint() are called for each Constraint.
+         *
+         * Disabled by default, so that subclasses overriding addConstraint()
+         * and removeConstraint() see every Constraint. Enable it if they do
+         * not override them.
+         */
+        void setBulkUpdatesEnabled( bool enable );
+
+        /*! \returns true if bulk updates are enabled
+         * \sa setBulkUpdatesEnabled()
+         */
+        bool bulkUpdatesEnabled() const;
+
         /*! Removes all Constraints from this model
          * The signal constraintRemoved(const Constraint&) is emitted
          * for every Constraint that is removed.
@@ -68,7 +107,7 @@ namespace KGantt {
         void cleanup();
 
         /*! \returns A list of all Constraints in this
-         * ConstraintModel.
+         * ConstraintModel, in the order they were added.
          */
         QList<Constraint> constraints() const;
 
@@ -88,6 +127,8 @@ namespace KGantt {
     Q_SIGNALS:
         void constraintAdded(const KGantt::Constraint&);
         void constraintRemoved(const KGantt::Constraint&);
+        void constraintsAdded(const QList<KGantt::Constraint>&);
+        void constraintsRemoved(const QList<KGantt::Constraint>&);
 
     private:
         Private* _d;
@@ -11,24 +11,48 @@
 
 #include "kganttconstraintmodel.h"
 
+#include <QHash>
 #include <QList>
-#include <QMultiHash>
+#include <QPair>
 #include <QPersistentModelIndex>
+#include <QVector>
 
 namespace KGantt {
+    /* Constraints are found by their endpoints. A QPersistentModelIndex
+     * hashes by its shared data and compares by the index it points to.
+     * The persistent indexes of one index share their data, which follows
+     * the row when rows are moved, so the keys stay valid without rehashing.
+     */
     class Q_DECL_HIDDEN ConstraintModel::Private {
     public:
-        Private();
-
-        void addConstraintToIndex( const QModelIndex& idx, const Constraint& c );
-        void removeConstraintFromIndex( const QModelIndex& idx,  const Constraint& c );
+        typedef QPair<QPersistentModelIndex,QPersistentModelIndex> Edge;
+        typedef QHash<QPersistentModelIndex,QVector<QPersistentModelIndex> > AdjacencyType;
 
-        typedef QMultiHash<QPersistentModelIndex,Constraint> IndexType;
+        Private();
 
-        QList<Constraint> constraints;
-        IndexType indexMap;
+        static Edge edge( const Constraint& c );
+        int indexOf( const Constraint& c ) const;
+        void insert( const Constraint& c );
+        Constraint takeAt( int i );
+        void compact() const;
+        static void removeEndpoint( AdjacencyType& adjacency,
+                                    const QPersistentModelIndex& from, const QPersistentModelIndex& to );
+
+        // - constraints and edges are in the order they were added, removing
+        // a constraint only marks its place as removed, the places are
+        // compacted when most of them are removed or constraints() is asked for
+        // - positions has the place of each edge in constraints
+        // - outgoing and incoming have the other endpoints of the constraints
+        // starting and ending at an index
+        mutable QList<Constraint> constraints;
+        mutable QVector<Edge> edges;
+        mutable QVector<bool> removed;
+        mutable int removedCount;
+        mutable QHash<Edge,int> positions;
+        AdjacencyType outgoing;
+        AdjacencyType incoming;
+        bool bulkUpdatesEnabled;
     };
 }
 
 #endif /* KGANTTCONSTRAINTMODEL_P_H */
-
@@ -15,6 +15,30 @@ using namespace KGantt;
 
 
 
+/* The bulk functions do not call addConstraint() and removeConstraint(),
+ * which a subclass may override */
+static void addConstraints( ConstraintModel* model, const QList<Constraint>& constraints )
+{
+    if ( model->bulkUpdatesEnabled() ) {
+        model->addConstraints( constraints );
+    } else {
+        for ( const Constraint& c : constraints ) {
+            model->addConstraint( c );
+        }
+    }
+}
+
+static void removeConstraints( ConstraintModel* model, const QList<Constraint>& constraints )
+{
+    if ( model->bulkUpdatesEnabled() ) {
+        model->removeConstraints( constraints );
+    } else {
+        for ( const Constraint& c : constraints ) {
+            model->removeConstraint( c );
+        }
+    }
+}
+
 ConstraintProxy::ConstraintProxy( QObject* parent )
     : QObject( parent )
 {
@@ -35,6 +59,10 @@ void ConstraintProxy::setSourceModel( ConstraintModel* src )
              this, SLOT(slotSourceConstraintAdded(KGantt::Constraint)) );
     connect( m_source, SIGNAL(constraintRemoved(KGantt::Constraint)),
              this, SLOT(slotSourceConstraintRemoved(KGantt::Constraint)) );
+    connect( m_source, SIGNAL(constraintsAdded(QList<KGantt::Constraint>)),
+             this, SLOT(slotSourceConstraintsAdded(QList<KGantt::Constraint>)) );
+    connect( m_source, SIGNAL(constraintsRemoved(QList<KGantt::Constraint>)),
+             this, SLOT(slotSourceConstraintsRemoved(QList<KGantt::Constraint>)) );
 }
 
 void ConstraintProxy::setDestinationModel( ConstraintModel* dest )
@@ -48,6 +76,10 @@ void ConstraintProxy::setDestinationModel( ConstraintModel* dest )
              this, SLOT(slotDestinationConstraintAdded(KGantt::Constraint)) );
     connect( m_destination, SIGNAL(constraintRemoved(KGantt::Constraint)),
              this, SLOT(slotDestinationConstraintRemoved(KGantt::Constraint)) );
+    connect( m_destination, SIGNAL(constraintsAdded(QList<KGantt::Constraint>)),
+             this, SLOT(slotDestinationConstraintsAdded(QList<KGantt::Constraint>)) );
+    connect( m_destination, SIGNAL(constraintsRemoved(QList<KGantt::Constraint>)),
+             this, SLOT(slotDestinationConstraintsRemoved(QList<KGantt::Constraint>)) );
 }
 
 void ConstraintProxy::setProxyModel( QAbstractProxyModel* proxy )
@@ -71,14 +103,32 @@ void ConstraintProxy::copyFromSource()
     if ( m_destination ) {
         m_destination->clear();
         if ( !m_source ) return;
-        const QList<Constraint> lst = m_source->constraints();
-        for( const Constraint& c : lst )
-        {
-           Constraint temp( m_proxy->mapFromSource( c.startIndex() ), m_proxy->mapFromSource( c.endIndex() ),
-                            c.type(), c.relationType(), c.dataMap() );
-           m_destination->addConstraint( temp );
-        }
+        addConstraints( m_destination, mapFromSource( m_source->constraints() ) );
+    }
+}
+
+QList<Constraint> ConstraintProxy::mapFromSource( const QList<Constraint>& constraints ) const
+{
+    QList<Constraint> result;
+    result.reserve( constraints.count() );
+    for( const Constraint& c : constraints )
+    {
+        result.push_back( Constraint( m_proxy->mapFromSource( c.startIndex() ), m_proxy->mapFromSource( c.endIndex() ),
+                                      c.type(), c.relationType(), c.dataMap() ) );
     }
+    return result;
+}
+
+QList<Constraint> ConstraintProxy::mapToSource( const QList<Constraint>& constraints ) const
+{
+    QList<Constraint> result;
+    result.reserve( constraints.count() );
+    for( const Constraint& c : constraints )
+    {
+        result.push_back( Constraint( m_proxy->mapToSource( c.startIndex() ), m_proxy->mapToSource( c.endIndex() ),
+                                      c.type(), c.relationType(), c.dataMap() ) );
+    }
+    return result;
 }
 
 void ConstraintProxy::slotSourceConstraintAdded( const KGantt::Constraint& c )
@@ -121,6 +171,26 @@ void ConstraintProxy::slotDestinationConstraintRemoved( const KGantt::Constraint
     }
 }
 
+void ConstraintProxy::slotSourceConstraintsAdded( const QList<KGantt::Constraint>& constraints )
+{
+    if ( m_destination ) addConstraints( m_destination, mapFromSource( constraints ) );
+}
+
+void ConstraintProxy::slotSourceConstraintsRemoved( const QList<KGantt::Constraint>& constraints )
+{
+    if ( m_destination ) removeConstraints( m_destination, mapFromSource( constraints ) );
+}
+
+void ConstraintProxy::slotDestinationConstraintsAdded( const QList<KGantt::Constraint>& constraints )
+{
+    if ( m_source ) addConstraints( m_source, mapToSource( constraints ) );
+}
+
+void ConstraintProxy::slotDestinationConstraintsRemoved( const QList<KGantt::Constraint>& constraints )
+{
+    if ( m_source ) removeConstraints( m_source, mapToSource( constraints ) );
+}
+
 void ConstraintProxy::slotLayoutChanged()
 {
     copyFromSource();
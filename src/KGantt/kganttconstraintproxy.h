@@ -45,14 +45,20 @@ namespace KGantt {
 
         void slotSourceConstraintAdded( const KGantt::Constraint& );
         void slotSourceConstraintRemoved( const KGantt::Constraint& );
+        void slotSourceConstraintsAdded( const QList<KGantt::Constraint>& );
+        void slotSourceConstraintsRemoved( const QList<KGantt::Constraint>& );
 
         void slotDestinationConstraintAdded( const KGantt::Constraint& );
         void slotDestinationConstraintRemoved( const KGantt::Constraint& );
+        void slotDestinationConstraintsAdded( const QList<KGantt::Constraint>& );
+        void slotDestinationConstraintsRemoved( const QList<KGantt::Constraint>& );
 
         void slotLayoutChanged();
 
     private:
         void copyFromSource();
+        QList<Constraint> mapFromSource( const QList<Constraint>& constraints ) const;
+        QList<Constraint> mapToSource( const QList<Constraint>& constraints ) const;
 
         QPointer<QAbstractProxyModel> m_proxy;
         QPointer<ConstraintModel> m_source;
@@ -104,6 +104,10 @@ void ForwardingProxyModel::setSourceModel( QAbstractItemModel* model )
              this, SLOT(sourceRowsAboutToBeRemoved(QModelIndex,int,int)) );
     connect( model,  SIGNAL(rowsRemoved(QModelIndex,int,int)),
              this, SLOT(sourceRowsRemoved(QModelIndex,int,int)) );
+    connect( model,  SIGNAL(rowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)),
+             this, SLOT(sourceRowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)) );
+    connect( model,  SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+             this, SLOT(sourceRowsMoved(QModelIndex,int,int,QModelIndex,int)) );
 }
 
 
@@ -208,6 +212,25 @@ void ForwardingProxyModel::sourceRowsRemoved( const QModelIndex& parentIdx, int
 }
 
 
+void ForwardingProxyModel::sourceRowsAboutToBeMoved( const QModelIndex& sourceParent, int start, int end,
+                                                     const QModelIndex& destinationParent, int destinationRow )
+{
+    beginMoveRows( mapFromSource( sourceParent ), start, end, mapFromSource( destinationParent ), destinationRow );
+}
+
+
+void ForwardingProxyModel::sourceRowsMoved( const QModelIndex& sourceParent, int start, int end,
+                                            const QModelIndex& destinationParent, int destinationRow )
+{
+    Q_UNUSED( sourceParent );
+    Q_UNUSED( start );
+    Q_UNUSED( end );
+    Q_UNUSED( destinationParent );
+    Q_UNUSED( destinationRow );
+    endMoveRows();
+}
+
+
 int ForwardingProxyModel::rowCount( const QModelIndex& idx ) const
 {
     return sourceModel()->rowCount( mapToSource( idx ) );
@@ -122,6 +122,20 @@ namespace KGantt {
          * \sa QAbstractItemModel::rowsRemoved()
          */
         virtual void sourceRowsRemoved( const QModelIndex&, int start, int end );
+
+        /*! Called just before rows are moved in the source model.
+         * Subclasses that handle moves connect to the signal themselves.
+         * \sa QAbstractItemModel::rowsAboutToBeMoved()
+         */
+        void sourceRowsAboutToBeMoved( const QModelIndex& sourceParent, int start, int end,
+                                       const QModelIndex& destinationParent, int destinationRow );
+
+        /*! Called after rows have been moved in the source model.
+         * Subclasses that handle moves connect to the signal themselves.
+         * \sa QAbstractItemModel::rowsMoved()
+         */
+        void sourceRowsMoved( const QModelIndex& sourceParent, int start, int end,
+                              const QModelIndex& destinationParent, int destinationRow );
     };
 }
 
@@ -306,6 +306,14 @@ void GraphicsItem::updateItem( const Span& rowGeometry, const QPersistentModelIn
     //updateConstraintItems();
 }
 
+/* Moves the item along with its row, without looking at the model */
+void GraphicsItem::moveVertically( qreal dy )
+{
+    Updater updater( &m_isupdating );
+    setPos( pos() + QPointF( 0., dy ) );
+    updateConstraintItems();
+}
+
 QVariant GraphicsItem::itemChange( GraphicsItemChange change, const QVariant& value )
 {
     if ( !isUpdating() && change==ItemPositionChange && scene() ) {
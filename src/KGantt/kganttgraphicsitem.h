@@ -41,6 +41,7 @@ namespace KGantt {
         /*reimp (non-virtual)*/ GraphicsScene* scene() const;
 
         void updateItem( const Span& rowgeometry, const QPersistentModelIndex& idx );
+        void moveVertically( qreal dy );
 
         //virtual ItemType itemType() const = 0;
 
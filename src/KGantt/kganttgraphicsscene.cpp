@@ -52,6 +52,7 @@ GraphicsScene::Private::Private( GraphicsScene* _q )
       itemDelegate( new ItemDelegate( _q ) ),
       rowController( nullptr ),
       readOnly( false ),
+      recycleItems( false ),
       isPrinting( false ),
       drawColumnLabels( true ),
       labelsWidth( 0.0 ),
@@ -63,17 +64,24 @@ GraphicsScene::Private::Private( GraphicsScene* _q )
 
 GraphicsScene::Private::~Private()
 {
+    qDeleteAll( itemPool );
     delete grid;
 }
 
 void GraphicsScene::Private::clearConstraintItems()
 {
-    for(ConstraintGraphicsItem *citem : qAsConst(constraintItems)) {
-        // remove constraint from items first
-        for(GraphicsItem *item : qAsConst(items)) {
-            item->removeStartConstraint(citem);
-            item->removeEndConstraint(citem);
+    // remove constraints from items first
+    for(GraphicsItem *item : qAsConst(items)) {
+        const QList<ConstraintGraphicsItem*> starts = item->startConstraints();
+        for ( ConstraintGraphicsItem* citem : starts ) {
+            item->removeStartConstraint( citem );
         }
+        const QList<ConstraintGraphicsItem*> ends = item->endConstraints();
+        for ( ConstraintGraphicsItem* citem : ends ) {
+            item->removeEndConstraint( citem );
+        }
+    }
+    for(ConstraintGraphicsItem *citem : qAsConst(constraintItems)) {
         q->removeItem(citem);
         delete citem;
     }
@@ -91,6 +99,11 @@ void GraphicsScene::Private::resetConstraintItems()
     q->updateItems();
 }
 
+GraphicsScene::Private::ConstraintKey GraphicsScene::Private::constraintKey( const Constraint& c )
+{
+    return ConstraintKey( c.startIndex(), c.endIndex() );
+}
+
 void GraphicsScene::Private::createConstraintItem( const Constraint& c )
 {
     GraphicsItem* sitem = q->findItem( summaryHandlingModel->mapFromSource( c.startIndex() ) );
@@ -100,13 +113,24 @@ void GraphicsScene::Private::createConstraintItem( const Constraint& c )
         ConstraintGraphicsItem* citem = new ConstraintGraphicsItem( c );
         sitem->addStartConstraint( citem );
         eitem->addEndConstraint( citem );
-        constraintItems.append( citem );
+        insertConstraintItem( citem );
         q->addItem( citem );
     }
 
     //q->insertConstraintItem( c, citem );
 }
 
+// There is one item per constraint, an item left for the same endpoints is replaced
+void GraphicsScene::Private::insertConstraintItem( ConstraintGraphicsItem* citem )
+{
+    const ConstraintKey key = constraintKey( citem->constraint() );
+    ConstraintGraphicsItem* old = constraintItems.value( key, nullptr );
+    if ( old ) {
+        deleteConstraintItem( old );
+    }
+    constraintItems.insert( key, citem );
+}
+
 // Delete the constraint item, and clean up pointers in the start- and end item
 void GraphicsScene::Private::deleteConstraintItem( ConstraintGraphicsItem *citem )
 {
@@ -123,7 +147,14 @@ void GraphicsScene::Private::deleteConstraintItem( ConstraintGraphicsItem *citem
     if ( item ) {
         item->removeEndConstraint( citem );
     }
-    constraintItems.removeAt(constraintItems.indexOf(citem));
+    QHash<ConstraintKey,ConstraintGraphicsItem*>::iterator it = constraintItems.find( constraintKey( c ) );
+    if ( it == constraintItems.end() || *it != citem ) {
+        // an endpoint was removed, so the key is not what it was
+        it = std::find( constraintItems.begin(), constraintItems.end(), citem );
+    }
+    if ( it != constraintItems.end() ) {
+        constraintItems.erase( it );
+    }
     delete citem;
 }
 
@@ -134,28 +165,14 @@ void GraphicsScene::Private::deleteConstraintItem( const Constraint& c )
 
 ConstraintGraphicsItem* GraphicsScene::Private::findConstraintItem( const Constraint& c ) const
 {
-    GraphicsItem* item = items.value( summaryHandlingModel->mapFromSource( c.startIndex() ), nullptr );
-    if ( item ) {
-        const QList<ConstraintGraphicsItem*> clst = item->startConstraints();
-        QList<ConstraintGraphicsItem*>::const_iterator it = clst.begin();
-        for ( ; it != clst.end() ; ++it ) {
-            if ( c.compareIndexes((*it)->constraint()) )
-                break;
-        }
-        if ( it != clst.end() ) {
-            return *it;
-        }
+    const ConstraintKey key = constraintKey( c );
+    ConstraintGraphicsItem* citem = constraintItems.value( key, nullptr );
+    if ( citem || ( key.first.isValid() && key.second.isValid() ) ) {
+        return citem;
     }
-    item = items.value( summaryHandlingModel->mapFromSource( c.endIndex() ), nullptr );
-    if ( item ) {
-        const QList<ConstraintGraphicsItem*> clst = item->endConstraints();
-        QList<ConstraintGraphicsItem*>::const_iterator it = clst.begin();
-        for ( ; it != clst.end() ; ++it ) {
-            if ( c.compareIndexes( (*it)->constraint() ) )
-                break;
-        }
-        if ( it != clst.end() ) {
-            return *it;
+    for ( ConstraintGraphicsItem* item : constraintItems ) {
+        if ( c.compareIndexes( item->constraint() ) ) {
+            return item;
         }
     }
     return nullptr;
@@ -165,14 +182,41 @@ ConstraintGraphicsItem* GraphicsScene::Private::findConstraintItem( const Constr
 void GraphicsScene::Private::clearItems()
 {
     for(GraphicsItem *item : qAsConst(items)) {
-        q->removeItem(item);
-        delete item;
+        releaseItem(item);
     }
     items.clear();
     // do last to avoid cleaning up items
     clearConstraintItems();
 }
 
+// Deletes the item, or puts it into the pool if items are recycled
+void GraphicsScene::Private::releaseItem( GraphicsItem* item )
+{
+    // a recycled item must not point to constraint items which are deleted later
+    const QList<ConstraintGraphicsItem*> starts = item->startConstraints();
+    for ( ConstraintGraphicsItem* citem : starts ) {
+        item->removeStartConstraint( citem );
+    }
+    const QList<ConstraintGraphicsItem*> ends = item->endConstraints();
+    for ( ConstraintGraphicsItem* citem : ends ) {
+        item->removeEndConstraint( citem );
+    }
+    // an item in the middle of a drag is not reused for another index
+    const bool busy = item == dragSource || item == q->mouseGrabberItem();
+    if ( item == dragSource ) {
+        dragSource = nullptr;
+    }
+    if ( !recycleItems || busy || itemPool.size() >= maxPooledItems ) {
+        q->removeItem( item );
+        delete item;
+        return;
+    }
+    item->setSelected( false );
+    q->removeItem( item );
+    item->setIndex( QPersistentModelIndex() );
+    itemPool.append( item );
+}
+
 AbstractGrid *GraphicsScene::Private::getGrid()
 {
     if (grid.isNull()) {
@@ -278,6 +322,10 @@ void GraphicsScene::setConstraintModel( ConstraintModel* cm )
              this, SLOT(slotConstraintAdded(KGantt::Constraint)) );
     connect( cm, SIGNAL(constraintRemoved(KGantt::Constraint)),
              this, SLOT(slotConstraintRemoved(KGantt::Constraint)) );
+    connect( cm, SIGNAL(constraintsAdded(QList<KGantt::Constraint>)),
+             this, SLOT(slotConstraintsAdded(QList<KGantt::Constraint>)) );
+    connect( cm, SIGNAL(constraintsRemoved(QList<KGantt::Constraint>)),
+             this, SLOT(slotConstraintsRemoved(QList<KGantt::Constraint>)) );
     d->resetConstraintItems();
 }
 
@@ -358,6 +406,20 @@ bool GraphicsScene::isReadOnly() const
     return d->readOnly;
 }
 
+void GraphicsScene::setItemRecyclingEnabled( bool enable )
+{
+    d->recycleItems = enable;
+    if ( !enable ) {
+        qDeleteAll( d->itemPool );
+        d->itemPool.clear();
+    }
+}
+
+bool GraphicsScene::isItemRecyclingEnabled() const
+{
+    return d->recycleItems;
+}
+
 /* Returns the index with column=0 fromt the
  * same row as idx and with the same parent.
  * This is used to traverse the tree-structure
@@ -402,6 +464,12 @@ GraphicsItem* GraphicsScene::createItem( ItemType type ) const
     return v->createItem(type);
 #else
     Q_UNUSED(type)
+    if ( !d->itemPool.isEmpty() ) {
+        GraphicsItem* item = d->itemPool.takeLast();
+        // updateItem() hides the items of collapsed multi rows
+        item->show();
+        return item;
+    }
     return new GraphicsItem;
 #endif
 }
@@ -467,6 +535,10 @@ void GraphicsScene::updateRow( const QModelIndex& rowidx )
                 item = createItem( static_cast<ItemType>( itemtype ) );
                 item->setIndex( idx );
                 insertItem(idx, item);
+                // rows may get their items long after the selection was made
+                if ( d->selectionModel && d->selectionModel->model() == sidx.model() ) {
+                    item->setSelected( d->selectionModel->isSelected( sidx ) );
+                }
             }
             const Span span = rowController()->rowGeometry( sidx );
             item->updateItem( span, idx );
@@ -490,7 +562,7 @@ void GraphicsScene::insertItem( const QPersistentModelIndex& idx, GraphicsItem*
                 ConstraintGraphicsItem* citem = new ConstraintGraphicsItem( c );
                 item->addStartConstraint( citem );
                 other_item->addEndConstraint( citem );
-                d->constraintItems.append( citem );
+                d->insertConstraintItem( citem );
                 addItem( citem );
             } else if ( c.endIndex() == sidx ) {
                 other_idx = c.startIndex();
@@ -499,7 +571,7 @@ void GraphicsScene::insertItem( const QPersistentModelIndex& idx, GraphicsItem*
                 ConstraintGraphicsItem* citem = new ConstraintGraphicsItem( c );
                 other_item->addStartConstraint( citem );
                 item->addEndConstraint( citem );
-                d->constraintItems.append( citem );
+                d->insertConstraintItem( citem );
                 addItem( citem );
             } else {
                 assert( 0 ); // Impossible
@@ -531,7 +603,7 @@ void GraphicsScene::removeItem( const QModelIndex& idx )
             }
         }
         // Get rid of the item
-        delete item;
+        d->releaseItem( item );
     }
 }
 
@@ -583,6 +655,32 @@ void GraphicsScene::deleteSubtree( const QModelIndex& _idx )
 }
 
 
+/* Moves the items at or below y by the distance their rows have moved,
+ * after rows above them were inserted, removed, expanded or collapsed.
+ * All of them moved by the same distance, so it is looked up for one
+ * row only and the items do not read the model again.
+ */
+void GraphicsScene::moveItemsBelow( qreal y )
+{
+    if ( !rowController() ) return;
+    qreal dy = 0.;
+    for ( GraphicsItem* item : qAsConst( d->items ) ) {
+        // items of rows inside collapsed multi items do not sit in their own row
+        if ( item->pos().y() < y || !item->isVisible() ) continue;
+        const QModelIndex sidx = summaryHandlingModel()->mapToSource( item->index() );
+        if ( !rowController()->isRowVisible( sidx ) ) continue;
+        dy = rowController()->rowGeometry( sidx ).start() - item->pos().y();
+        break;
+    }
+    if ( qFuzzyIsNull( dy ) ) return;
+
+    for ( GraphicsItem* item : qAsConst( d->items ) ) {
+        if ( item->pos().y() >= y ) {
+            item->moveVertically( dy );
+        }
+    }
+}
+
 ConstraintGraphicsItem* GraphicsScene::findConstraintItem( const Constraint& c ) const
 {
     return d->findConstraintItem( c );
@@ -598,6 +696,20 @@ void GraphicsScene::slotConstraintRemoved( const KGantt::Constraint& c )
     d->deleteConstraintItem( c );
 }
 
+void GraphicsScene::slotConstraintsAdded( const QList<KGantt::Constraint>& constraints )
+{
+    for ( const Constraint& c : constraints ) {
+        d->createConstraintItem( c );
+    }
+}
+
+void GraphicsScene::slotConstraintsRemoved( const QList<KGantt::Constraint>& constraints )
+{
+    for ( const Constraint& c : constraints ) {
+        d->deleteConstraintItem( c );
+    }
+}
+
 void GraphicsScene::slotGridChanged()
 {
     updateItems();
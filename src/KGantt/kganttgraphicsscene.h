@@ -73,6 +73,7 @@ namespace KGantt {
         void updateItems();
         void clearItems();
         void deleteSubtree( const QModelIndex& );
+        void moveItemsBelow( qreal y );
 
         ConstraintGraphicsItem* findConstraintItem( const Constraint& ) const;
         QList<ConstraintGraphicsItem*> findConstraintItems( const QModelIndex& idx ) const;
@@ -107,9 +108,18 @@ namespace KGantt {
 
         bool isReadOnly() const;
 
+        /*! Enables or disables recycling of items. When enabled, the items
+         * of removed rows are kept in a pool and handed out again by
+         * createItem() instead of being deleted and created anew. This is
+         * used by GraphicsView when virtualization is enabled.
+         */
+        void setItemRecyclingEnabled( bool enable );
+        bool isItemRecyclingEnabled() const;
+
         void updateRow( const QModelIndex& idx );
 
-        /*! Creates a new item of type type.
+        /*! Creates a new item of type type, or takes one from
+         * the pool if item recycling is enabled.
          */
         GraphicsItem* createItem( ItemType type ) const;
 
@@ -200,6 +210,8 @@ namespace KGantt {
         /* slots for ConstraintModel */
         void slotConstraintAdded( const KGantt::Constraint& );
         void slotConstraintRemoved( const KGantt::Constraint& );
+        void slotConstraintsAdded( const QList<KGantt::Constraint>& );
+        void slotConstraintsRemoved( const QList<KGantt::Constraint>& );
         void slotGridChanged();
         void slotSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected);
         void selectionModelChanged(QAbstractItemModel *);
@@ -11,6 +11,8 @@
 
 #include <QPersistentModelIndex>
 #include <QHash>
+#include <QPair>
+#include <QVector>
 #include <QPointer>
 #include <QItemSelectionModel>
 #include <QAbstractProxyModel>
@@ -33,17 +35,23 @@ namespace KGantt {
         void deleteConstraintItem( ConstraintGraphicsItem* citem );
         void deleteConstraintItem( const Constraint& c );
         ConstraintGraphicsItem* findConstraintItem( const Constraint& c ) const;
+        void insertConstraintItem( ConstraintGraphicsItem* citem );
+
+        /* the endpoints of a constraint, they follow their rows */
+        typedef QPair<QPersistentModelIndex,QPersistentModelIndex> ConstraintKey;
+        static ConstraintKey constraintKey( const Constraint& c );
 
 	void recursiveUpdateMultiItem( const Span& span, const QModelIndex& idx );
 
         void clearItems();
+        void releaseItem( GraphicsItem* item );
         AbstractGrid *getGrid();
         const AbstractGrid *getGrid() const;
 
         GraphicsScene* q;
 
         QHash<QPersistentModelIndex,GraphicsItem*> items;
-        QList<ConstraintGraphicsItem*> constraintItems;
+        QHash<ConstraintKey,ConstraintGraphicsItem*> constraintItems;
         GraphicsItem* dragSource;
 
         QPointer<ItemDelegate> itemDelegate;
@@ -52,6 +60,11 @@ namespace KGantt {
         QPointer<AbstractGrid> grid;
         bool readOnly;
 
+        /* items of removed rows, see setItemRecyclingEnabled() */
+        static const int maxPooledItems = 1024;
+        bool recycleItems;
+        mutable QVector<GraphicsItem*> itemPool;
+
         /* printing related members */
         bool isPrinting;
         bool drawColumnLabels;
@@ -287,7 +287,9 @@ void HeaderWidget::contextMenuEvent( QContextMenuEvent* event )
 }
 
 GraphicsView::Private::Private( GraphicsView* _q )
-  : q( _q ), rowcontroller(nullptr), headerwidget( _q )
+  : q( _q ), rowcontroller(nullptr), headerwidget( _q ),
+    virtualized( false ), overscan( 10 ), updatingVisibleRows( false ),
+    removingVisibleRows( false ), removedRowsTop( 0. )
 {
 }
 
@@ -304,6 +306,118 @@ void GraphicsView::Private::updateHeaderGeometry()
                               rowcontroller->headerHeight() );
 }
 
+QRectF GraphicsView::Private::itemsExtent()
+{
+    QRectF r = scene.itemsBoundingRect();
+    if ( virtualized ) {
+        // items come and go while scrolling, the scene must not shrink meanwhile
+        r = r.united( knownExtent );
+        knownExtent = r;
+    }
+    return r;
+}
+
+/* Creates the items of the rows in the viewport and the overscan, and of
+ * the rows they have constraints with. The items of all other rows are
+ * recycled.
+ */
+void GraphicsView::Private::updateVisibleRows()
+{
+    if ( !virtualized || updatingVisibleRows || !q->model() || !rowcontroller ) {
+        return;
+    }
+    updatingVisibleRows = true;
+
+    const QRectF exposed = q->mapToScene( q->viewport()->rect() ).boundingRect();
+    QSet<QPersistentModelIndex> rows;
+
+    QModelIndex idx = rowcontroller->indexAt( qMax( 0, static_cast<int>( exposed.top() ) ) );
+    for ( int i = 0; i < overscan && idx.isValid(); ++i ) {
+        const QModelIndex above = rowcontroller->indexAbove( idx );
+        if ( !above.isValid() ) break;
+        idx = above;
+    }
+    int rowsBelow = 0;
+    while ( idx.isValid() && rowcontroller->isRowVisible( idx ) ) {
+        if ( rowcontroller->rowGeometry( idx ).start() > exposed.bottom() && ++rowsBelow > overscan ) {
+            break;
+        }
+        rows.insert( idx.sibling( idx.row(), 0 ) );
+        idx = rowcontroller->indexBelow( idx );
+    }
+
+    // constraints are only shown if the items at both ends exist
+    if ( ConstraintModel* cmodel = scene.constraintModel() ) {
+        const QList<QPersistentModelIndex> inView = rows.values();
+        for ( const QPersistentModelIndex& row : inView ) {
+            const int columns = q->model()->columnCount( row.parent() );
+            for ( int col = 0; col < columns; ++col ) {
+                const QModelIndex cidx = row.sibling( row.row(), col );
+                const QList<Constraint> clst = cmodel->constraintsForIndex( cidx );
+                for ( const Constraint& c : clst ) {
+                    const QModelIndex other = c.startIndex() == cidx ? c.endIndex() : c.startIndex();
+                    if ( other.isValid() && rowcontroller->isRowVisible( other ) ) {
+                        rows.insert( other.sibling( other.row(), 0 ) );
+                    }
+                }
+            }
+        }
+    }
+
+    // the items the user is dragging or pressing on must not go away under the mouse,
+    // together with the rows showing them, e.g. a collapsed multi row
+    QAbstractProxyModel* summaryModel = scene.summaryHandlingModel();
+    const GraphicsItem* busyItems[] = { qgraphicsitem_cast<GraphicsItem*>( scene.mouseGrabberItem() ), scene.dragSource() };
+    for ( const GraphicsItem* item : busyItems ) {
+        if ( !item || !item->index().isValid() ) {
+            continue;
+        }
+        for ( QModelIndex idx = summaryModel->mapToSource( item->index() ); idx.isValid(); idx = idx.parent() ) {
+            const QPersistentModelIndex row = idx.sibling( idx.row(), 0 );
+            if ( visibleRows.contains( row ) ) {
+                rows.insert( row );
+            }
+        }
+    }
+
+    const QList<QPersistentModelIndex> current = visibleRows.values();
+    for ( const QPersistentModelIndex& row : current ) {
+        if ( !rows.contains( row ) ) {
+            if ( row.isValid() ) {
+                releaseRow( row );
+            }
+            visibleRows.remove( row );
+        }
+    }
+    for ( const QPersistentModelIndex& row : qAsConst( rows ) ) {
+        if ( !visibleRows.contains( row ) ) {
+            q->updateRow( row );
+        }
+    }
+
+    q->updateSceneRect();
+    updatingVisibleRows = false;
+}
+
+/* Removes the items of the row idx, a column 0 index of model() */
+void GraphicsView::Private::releaseRow( const QModelIndex& idx )
+{
+    QAbstractProxyModel* summaryModel = scene.summaryHandlingModel();
+    const QModelIndex sidx = summaryModel->mapFromSource( idx );
+    if ( !sidx.isValid() ) {
+        return;
+    }
+    if ( sidx.data( ItemTypeRole ).toInt() == TypeMulti && !rowcontroller->isRowExpanded( idx ) ) {
+        // the row shows the items of its children
+        scene.deleteSubtree( sidx );
+        return;
+    }
+    const QModelIndex parent = sidx.parent();
+    for ( int col = 0; col < summaryModel->columnCount( parent ); ++col ) {
+        scene.removeItem( summaryModel->index( sidx.row(), col, parent ) );
+    }
+}
+
 void GraphicsView::Private::slotGridChanged()
 {
     updateHeaderGeometry();
@@ -318,10 +432,20 @@ void GraphicsView::Private::slotHorizontalScrollValueChanged( int val )
     headerwidget.scrollTo( val-q->horizontalScrollBar()->minimum()+static_cast<int>( viewRect.left() ) );
 }
 
+void GraphicsView::Private::slotVerticalScrollValueChanged( int val )
+{
+    Q_UNUSED( val );
+    updateVisibleRows();
+}
+
 void GraphicsView::Private::slotColumnsInserted( const QModelIndex& parent,  int start, int end )
 {
     Q_UNUSED( start );
     Q_UNUSED( end );
+    if ( virtualized ) {
+        q->updateScene();
+        return;
+    }
     QModelIndex idx = scene.model()->index( 0, 0, scene.summaryHandlingModel()->mapToSource( parent ) );
     do {
         scene.updateRow( scene.summaryHandlingModel()->mapFromSource( idx ) );
@@ -344,28 +468,100 @@ void GraphicsView::Private::slotDataChanged( const QModelIndex& topLeft, const Q
     //qDebug() << "GraphicsView::slotDataChanged("<<topLeft<<bottomRight<<")";
     const QModelIndex parent = topLeft.parent();
     for ( int row = topLeft.row(); row <= bottomRight.row(); ++row ) {
-        scene.updateRow( scene.summaryHandlingModel()->index( row, 0, parent ) );
+        const QModelIndex idx = scene.summaryHandlingModel()->index( row, 0, parent );
+        if ( virtualized && !scene.findItem( idx ) &&
+             !visibleRows.contains( scene.summaryHandlingModel()->mapToSource( idx ) ) ) {
+            // gets its items when it is scrolled into view
+            continue;
+        }
+        scene.updateRow( idx );
     }
 }
 
 void GraphicsView::Private::slotLayoutChanged()
 {
     //qDebug() << "slotLayoutChanged()";
-    q->updateScene();
+    if ( !q->model() || !rowcontroller ) {
+        q->updateScene();
+        return;
+    }
+    // The items and constraint items belong to persistent indexes, which
+    // survive a layout change. They are reused and only moved.
+    if ( virtualized ) {
+        const QList<QPersistentModelIndex> rows = visibleRows.values();
+        for ( const QPersistentModelIndex& row : rows ) {
+            if ( row.isValid() ) {
+                q->updateRow( row );
+            }
+        }
+        updateVisibleRows();
+    } else {
+        QModelIndex idx = q->model()->index( 0, 0, q->rootIndex() );
+        for ( ; idx.isValid() && rowcontroller->isRowVisible( idx ); idx = rowcontroller->indexBelow( idx ) ) {
+            q->updateRow( idx );
+        }
+    }
+    q->updateSceneRect();
 }
 
 void GraphicsView::Private::slotModelReset()
 {
     //qDebug() << "slotModelReset()";
+    // all persistent indexes are gone, and with them the rows of the items
     q->updateScene();
 }
 
+/* Updates the row of parent, an index of the summary model, after its
+ * children changed. A collapsed multi row shows the items of all rows below it.
+ */
+void GraphicsView::Private::updateParentRow( const QModelIndex& parent )
+{
+    QAbstractProxyModel* summaryModel = scene.summaryHandlingModel();
+    QModelIndex row = parent;
+    for ( QModelIndex idx = parent; idx.isValid(); idx = idx.parent() ) {
+        if ( idx.data( ItemTypeRole ).toInt() == TypeMulti
+             && !rowcontroller->isRowExpanded( summaryModel->mapToSource( idx ) ) ) {
+            row = idx;
+        }
+    }
+    if ( !row.isValid() ) return;
+    if ( scene.findItem( row ) || ( !virtualized && rowcontroller->isRowVisible( summaryModel->mapToSource( row ) ) ) ) {
+        scene.updateRow( row );
+    }
+}
+
+/* Returns true if idx is one of the rows start to end of parent, or below one of them */
+static bool isInRows( QModelIndex idx, const QModelIndex& parent, int start, int end )
+{
+    while ( idx.isValid() && idx.parent() != parent ) {
+        idx = idx.parent();
+    }
+    return idx.isValid() && idx.row() >= start && idx.row() <= end;
+}
+
 void GraphicsView::Private::slotRowsInserted( const QModelIndex& parent,  int start, int end )
 {
-    Q_UNUSED( parent );
-    Q_UNUSED( start );
-    Q_UNUSED( end );
-    q->updateScene(); // TODO: This might be optimised
+    if ( !rowcontroller ) {
+        q->updateScene();
+        return;
+    }
+    QAbstractProxyModel* summaryModel = scene.summaryHandlingModel();
+    const QModelIndex sparent = summaryModel->mapToSource( parent );
+    const QModelIndex first = summaryModel->mapToSource( summaryModel->index( start, 0, parent ) );
+    if ( rowcontroller->isRowVisible( first ) ) {
+        // the rows from the insertion point on moved down
+        scene.moveItemsBelow( rowcontroller->rowGeometry( first ).start() );
+        if ( virtualized ) {
+            updateVisibleRows();
+        } else {
+            for ( QModelIndex idx = first; idx.isValid() && rowcontroller->isRowVisible( idx )
+                  && isInRows( idx, sparent, start, end ); idx = rowcontroller->indexBelow( idx ) ) {
+                q->updateRow( idx );
+            }
+        }
+    }
+    updateParentRow( parent );
+    q->updateSceneRect();
 }
 
 void GraphicsView::Private::removeConstraintsRecursive( QAbstractProxyModel *summaryModel, const QModelIndex& index )
@@ -389,24 +585,37 @@ void GraphicsView::Private::slotRowsAboutToBeRemoved( const QModelIndex& parent,
 {
     //qDebug() << "GraphicsView::Private::slotRowsAboutToBeRemoved("<<parent<<start<<end<<")";
     QAbstractProxyModel *summaryModel = scene.summaryHandlingModel();
+    const QModelIndex first = summaryModel->mapToSource( summaryModel->index( start, 0, parent ) );
+    removingVisibleRows = rowcontroller && rowcontroller->isRowVisible( first );
+    if ( removingVisibleRows ) {
+        removedRowsTop = rowcontroller->rowGeometry( first ).start();
+    }
     for ( int row = start; row <= end; ++row ) {
         for ( int col = 0; col < summaryModel->columnCount( parent ); ++col ) {
             const QModelIndex idx = summaryModel->index( row, col, parent );
             removeConstraintsRecursive( summaryModel, idx );
-            scene.removeItem( idx );
         }
+        scene.deleteSubtree( summaryModel->index( row, 0, parent ) );
     }
 }
 
 void GraphicsView::Private::slotRowsRemoved( const QModelIndex& parent,  int start, int end )
 {
     //qDebug() << "GraphicsView::Private::slotRowsRemoved("<<parent<<start<<end<<")";
-    // TODO
-    Q_UNUSED( parent );
     Q_UNUSED( start );
     Q_UNUSED( end );
-
-    q->updateScene();
+    if ( !rowcontroller ) {
+        q->updateScene();
+        return;
+    }
+    if ( removingVisibleRows ) {
+        // the items of the removed rows are gone, the rows below moved up
+        removingVisibleRows = false;
+        scene.moveItemsBelow( removedRowsTop );
+        updateVisibleRows();
+    }
+    updateParentRow( parent );
+    q->updateSceneRect();
 }
 
 void GraphicsView::Private::slotItemClicked( const QModelIndex& idx )
@@ -438,6 +647,8 @@ GraphicsView::GraphicsView( QWidget* parent )
 #endif
     connect( horizontalScrollBar(), SIGNAL(valueChanged(int)),
              this, SLOT(slotHorizontalScrollValueChanged(int)) );
+    connect( verticalScrollBar(), SIGNAL(valueChanged(int)),
+             this, SLOT(slotVerticalScrollValueChanged(int)) );
     connect( &_d->scene, SIGNAL(gridChanged()),
              this, SLOT(slotGridChanged()) );
     connect( &_d->scene, SIGNAL(entered(QModelIndex)),
@@ -621,6 +832,34 @@ bool GraphicsView::isReadOnly() const
 }
 
 
+void GraphicsView::setVirtualizationEnabled( bool enable )
+{
+    if ( enable == d->virtualized ) return;
+    d->virtualized = enable;
+    d->scene.setItemRecyclingEnabled( enable );
+    updateScene();
+}
+
+
+bool GraphicsView::isVirtualizationEnabled() const
+{
+    return d->virtualized;
+}
+
+
+void GraphicsView::setVirtualizationOverscan( int rows )
+{
+    d->overscan = qMax( 0, rows );
+    d->updateVisibleRows();
+}
+
+
+int GraphicsView::virtualizationOverscan() const
+{
+    return d->overscan;
+}
+
+
 void GraphicsView::setHeaderContextMenuPolicy( Qt::ContextMenuPolicy p )
 {
     d->headerwidget.setContextMenuPolicy( p );
@@ -648,7 +887,7 @@ void GraphicsView::addConstraint( const QModelIndex& from,
 void GraphicsView::resizeEvent( QResizeEvent* ev )
 {
     d->updateHeaderGeometry();
-    QRectF r = scene()->itemsBoundingRect();
+    QRectF r = d->itemsExtent();
     // To scroll more to the left than the actual item start, bug #4516
     r.setLeft( qMin<qreal>( 0.0, r.left() ) );
     // TODO: take scrollbars into account (if not always on)
@@ -669,6 +908,7 @@ void GraphicsView::resizeEvent( QResizeEvent* ev )
     scene()->setSceneRect( r );
 
     QGraphicsView::resizeEvent( ev );
+    d->updateVisibleRows();
 }
 
 
@@ -686,12 +926,17 @@ QModelIndex GraphicsView::indexAt( const QPoint& pos ) const
 void GraphicsView::clearItems()
 {
     d->scene.clearItems();
+    d->visibleRows.clear();
 }
 
 
 void GraphicsView::updateRow( const QModelIndex& idx )
 {
     d->scene.updateRow( d->scene.summaryHandlingModel()->mapFromSource( idx ) );
+    if ( d->virtualized && idx.isValid() ) {
+        // released again when it is scrolled out of view
+        d->visibleRows.insert( idx.sibling( idx.row(), 0 ) );
+    }
 }
 
 
@@ -702,7 +947,7 @@ void GraphicsView::updateSceneRect()
      */
     qreal range = horizontalScrollBar()->maximum()-horizontalScrollBar()->minimum();
     const qreal hscroll = horizontalScrollBar()->value()/( range>0?range:1 );
-    QRectF r = d->scene.itemsBoundingRect();
+    QRectF r = d->itemsExtent();
     // To scroll more to the left than the actual item start, bug #4516
     r.setTop( 0. );
     r.setLeft( qMin<qreal>( 0.0, r.left() ) );
@@ -732,6 +977,12 @@ void GraphicsView::updateScene()
     clearItems();
     if ( !model()) return;
     if ( !rowController()) return;
+    if ( d->virtualized ) {
+        d->knownExtent = QRectF();
+        d->updateVisibleRows();
+        scene()->invalidate( QRectF(), QGraphicsScene::BackgroundLayer );
+        return;
+    }
     QModelIndex idx = model()->index( 0, 0, rootIndex() );
     do {
         updateRow( idx );
@@ -759,6 +1010,15 @@ void GraphicsView::deleteSubtree( const QModelIndex& idx )
 }
 
 
+void GraphicsView::moveRowsBelow( const QModelIndex& idx )
+{
+    if ( !rowController() || !idx.isValid() || !rowController()->isRowVisible( idx ) ) return;
+    d->scene.moveItemsBelow( rowController()->rowGeometry( idx ).end() );
+    // rows may have come into view or left it
+    d->updateVisibleRows();
+}
+
+
 void GraphicsView::print( QPrinter* printer, bool drawRowLabels, bool drawColumnLabels )
 {
     d->scene.print( printer, drawRowLabels, drawColumnLabels );
@@ -41,6 +41,7 @@ namespace KGantt {
 
         Q_PRIVATE_SLOT( d, void slotGridChanged() )
         Q_PRIVATE_SLOT( d, void slotHorizontalScrollValueChanged( int ) )
+        Q_PRIVATE_SLOT( d, void slotVerticalScrollValueChanged( int ) )
 
 
         Q_PRIVATE_SLOT( d, void slotHeaderContextMenuRequested( const QPoint& ) )
@@ -112,6 +113,35 @@ namespace KGantt {
          */
         bool isReadOnly() const;
 
+        /*! Enables or disables virtualization. By default the view creates
+         * an item for every row of the model, which takes a lot of time and
+         * memory for models with hundreds of thousands of rows.
+         *
+         * With virtualization enabled, items are only created for the rows
+         * in the viewport, the rows within the overscan above and below it,
+         * and the rows connected to those by constraints. Items are created
+         * as the view is scrolled and the items of rows scrolled out of view
+         * are recycled. The height of the scene is taken from the
+         * AbstractRowController instead of the items.
+         *
+         * \see setVirtualizationOverscan
+         */
+        void setVirtualizationEnabled( bool enable );
+
+        /*!\returns true if virtualization is enabled
+         */
+        bool isVirtualizationEnabled() const;
+
+        /*! Sets the number of rows above and below the viewport which get
+         * items when virtualization is enabled, so that they need not be
+         * created while scrolling by a few rows. The default is 10.
+         */
+        void setVirtualizationOverscan( int rows );
+
+        /*!\returns the number of rows with items outside the viewport
+         */
+        int virtualizationOverscan() const;
+
         /*! Sets the context menu policy for the header. The default value
          * Qt::DefaultContextMenu results in a standard context menu on the header
          * that allows the user to set the scale and zoom.
@@ -176,6 +206,14 @@ namespace KGantt {
         /*! \internal */
         void deleteSubtree( const QModelIndex& );
 
+        /*! \internal
+         * Moves the items of the rows below \a idx to where the row
+         * controller places them now, after rows right below \a idx were
+         * expanded or collapsed. Unlike updateRow() this does not read
+         * the model.
+         */
+        void moveRowsBelow( const QModelIndex& idx );
+
         /*! Print the Gantt chart using \a printer. If \a drawRowLabels
          * is true (the default), each row will have it's label printed
          * on the left side. If \a drawColumnLabels is true (the
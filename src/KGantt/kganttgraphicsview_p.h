@@ -13,7 +13,9 @@
 #include "kganttgraphicsscene.h"
 #include "kganttdatetimegrid.h"
 
+#include <QPersistentModelIndex>
 #include <QPointer>
+#include <QSet>
 
 namespace KGantt {
     class HeaderWidget : public QWidget {
@@ -47,9 +49,17 @@ namespace KGantt {
         ~Private();
 
         void updateHeaderGeometry();
+        QRectF itemsExtent();
+
+        /* virtualization */
+        void updateVisibleRows();
+        void releaseRow( const QModelIndex& idx );
+
+        void updateParentRow( const QModelIndex& parent );
 
         void slotGridChanged();
         void slotHorizontalScrollValueChanged( int val );
+        void slotVerticalScrollValueChanged( int val );
 
         /* slots for QAbstractItemModel signals */
         void slotColumnsInserted( const QModelIndex& parent,  int start, int end );
@@ -72,6 +82,18 @@ namespace KGantt {
         AbstractRowController* rowcontroller;
         HeaderWidget headerwidget;
         GraphicsScene scene;
+
+        bool virtualized;
+        int overscan;
+        bool updatingVisibleRows;
+        /* rows with items, as column 0 indexes of model() */
+        QSet<QPersistentModelIndex> visibleRows;
+        /* the horizontal extent of the items seen since the last updateScene() */
+        QRectF knownExtent;
+
+        /* where the rows being removed started, if they were visible */
+        bool removingVisibleRows;
+        qreal removedRowsTop;
     };
 }
 
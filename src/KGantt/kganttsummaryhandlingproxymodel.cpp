@@ -19,14 +19,62 @@ using namespace KGantt;
 
 typedef ForwardingProxyModel BASE;
 
+SummaryHandlingProxyModel::Private::TimeSpan SummaryHandlingProxyModel::Private::Summary::span() const
+{
+    if ( starts.isEmpty() ) return TimeSpan();
+    return qMakePair( starts.firstKey(), ends.lastKey() );
+}
+
+void SummaryHandlingProxyModel::Private::Summary::insertChildren( int first, const QVector<TimeSpan>& spans )
+{
+    children.insert( first, spans.size(), TimeSpan() );
+    for ( int i = 0; i < spans.size(); ++i ) {
+        children[first + i] = spans[i];
+        add( spans[i] );
+    }
+}
+
+void SummaryHandlingProxyModel::Private::Summary::removeChildren( int first, int last )
+{
+    for ( int i = first; i <= last; ++i ) {
+        remove( children[i] );
+    }
+    children.remove( first, last - first + 1 );
+}
+
+void SummaryHandlingProxyModel::Private::Summary::setChild( int row, const TimeSpan& span )
+{
+    remove( children[row] );
+    children[row] = span;
+    add( span );
+}
+
+void SummaryHandlingProxyModel::Private::Summary::add( const TimeSpan& span )
+{
+    if ( span.first.isNull() ) return;
+    ++starts[span.first];
+    ++ends[span.second];
+}
+
+void SummaryHandlingProxyModel::Private::Summary::remove( const TimeSpan& span )
+{
+    if ( span.first.isNull() ) return;
+    QMap<QDateTime,int>::iterator it = starts.find( span.first );
+    assert( it != starts.end() );
+    if ( --*it == 0 ) starts.erase( it );
+    it = ends.find( span.second );
+    assert( it != ends.end() );
+    if ( --*it == 0 ) ends.erase( it );
+}
+
 bool SummaryHandlingProxyModel::Private::cacheLookup( const QModelIndex& idx,
                                                       QPair<QDateTime,QDateTime>* result ) const
 {
     //qDebug() << "cacheLookup("<<idx<<"), cache has " << cached_summary_items.count() << "items";
-    QHash<QModelIndex,QPair<QDateTime,QDateTime> >::const_iterator it =
+    QHash<QPersistentModelIndex,Summary>::const_iterator it =
         cached_summary_items.constFind( idx );
     if ( it != cached_summary_items.constEnd() ) {
-        *result = *it;
+        *result = it->span();
         return true;
     } else {
         return false;
@@ -37,55 +85,178 @@ void SummaryHandlingProxyModel::Private::insertInCache( const SummaryHandlingPro
                                                         const QModelIndex& sourceIdx ) const
 {
     QAbstractItemModel* sourceModel = model->sourceModel();
-    const QModelIndex& mainIdx = sourceIdx;
-    QDateTime st;
-    QDateTime et;
-
-    for ( int r = 0; r < sourceModel->rowCount( mainIdx ); ++r ) {
-        QModelIndex pdIdx = model->mapFromSource( sourceModel->index( r, 0, mainIdx ) );
+    QVector<TimeSpan> spans;
+    const int rows = sourceModel->rowCount( sourceIdx );
+    spans.reserve( rows );
+    for ( int r = 0; r < rows; ++r ) {
         /* The probably results in recursive calls here */
-	QVariant tmpsv = model->data( pdIdx, StartTimeRole );
-	QVariant tmpev = model->data( pdIdx, EndTimeRole );
-	if ( !tmpsv.canConvert( QVariant::DateTime ) ||
-	    !tmpev.canConvert( QVariant::DateTime ) ) {
-            qDebug() << "Skipping item " << sourceIdx << " because it doesn't contain QDateTime";
-            continue;
-        }
+        spans.append( childSpan( model, sourceModel->index( r, 0, sourceIdx ) ) );
+    }
+    Summary summary;
+    summary.insertChildren( 0, spans );
+    /* Cache before writing back, the source signals the change */
+    cached_summary_items.insert( sourceIdx, summary );
+    writeBack( model, sourceIdx, summary.span() );
+}
 
-        // check for valid datetimes
-        if ( tmpsv.type() == QVariant::DateTime && !tmpsv.value<QDateTime>().isValid()) continue;
-        if ( tmpev.type() == QVariant::DateTime && !tmpev.value<QDateTime>().isValid()) continue;
-
-	// We need to test for empty strings to
-	// avoid a stupid Qt warning
-	if ( tmpsv.type() == QVariant::String && tmpsv.value<QString>().isEmpty()) continue;
-	if ( tmpev.type() == QVariant::String && tmpev.value<QString>().isEmpty()) continue;
-        QDateTime tmpst = tmpsv.toDateTime();
-        QDateTime tmpet = tmpev.toDateTime();
-        if ( st.isNull() || st > tmpst ) st = tmpst;
-        if ( et.isNull() || et < tmpet ) et = tmpet;
+void SummaryHandlingProxyModel::Private::removeFromCache( const QModelIndex& idx ) const
+{
+    cached_summary_items.remove( idx );
+}
+
+void SummaryHandlingProxyModel::Private::removeSubtreeFromCache( const QAbstractItemModel* model,
+                                                                 const QModelIndex& idx ) const
+{
+    if ( cached_summary_items.isEmpty() ) return;
+    cached_summary_items.remove( idx );
+    if ( !model->hasChildren( idx ) ) return;
+    for ( int r = 0; r < model->rowCount( idx ); ++r ) {
+        removeSubtreeFromCache( model, model->index( r, 0, idx ) );
+    }
+}
+
+void SummaryHandlingProxyModel::Private::clearCache() const
+{
+    cached_summary_items.clear();
+}
+
+SummaryHandlingProxyModel::Private::TimeSpan SummaryHandlingProxyModel::Private::childSpan( const SummaryHandlingProxyModel* model,
+                                                                                           const QModelIndex& sourceIdx ) const
+{
+    const QModelIndex pdIdx = model->mapFromSource( sourceIdx );
+    QVariant tmpsv = model->data( pdIdx, StartTimeRole );
+    QVariant tmpev = model->data( pdIdx, EndTimeRole );
+    if ( !tmpsv.canConvert( QVariant::DateTime ) ||
+         !tmpev.canConvert( QVariant::DateTime ) ) {
+        qDebug() << "Skipping item " << sourceIdx << " because it doesn't contain QDateTime";
+        return TimeSpan();
     }
-    QVariant tmpssv = sourceModel->data( mainIdx, StartTimeRole );
-    QVariant tmpsev = sourceModel->data( mainIdx, EndTimeRole );
+
+    // check for valid datetimes
+    if ( tmpsv.type() == QVariant::DateTime && !tmpsv.value<QDateTime>().isValid()) return TimeSpan();
+    if ( tmpev.type() == QVariant::DateTime && !tmpev.value<QDateTime>().isValid()) return TimeSpan();
+
+    // We need to test for empty strings to
+    // avoid a stupid Qt warning
+    if ( tmpsv.type() == QVariant::String && tmpsv.value<QString>().isEmpty()) return TimeSpan();
+    if ( tmpev.type() == QVariant::String && tmpev.value<QString>().isEmpty()) return TimeSpan();
+    const QDateTime st = tmpsv.toDateTime();
+    const QDateTime et = tmpev.toDateTime();
+    if ( st.isNull() || et.isNull() ) return TimeSpan();
+    return qMakePair( st, et );
+}
+
+void SummaryHandlingProxyModel::Private::writeBack( const SummaryHandlingProxyModel* model,
+                                                    const QModelIndex& sourceIdx,
+                                                    const TimeSpan& span ) const
+{
+    QAbstractItemModel* sourceModel = model->sourceModel();
+    QVariant tmpssv = sourceModel->data( sourceIdx, StartTimeRole );
+    QVariant tmpsev = sourceModel->data( sourceIdx, EndTimeRole );
     if ( tmpssv.canConvert( QVariant::DateTime )
          && !( tmpssv.canConvert( QVariant::String ) && tmpssv.toString().isEmpty() )
-         && tmpssv.toDateTime() != st )
-        sourceModel->setData( mainIdx, st, StartTimeRole );
+         && tmpssv.toDateTime() != span.first )
+        sourceModel->setData( sourceIdx, span.first, StartTimeRole );
     if ( tmpsev.canConvert( QVariant::DateTime )
          && !( tmpsev.canConvert( QVariant::String ) && tmpsev.toString().isEmpty() )
-         && tmpsev.toDateTime() != et )
-        sourceModel->setData( mainIdx, et, EndTimeRole );
-    cached_summary_items[sourceIdx]=qMakePair( st, et );
+         && tmpsev.toDateTime() != span.second )
+        sourceModel->setData( sourceIdx, span.second, EndTimeRole );
 }
 
-void SummaryHandlingProxyModel::Private::removeFromCache( const QModelIndex& idx ) const
+/* The times of the row sourceIdx may have changed: updates the summary
+ * above it, and the summaries above that while their times change too */
+void SummaryHandlingProxyModel::Private::updateChild( const SummaryHandlingProxyModel* model,
+                                                      const QModelIndex& sourceIdx,
+                                                      QVector<QModelIndex>* changed ) const
 {
-    cached_summary_items.remove( idx );
+    const QModelIndex parentIdx = sourceIdx.parent();
+    if ( !parentIdx.isValid() || !cached_summary_items.contains( parentIdx ) ) return;
+    /* Before looking up the parent, this may add to the cache */
+    const TimeSpan span = childSpan( model, sourceIdx );
+    const QHash<QPersistentModelIndex,Summary>::iterator it = cached_summary_items.find( parentIdx );
+    if ( it == cached_summary_items.end() ) return;
+    if ( sourceIdx.row() >= it->children.size() ) {
+        invalidate( parentIdx, changed );
+        return;
+    }
+    const TimeSpan oldSpan = it->span();
+    it->setChild( sourceIdx.row(), span );
+    spanChanged( model, parentIdx, oldSpan, changed );
 }
 
-void SummaryHandlingProxyModel::Private::clearCache() const
+void SummaryHandlingProxyModel::Private::insertChildren( const SummaryHandlingProxyModel* model,
+                                                         const QModelIndex& parentIdx,
+                                                         int start, int end,
+                                                         QVector<QModelIndex>* changed ) const
 {
-    cached_summary_items.clear();
+    if ( !parentIdx.isValid() || !cached_summary_items.contains( parentIdx ) ) return;
+    const QAbstractItemModel* sourceModel = model->sourceModel();
+    QVector<TimeSpan> spans;
+    spans.reserve( end - start + 1 );
+    for ( int r = start; r <= end; ++r ) {
+        spans.append( childSpan( model, sourceModel->index( r, 0, parentIdx ) ) );
+    }
+    const QHash<QPersistentModelIndex,Summary>::iterator it = cached_summary_items.find( parentIdx );
+    if ( it == cached_summary_items.end() ) return;
+    if ( start > it->children.size()
+         || it->children.size() + spans.size() != sourceModel->rowCount( parentIdx ) ) {
+        invalidate( parentIdx, changed );
+        return;
+    }
+    const TimeSpan oldSpan = it->span();
+    it->insertChildren( start, spans );
+    spanChanged( model, parentIdx, oldSpan, changed );
+}
+
+void SummaryHandlingProxyModel::Private::removeChildren( const SummaryHandlingProxyModel* model,
+                                                         const QModelIndex& parentIdx,
+                                                         int start, int end,
+                                                         QVector<QModelIndex>* changed ) const
+{
+    if ( !parentIdx.isValid() ) return;
+    const QHash<QPersistentModelIndex,Summary>::iterator it = cached_summary_items.find( parentIdx );
+    if ( it == cached_summary_items.end() ) return;
+    if ( end >= it->children.size()
+         || it->children.size() - ( end - start + 1 ) != model->sourceModel()->rowCount( parentIdx ) ) {
+        invalidate( parentIdx, changed );
+        return;
+    }
+    const TimeSpan oldSpan = it->span();
+    it->removeChildren( start, end );
+    spanChanged( model, parentIdx, oldSpan, changed );
+}
+
+void SummaryHandlingProxyModel::Private::spanChanged( const SummaryHandlingProxyModel* model,
+                                                      const QModelIndex& sourceIdx,
+                                                      const TimeSpan& oldSpan,
+                                                      QVector<QModelIndex>* changed ) const
+{
+    QHash<QPersistentModelIndex,Summary>::const_iterator it = cached_summary_items.constFind( sourceIdx );
+    if ( it == cached_summary_items.constEnd() || it->span() == oldSpan ) return;
+    changed->append( sourceIdx );
+    updateChild( model, sourceIdx, changed );
+}
+
+/* The cached children of sourceIdx do not match the model anymore,
+ * the summaries from there up are calculated again when asked for */
+void SummaryHandlingProxyModel::Private::invalidate( const QModelIndex& sourceIdx,
+                                                     QVector<QModelIndex>* changed ) const
+{
+    for ( QModelIndex idx = sourceIdx; idx.isValid(); idx = idx.parent() ) {
+        if ( cached_summary_items.remove( idx ) ) changed->append( idx );
+    }
+}
+
+void SummaryHandlingProxyModel::Private::notifyChanged( SummaryHandlingProxyModel* model,
+                                                        const QVector<QModelIndex>& changed ) const
+{
+    for ( const QModelIndex& sourceIdx : changed ) {
+        if ( !sourceIdx.isValid() ) continue;
+        QPair<QDateTime,QDateTime> span;
+        if ( cacheLookup( sourceIdx, &span ) ) writeBack( model, sourceIdx, span );
+        const QModelIndex proxyIdx = model->mapFromSource( sourceIdx );
+        Q_EMIT model->dataChanged( proxyIdx, proxyIdx );
+    }
 }
 
 
@@ -110,6 +281,13 @@ void SummaryHandlingProxyModel::setSourceModel( QAbstractItemModel* model )
 {
     BASE::setSourceModel( model );
     d->clearCache();
+    if ( !model ) return;
+
+    /* After the base class, which starts and ends the move of the proxy rows */
+    connect( model, SIGNAL(rowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)),
+             this, SLOT(slotSourceRowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)) );
+    connect( model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+             this, SLOT(slotSourceRowsMoved()) );
 }
 
 void SummaryHandlingProxyModel::sourceModelReset()
@@ -127,18 +305,18 @@ void SummaryHandlingProxyModel::sourceLayoutChanged()
 void SummaryHandlingProxyModel::sourceDataChanged( const QModelIndex& from, const QModelIndex& to )
 {
     QAbstractItemModel* model = sourceModel();
-    QModelIndex parentIdx = from;
-    do {
-        const QModelIndex& dataIdx = parentIdx;
-        if ( model->data( dataIdx, ItemTypeRole )==TypeSummary ) {
-            //qDebug() << "removing " << parentIdx << "from cache";
+    const QModelIndex parentIdx = from.parent();
+    QVector<QModelIndex> changed;
+    for ( int row = from.row(); row <= to.row(); ++row ) {
+        const QModelIndex dataIdx = model->index( row, 0, parentIdx );
+        if ( !d->isSummary( dataIdx ) ) {
             d->removeFromCache( dataIdx );
-            QModelIndex proxyDataIdx = mapFromSource( dataIdx );
-            Q_EMIT dataChanged( proxyDataIdx, proxyDataIdx );
         }
-    } while ( ( parentIdx=model->parent( parentIdx ) ) != QModelIndex() );
+        d->updateChild( this, dataIdx, &changed );
+    }
 
     BASE::sourceDataChanged( from, to );
+    d->notifyChanged( this, changed );
 }
 
 void SummaryHandlingProxyModel::sourceColumnsAboutToBeInserted( const QModelIndex& parentIdx,
@@ -159,14 +337,59 @@ void SummaryHandlingProxyModel::sourceColumnsAboutToBeRemoved( const QModelIndex
 
 void SummaryHandlingProxyModel::sourceRowsAboutToBeInserted( const QModelIndex & parentIdx, int start, int end )
 {
+    /* The summaries above are updated once the rows are there */
     BASE::sourceRowsAboutToBeInserted( parentIdx, start, end );
-    d->clearCache();
+}
+
+void SummaryHandlingProxyModel::sourceRowsInserted( const QModelIndex & parentIdx, int start, int end )
+{
+    BASE::sourceRowsInserted( parentIdx, start, end );
+    QVector<QModelIndex> changed;
+    d->insertChildren( this, parentIdx, start, end, &changed );
+    d->notifyChanged( this, changed );
 }
 
 void SummaryHandlingProxyModel::sourceRowsAboutToBeRemoved( const QModelIndex & parentIdx, int start, int end )
 {
     BASE::sourceRowsAboutToBeRemoved( parentIdx, start, end );
-    d->clearCache();
+    const QAbstractItemModel* model = sourceModel();
+    for ( int row = start; row <= end; ++row ) {
+        d->removeSubtreeFromCache( model, model->index( row, 0, parentIdx ) );
+    }
+}
+
+void SummaryHandlingProxyModel::sourceRowsRemoved( const QModelIndex & parentIdx, int start, int end )
+{
+    BASE::sourceRowsRemoved( parentIdx, start, end );
+    QVector<QModelIndex> changed;
+    d->removeChildren( this, parentIdx, start, end, &changed );
+    d->notifyChanged( this, changed );
+}
+
+void SummaryHandlingProxyModel::slotSourceRowsAboutToBeMoved( const QModelIndex& sourceParent, int start, int end,
+                                                              const QModelIndex& destinationParent, int destinationRow )
+{
+    Q_UNUSED( start );
+    Q_UNUSED( end );
+    Q_UNUSED( destinationRow );
+    /* The children of both parents are cached by row, the summaries from
+     * there up are calculated again. The moved rows keep their children. */
+    QVector<QModelIndex> changed;
+    d->invalidate( sourceParent, &changed );
+    d->invalidate( destinationParent, &changed );
+    for ( const QModelIndex& idx : qAsConst( changed ) ) {
+        d->moved_summary_items.append( idx );
+    }
+}
+
+void SummaryHandlingProxyModel::slotSourceRowsMoved()
+{
+    QVector<QModelIndex> changed;
+    for ( const QPersistentModelIndex& idx : qAsConst( d->moved_summary_items ) ) {
+        changed.append( idx );
+    }
+    d->moved_summary_items.clear();
+    d->notifyChanged( this, changed );
 }
 
 
@@ -208,18 +431,7 @@ QVariant SummaryHandlingProxyModel::data( const QModelIndex& proxyIndex, int rol
 
 bool SummaryHandlingProxyModel::setData( const QModelIndex& index, const QVariant& value, int role )
 {
-    QAbstractItemModel* model = sourceModel();
-    if ( role==StartTimeRole || role==EndTimeRole ) {
-        QModelIndex parentIdx = mapToSource( index );
-        do {
-            if ( d->isSummary(parentIdx) ) {
-	      //qDebug() << "removing " << parentIdx << "from cache";
-                d->removeFromCache( parentIdx );
-                QModelIndex proxyParentIdx = mapFromSource( parentIdx );
-                Q_EMIT dataChanged( proxyParentIdx, proxyParentIdx );
-            }
-        } while ( ( parentIdx=model->parent( parentIdx ) ) != QModelIndex() );
-    }
+    /* The summaries above are updated when the source model signals the change */
     return BASE::setData( index, value, role );
 }
 
@@ -241,6 +453,61 @@ static std::ostream& operator<<( std::ostream& os, const QDateTime& dt )
     return os;
 }
 
+namespace {
+    /* Summaries with tasks below them, the tasks can be moved */
+    class MoveTestModel : public QAbstractItemModel {
+    public:
+        typedef QPair<QDateTime,QDateTime> Task;
+        QVector<QVector<Task> > summaries;
+
+        QModelIndex index( int row, int column, const QModelIndex& parent = QModelIndex() ) const override
+        {
+            if ( !hasIndex( row, column, parent ) ) return QModelIndex();
+            return createIndex( row, column, quintptr( parent.isValid() ? parent.row() + 1 : 0 ) );
+        }
+        QModelIndex parent( const QModelIndex& idx ) const override
+        {
+            if ( !idx.isValid() || idx.internalId() == 0 ) return QModelIndex();
+            return createIndex( int( idx.internalId() ) - 1, 0, quintptr( 0 ) );
+        }
+        int rowCount( const QModelIndex& parent = QModelIndex() ) const override
+        {
+            if ( !parent.isValid() ) return summaries.size();
+            if ( parent.internalId() == 0 && parent.column() == 0 ) return summaries[parent.row()].size();
+            return 0;
+        }
+        int columnCount( const QModelIndex& = QModelIndex() ) const override { return 1; }
+        QVariant data( const QModelIndex& idx, int role = Qt::DisplayRole ) const override
+        {
+            if ( idx.internalId() == 0 ) {
+                return role == ItemTypeRole ? QVariant( TypeSummary ) : QVariant();
+            }
+            const Task& task = summaries[int( idx.internalId() ) - 1][idx.row()];
+            switch ( role ) {
+            case ItemTypeRole: return TypeTask;
+            case StartTimeRole: return task.first;
+            case EndTimeRole: return task.second;
+            default: return QVariant();
+            }
+        }
+        void setEnd( int summary, int row, const QDateTime& end )
+        {
+            summaries[summary][row].second = end;
+            const QModelIndex idx = index( row, 0, index( summary, 0 ) );
+            Q_EMIT dataChanged( idx, idx );
+        }
+        bool move( int summary, int row, int destinationSummary, int destinationRow )
+        {
+            if ( !beginMoveRows( index( summary, 0 ), row, row, index( destinationSummary, 0 ), destinationRow ) ) return false;
+            const Task task = summaries[summary].takeAt( row );
+            if ( summary == destinationSummary && destinationRow > row ) --destinationRow;
+            summaries[destinationSummary].insert( destinationRow, task );
+            endMoveRows();
+            return true;
+        }
+    };
+}
+
 KDAB_SCOPED_UNITTEST_SIMPLE( KGantt, SummaryHandlingProxyModel, "test" ) {
     SummaryHandlingProxyModel model;
     QStandardItemModel sourceModel;
@@ -280,6 +547,65 @@ KDAB_SCOPED_UNITTEST_SIMPLE( KGantt, SummaryHandlingProxyModel, "test" ) {
     assertEqual( summarystartdt, startdt );
     assertTrue( model.flags( model.index( 0, 0, topidx ) ) & Qt::ItemIsEditable );
     assertFalse( model.flags( topidx ) & Qt::ItemIsEditable );
+
+    /* The summary follows inserted, removed and changed children */
+    QStandardItem* task0 = new QStandardItem( QString::fromLatin1( "Task0" ) );
+    task0->setData( KGantt::TypeTask, KGantt::ItemTypeRole );
+    task0->setData( startdt.addDays( -2 ), KGantt::StartTimeRole );
+    task0->setData( startdt, KGantt::EndTimeRole );
+    topitem->insertRow( 0, task0 );
+    assertEqual( model.data( topidx, KGantt::StartTimeRole ).toDateTime(), startdt.addDays( -2 ) );
+    assertEqual( model.data( topidx, KGantt::EndTimeRole ).toDateTime(), enddt );
+
+    topitem->removeRow( 0 );
+    assertEqual( model.data( topidx, KGantt::StartTimeRole ).toDateTime(), startdt );
+
+    task2->setData( enddt.addDays( 3 ), KGantt::EndTimeRole );
+    assertEqual( model.data( topidx, KGantt::EndTimeRole ).toDateTime(), enddt.addDays( 3 ) );
+    task2->setData( enddt, KGantt::EndTimeRole );
+    assertEqual( model.data( topidx, KGantt::EndTimeRole ).toDateTime(), enddt );
+
+    /* ...and so do the summaries above */
+    QStandardItem* subitem = new QStandardItem( QString::fromLatin1( "Subsummary" ) );
+    subitem->setData( KGantt::TypeSummary, KGantt::ItemTypeRole );
+    topitem->appendRow( subitem );
+    QStandardItem* task3 = new QStandardItem( QString::fromLatin1( "Task3" ) );
+    task3->setData( KGantt::TypeTask, KGantt::ItemTypeRole );
+    task3->setData( startdt, KGantt::StartTimeRole );
+    task3->setData( enddt, KGantt::EndTimeRole );
+    subitem->appendRow( task3 );
+    const QModelIndex subidx = model.index( 2, 0, topidx );
+    assertEqual( model.data( subidx, KGantt::EndTimeRole ).toDateTime(), enddt );
+
+    task3->setData( enddt.addDays( 5 ), KGantt::EndTimeRole );
+    assertEqual( model.data( subidx, KGantt::EndTimeRole ).toDateTime(), enddt.addDays( 5 ) );
+    assertEqual( model.data( topidx, KGantt::EndTimeRole ).toDateTime(), enddt.addDays( 5 ) );
+
+    subitem->removeRow( 0 );
+    assertEqual( model.data( topidx, KGantt::EndTimeRole ).toDateTime(), enddt );
+
+    /* Moved rows are found where they went */
+    MoveTestModel moveModel;
+    moveModel.summaries.resize( 2 );
+    moveModel.summaries[0] << qMakePair( startdt, enddt ) << qMakePair( startdt, enddt.addDays( 4 ) );
+    moveModel.summaries[1] << qMakePair( startdt, enddt.addDays( 1 ) );
+    model.setSourceModel( &moveModel );
+    const QModelIndex sum0 = model.index( 0, 0 );
+    const QModelIndex sum1 = model.index( 1, 0 );
+    assertEqual( model.data( sum0, KGantt::EndTimeRole ).toDateTime(), enddt.addDays( 4 ) );
+    assertEqual( model.data( sum1, KGantt::EndTimeRole ).toDateTime(), enddt.addDays( 1 ) );
+
+    assertTrue( moveModel.move( 0, 1, 0, 0 ) );
+    moveModel.setEnd( 0, 1, enddt.addDays( 2 ) );
+    assertEqual( model.data( sum0, KGantt::EndTimeRole ).toDateTime(), enddt.addDays( 4 ) );
+
+    assertTrue( moveModel.move( 0, 0, 1, 1 ) );
+    assertEqual( model.data( sum0, KGantt::EndTimeRole ).toDateTime(), enddt.addDays( 2 ) );
+    assertEqual( model.data( sum1, KGantt::EndTimeRole ).toDateTime(), enddt.addDays( 4 ) );
+    moveModel.setEnd( 1, 1, enddt.addDays( 3 ) );
+    assertEqual( model.data( sum1, KGantt::EndTimeRole ).toDateTime(), enddt.addDays( 3 ) );
+    moveModel.setEnd( 1, 0, enddt.addDays( 5 ) );
+    assertEqual( model.data( sum1, KGantt::EndTimeRole ).toDateTime(), enddt.addDays( 5 ) );
 }
 
 #endif /* KDAB_NO_UNIT_TESTS */
@@ -70,7 +70,14 @@ namespace KGantt {
         /*reimp*/ void sourceColumnsAboutToBeInserted( const QModelIndex& idx, int start, int end ) override;
         /*reimp*/ void sourceColumnsAboutToBeRemoved( const QModelIndex& idx, int start, int end ) override;
         /*reimp*/ void sourceRowsAboutToBeInserted( const QModelIndex& idx, int start, int end ) override;
+        /*reimp*/ void sourceRowsInserted( const QModelIndex& idx, int start, int end ) override;
         /*reimp*/ void sourceRowsAboutToBeRemoved( const QModelIndex&, int start, int end ) override;
+        /*reimp*/ void sourceRowsRemoved( const QModelIndex&, int start, int end ) override;
+
+    private Q_SLOTS:
+        void slotSourceRowsAboutToBeMoved( const QModelIndex& sourceParent, int start, int end,
+                                           const QModelIndex& destinationParent, int destinationRow );
+        void slotSourceRowsMoved();
     };
 }
 
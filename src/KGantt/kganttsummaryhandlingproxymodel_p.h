@@ -13,24 +13,66 @@
 
 #include <QDateTime>
 #include <QHash>
+#include <QMap>
 #include <QPair>
 #include <QPersistentModelIndex>
+#include <QVector>
 
 namespace KGantt {
     class Q_DECL_HIDDEN SummaryHandlingProxyModel::Private {
     public:
+        typedef QPair<QDateTime,QDateTime> TimeSpan;
+
+        // - the start and end times of the children of a summary, by row, and
+        // how often each time occurs, so that the earliest start and the
+        // latest end are known without looking at all children again
+        // - children without valid start and end times have a null TimeSpan
+        class Summary {
+        public:
+            TimeSpan span() const;
+            void insertChildren( int first, const QVector<TimeSpan>& spans );
+            void removeChildren( int first, int last );
+            void setChild( int row, const TimeSpan& span );
+
+            QVector<TimeSpan> children;
+        private:
+            void add( const TimeSpan& span );
+            void remove( const TimeSpan& span );
+
+            QMap<QDateTime,int> starts;
+            QMap<QDateTime,int> ends;
+        };
+
         bool cacheLookup( const QModelIndex& idx,
                           QPair<QDateTime,QDateTime>* result ) const;
         void insertInCache( const SummaryHandlingProxyModel* model, const QModelIndex& idx ) const;
         void removeFromCache( const QModelIndex& idx ) const;
+        void removeSubtreeFromCache( const QAbstractItemModel* model, const QModelIndex& idx ) const;
         void clearCache() const;
+
+        TimeSpan childSpan( const SummaryHandlingProxyModel* model, const QModelIndex& sourceIdx ) const;
+        void writeBack( const SummaryHandlingProxyModel* model, const QModelIndex& sourceIdx, const TimeSpan& span ) const;
+
+        /* incremental updates, they collect the summaries whose span changed */
+        void updateChild( const SummaryHandlingProxyModel* model, const QModelIndex& sourceIdx,
+                          QVector<QModelIndex>* changed ) const;
+        void insertChildren( const SummaryHandlingProxyModel* model, const QModelIndex& parentIdx,
+                             int start, int end, QVector<QModelIndex>* changed ) const;
+        void removeChildren( const SummaryHandlingProxyModel* model, const QModelIndex& parentIdx,
+                             int start, int end, QVector<QModelIndex>* changed ) const;
+        void spanChanged( const SummaryHandlingProxyModel* model, const QModelIndex& sourceIdx,
+                          const TimeSpan& oldSpan, QVector<QModelIndex>* changed ) const;
+        void invalidate( const QModelIndex& sourceIdx, QVector<QModelIndex>* changed ) const;
+        void notifyChanged( SummaryHandlingProxyModel* model, const QVector<QModelIndex>& changed ) const;
 		
 		inline bool isSummary( const QModelIndex& idx ) const {
 			int typ = idx.data( ItemTypeRole ).toInt();
 			return (typ==TypeSummary) || (typ==TypeMulti);
 		}
 
-        mutable QHash<QModelIndex, QPair<QDateTime, QDateTime> > cached_summary_items;
+        mutable QHash<QPersistentModelIndex, Summary> cached_summary_items;
+        // the summaries invalidated by a move, they are notified when it is done
+        QVector<QPersistentModelIndex> moved_summary_items;
     };
 }
 
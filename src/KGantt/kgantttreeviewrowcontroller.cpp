@@ -13,17 +13,400 @@
 #include <QHeaderView>
 #include <QScrollBar>
 
+#include <algorithm>
 #include <cassert>
 
 using namespace KGantt;
 
 
 
+TreeViewRowController::Private::Private()
+    : treeview( nullptr ), proxy( nullptr ), removalKnown( false ), removedBegin( -1 ), removedEnd( -1 ),
+      valid( false ), changing( 0 )
+{
+}
+
+void TreeViewRowController::Private::setTreeView( HackTreeView* tv )
+{
+    treeview = tv;
+    // connected before anyone else can be, the index has to follow the
+    // tree before the scene asks it where the rows are
+    connect( tv, &QTreeView::expanded, this, &Private::slotExpanded );
+    connect( tv, &QTreeView::collapsed, this, &Private::slotCollapsed );
+    connect( tv->verticalScrollBar(), &QScrollBar::rangeChanged, this, &Private::slotRangeChanged );
+    setModel( tv->model() );
+}
+
+void TreeViewRowController::Private::setModel( QAbstractItemModel* m )
+{
+    if ( model ) {
+        model->disconnect( this );
+    }
+    model = m;
+    changing = 0;
+    invalidate();
+    if ( !m ) return;
+    // rows change between the signals, the tree view is asked directly then
+    connect( m, &QAbstractItemModel::rowsAboutToBeInserted, this, &Private::slotRowsAboutToBeInserted );
+    connect( m, &QAbstractItemModel::rowsInserted, this, &Private::slotRowsInserted );
+    connect( m, &QAbstractItemModel::rowsAboutToBeRemoved, this, &Private::slotRowsAboutToBeRemoved );
+    connect( m, &QAbstractItemModel::rowsRemoved, this, &Private::slotRowsRemoved );
+    connect( m, &QAbstractItemModel::rowsAboutToBeMoved, this, &Private::slotAboutToChange );
+    connect( m, &QAbstractItemModel::rowsMoved, this, &Private::slotChanged );
+    connect( m, &QAbstractItemModel::layoutAboutToBeChanged, this, &Private::slotAboutToChange );
+    connect( m, &QAbstractItemModel::layoutChanged, this, &Private::slotChanged );
+    connect( m, &QAbstractItemModel::modelAboutToBeReset, this, &Private::slotAboutToChange );
+    connect( m, &QAbstractItemModel::modelReset, this, &Private::slotChanged );
+    connect( m, &QAbstractItemModel::dataChanged, this, &Private::slotDataChanged );
+}
+
+bool TreeViewRowController::Private::ensureIndex()
+{
+    if ( treeview->model() != model ) {
+        setModel( treeview->model() );
+    }
+    if ( changing > 0 || !model ) return false;
+    // when all rows fit into the view, walking them is cheap, and the tree
+    // view does not tell when they change
+    if ( treeview->verticalScrollBar()->maximum() <= 0 ) return false;
+    if ( root != treeview->rootIndex() ) {
+        invalidate();
+    }
+    if ( !valid ) {
+        rebuild();
+    }
+    applyPendingRows();
+    return true;
+}
+
+void TreeViewRowController::Private::invalidate()
+{
+    valid = false;
+    rows.clear();
+    rowHeights.clear();
+    heights.clear();
+    pendingRows.clear();
+    removalKnown = false;
+}
+
+void TreeViewRowController::Private::rebuild()
+{
+    rows.clear();
+    rowHeights.clear();
+    root = treeview->rootIndex();
+    QModelIndex idx = model->index( 0, 0, root );
+    while ( idx.isValid() ) {
+        rows.append( idx );
+        rowHeights.append( treeview->rowHeight( idx ) );
+        idx = treeview->indexBelow( idx );
+    }
+    buildHeights();
+    pendingRows.clear();
+    valid = true;
+}
+
+/* Rebuilds the Fenwick tree for the rows from row from on, the sums of the
+ * rows before it are still valid */
+void TreeViewRowController::Private::buildHeights( int from )
+{
+    const int n = rowHeights.size();
+    heights.resize( n+1 );
+    heights[0] = 0;
+    for ( int i = from+1; i <= n; ++i ) {
+        heights[i] = rowHeights[i-1];
+    }
+    // the sums of rows before from which are part of sums after it
+    for ( int i = from; i > 0; i -= ( i & -i ) ) {
+        const int parent = i + ( i & -i );
+        if ( parent <= n ) {
+            heights[parent] += heights[i];
+        }
+    }
+    for ( int i = from+1; i <= n; ++i ) {
+        const int parent = i + ( i & -i );
+        if ( parent <= n ) {
+            heights[parent] += heights[i];
+        }
+    }
+}
+
+void TreeViewRowController::Private::addHeight( int row, int delta )
+{
+    rowHeights[row] += delta;
+    for ( int i = row+1; i < heights.size(); i += ( i & -i ) ) {
+        heights[i] += delta;
+    }
+}
+
+void TreeViewRowController::Private::applyPendingRows()
+{
+    for ( const QPersistentModelIndex& idx : qAsConst( pendingRows ) ) {
+        const int row = rowOf( idx );
+        if ( row >= 0 ) {
+            const int delta = treeview->rowHeight( idx ) - rowHeights[row];
+            if ( delta != 0 ) {
+                addHeight( row, delta );
+            }
+        }
+    }
+    pendingRows.clear();
+}
+
+/* Returns the depth of idx below the invisible root of the model */
+static int depth( QModelIndex idx )
+{
+    int n = 0;
+    for ( ; idx.isValid(); idx = idx.parent() ) ++n;
+    return n;
+}
+
+/* Returns true if a comes before b when walking the model depth first */
+static bool isBefore( const QModelIndex& a, const QModelIndex& b )
+{
+    if ( a == b ) return false;
+    const int da = depth( a );
+    const int db = depth( b );
+    QModelIndex pa = a;
+    QModelIndex pb = b;
+    for ( int i = da; i > db; --i ) pa = pa.parent();
+    for ( int i = db; i > da; --i ) pb = pb.parent();
+    if ( pa == pb ) {
+        // a parent comes before its children
+        return da < db;
+    }
+    while ( pa.parent() != pb.parent() ) {
+        pa = pa.parent();
+        pb = pb.parent();
+    }
+    return pa.row() < pb.row();
+}
+
+int TreeViewRowController::Private::rowOf( const QModelIndex& _idx ) const
+{
+    if ( !_idx.isValid() ) return -1;
+    const QModelIndex idx = _idx.sibling( _idx.row(), 0 );
+    const auto it = std::lower_bound( rows.constBegin(), rows.constEnd(), idx, isBefore );
+    return ( it != rows.constEnd() && *it == idx ) ? int( it - rows.constBegin() ) : -1;
+}
+
+int TreeViewRowController::Private::rowStart( int row ) const
+{
+    int y = 0;
+    for ( int i = row; i > 0; i -= ( i & -i ) ) {
+        y += heights[i];
+    }
+    return y;
+}
+
+/* Returns the row that contains height, or -1 if it is below the last row */
+int TreeViewRowController::Private::rowAt( int height ) const
+{
+    const int n = rows.size();
+    if ( n == 0 ) return -1;
+    if ( height < 0 ) return 0;
+    int step = 1;
+    while ( step*2 <= n ) step *= 2;
+    int row = 0;
+    for ( ; step > 0; step /= 2 ) {
+        if ( row+step <= n && heights[row+step] <= height ) {
+            row += step;
+            height -= heights[row];
+        }
+    }
+    return row < n ? row : -1;
+}
+
+bool TreeViewRowController::Private::isInSubtree( const QModelIndex& idx, const QModelIndex& ancestor ) const
+{
+    for ( QModelIndex p = idx.parent(); p.isValid(); p = p.parent() ) {
+        if ( p == ancestor ) return true;
+    }
+    return false;
+}
+
+/* Returns true if the rows below parent are in the index, if they are not hidden */
+bool TreeViewRowController::Private::showsChildren( const QModelIndex& parent ) const
+{
+    return parent == root || ( rowOf( parent ) >= 0 && treeview->isExpanded( parent ) );
+}
+
+/* Appends idx and the rows of its subtree the tree view shows, in their order,
+ * without asking the tree view for rows it might not know about yet */
+void TreeViewRowController::Private::appendShownRows( const QModelIndex& idx, QVector<QModelIndex>* shown ) const
+{
+    if ( treeview->isRowHidden( idx.row(), idx.parent() ) ) return;
+    shown->append( idx );
+    if ( !treeview->isExpanded( idx ) ) return;
+    const int count = model->rowCount( idx );
+    for ( int row = 0; row < count; ++row ) {
+        appendShownRows( model->index( row, 0, idx ), shown );
+    }
+}
+
+/* Moves the children of parent from rows[from] on by delta model rows, after
+ * rows were inserted or removed before them */
+void TreeViewRowController::Private::renumberSiblings( const QModelIndex& parent, int from, int delta )
+{
+    for ( int i = from; i < rows.size(); ++i ) {
+        const QModelIndex p = rows[i].parent();
+        if ( p == parent ) {
+            rows[i] = model->index( rows[i].row()+delta, 0, parent );
+        } else if ( parent != root && !isInSubtree( rows[i], parent ) ) {
+            break;
+        }
+    }
+}
+
+void TreeViewRowController::Private::slotExpanded( const QModelIndex& _idx )
+{
+    if ( !valid || changing > 0 ) return;
+    const QModelIndex idx = _idx.sibling( _idx.row(), 0 );
+    const int row = rowOf( idx );
+    if ( row < 0 ) return; // its children are not shown either
+    QVector<QModelIndex> subtree;
+    QVector<int> subtreeHeights;
+    for ( QModelIndex below = treeview->indexBelow( idx );
+          below.isValid() && isInSubtree( below, idx ); below = treeview->indexBelow( below ) ) {
+        subtree.append( below );
+        subtreeHeights.append( treeview->rowHeight( below ) );
+    }
+    rows.insert( row+1, subtree.size(), QModelIndex() );
+    rowHeights.insert( row+1, subtree.size(), 0 );
+    std::copy( subtree.constBegin(), subtree.constEnd(), rows.begin()+row+1 );
+    std::copy( subtreeHeights.constBegin(), subtreeHeights.constEnd(), rowHeights.begin()+row+1 );
+    buildHeights( row+1 );
+}
+
+void TreeViewRowController::Private::slotCollapsed( const QModelIndex& _idx )
+{
+    if ( !valid || changing > 0 ) return;
+    const QModelIndex idx = _idx.sibling( _idx.row(), 0 );
+    const int row = rowOf( idx );
+    if ( row < 0 ) return;
+    int count = 0;
+    while ( row+1+count < rows.size() && isInSubtree( rows[row+1+count], idx ) ) {
+        ++count;
+    }
+    rows.remove( row+1, count );
+    rowHeights.remove( row+1, count );
+    buildHeights( row+1 );
+}
+
+void TreeViewRowController::Private::slotAboutToChange()
+{
+    ++changing;
+    invalidate();
+}
+
+void TreeViewRowController::Private::slotChanged()
+{
+    changing = qMax( 0, changing-1 );
+    invalidate();
+}
+
+void TreeViewRowController::Private::slotRowsAboutToBeInserted()
+{
+    ++changing;
+}
+
+void TreeViewRowController::Private::slotRowsInserted( const QModelIndex& parent, int first, int last )
+{
+    changing = qMax( 0, changing-1 );
+    if ( !valid ) return;
+    if ( changing > 0 ) {
+        invalidate();
+        return;
+    }
+    if ( !showsChildren( parent ) ) return;
+    // the rows from first on still have their old numbers, so the new rows go where the old first row is
+    const int pos = int( std::lower_bound( rows.constBegin(), rows.constEnd(),
+                                           model->index( first, 0, parent ), isBefore ) - rows.constBegin() );
+    const int count = last-first+1;
+    renumberSiblings( parent, pos, count );
+
+    QVector<QModelIndex> inserted;
+    for ( int row = first; row <= last; ++row ) {
+        appendShownRows( model->index( row, 0, parent ), &inserted );
+    }
+    rows.insert( pos, inserted.size(), QModelIndex() );
+    std::copy( inserted.constBegin(), inserted.constEnd(), rows.begin()+pos );
+    // the tree view may not have laid out the new rows yet, their heights are asked for later
+    rowHeights.insert( pos, inserted.size(), 0 );
+    for ( const QModelIndex& idx : qAsConst( inserted ) ) {
+        pendingRows.append( idx );
+    }
+    buildHeights( pos );
+}
+
+void TreeViewRowController::Private::slotRowsAboutToBeRemoved( const QModelIndex& parent, int first, int last )
+{
+    ++changing;
+    removalKnown = false;
+    if ( !valid || changing > 1 ) return;
+    removalKnown = true;
+    removedBegin = -1;
+    if ( !showsChildren( parent ) ) return;
+    removedBegin = int( std::lower_bound( rows.constBegin(), rows.constEnd(),
+                                          model->index( first, 0, parent ), isBefore ) - rows.constBegin() );
+    const QModelIndex next = model->index( last+1, 0, parent );
+    if ( next.isValid() ) {
+        removedEnd = int( std::lower_bound( rows.constBegin()+removedBegin, rows.constEnd(),
+                                            next, isBefore ) - rows.constBegin() );
+    } else {
+        removedEnd = removedBegin;
+        while ( removedEnd < rows.size() && ( parent == root || isInSubtree( rows[removedEnd], parent ) ) ) {
+            ++removedEnd;
+        }
+    }
+}
+
+void TreeViewRowController::Private::slotRowsRemoved( const QModelIndex& parent, int first, int last )
+{
+    changing = qMax( 0, changing-1 );
+    if ( !valid ) return;
+    if ( !removalKnown || changing > 0 ) {
+        invalidate();
+        return;
+    }
+    removalKnown = false;
+    if ( removedBegin < 0 ) return;
+    rows.remove( removedBegin, removedEnd-removedBegin );
+    rowHeights.remove( removedBegin, removedEnd-removedBegin );
+    renumberSiblings( parent, removedBegin, -( last-first+1 ) );
+    buildHeights( removedBegin );
+}
+
+void TreeViewRowController::Private::slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight )
+{
+    if ( !valid ) return;
+    if ( bottomRight.row()-topLeft.row() > 1000 ) {
+        // cheaper to walk the tree once more
+        invalidate();
+        return;
+    }
+    // the tree view learns about the new heights after this
+    for ( int row = topLeft.row(); row <= bottomRight.row(); ++row ) {
+        pendingRows.append( topLeft.sibling( row, 0 ) );
+    }
+}
+
+void TreeViewRowController::Private::slotRangeChanged( int min, int max )
+{
+    Q_UNUSED( min );
+    if ( !valid ) return;
+    applyPendingRows();
+    // per pixel, the range tells the height of all rows
+    if ( treeview->verticalScrollMode() != QAbstractItemView::ScrollPerPixel || max <= 0
+         || max+treeview->viewport()->height() != rowStart( rows.size() ) ) {
+        invalidate();
+    }
+}
+
 TreeViewRowController::TreeViewRowController( QTreeView* tv,
 					      QAbstractProxyModel* proxy )
   : _d( new Private )
 {
-    _d->treeview = static_cast<Private::HackTreeView*>(tv);
+    _d->setTreeView( static_cast<Private::HackTreeView*>(tv) );
     _d->proxy = proxy;
 }
 
@@ -55,6 +438,9 @@ bool TreeViewRowController::isRowVisible( const QModelIndex& _idx ) const
   //qDebug() << _idx.model()<<d->proxy << d->treeview->model();
     const QModelIndex idx = d->proxy->mapToSource( _idx );
     assert( idx.isValid() ? ( idx.model() == d->treeview->model() ):( true ) );
+    if ( const_cast<Private*>( d )->ensureIndex() ) {
+        return d->rowOf( idx ) >= 0;
+    }
     return d->treeview->visualRect(idx).isValid();
 }
 
@@ -69,6 +455,14 @@ Span TreeViewRowController::rowGeometry( const QModelIndex& _idx ) const
 {
     const QModelIndex idx = d->proxy->mapToSource( _idx );
     assert( idx.isValid() ? ( idx.model() == d->treeview->model() ):( true ) );
+    if ( const_cast<Private*>( d )->ensureIndex() ) {
+        const int row = d->rowOf( idx );
+        if ( row < 0 ) {
+            // where visualRect() puts rows that are not shown
+            return Span( d->treeview->verticalOffset(), 0 );
+        }
+        return Span( d->rowStart( row ), d->rowHeights.at( row ) );
+    }
     QRect r = d->treeview->visualRect(idx).translated( QPoint( 0, d->treeview->verticalOffset() ) );
     return Span( r.y(), r.height() );
 }
@@ -78,18 +472,19 @@ QModelIndex TreeViewRowController::indexAt( int height ) const
   /* using indexAt( QPoint ) won't work here, since it does hit detection
    *   against the actual item text/icon, so we would return wrong values
    *   for items with no text etc.
-   *
-   *   The code below could cache for performance, but currently it doesn't
-   *   seem to be the performance bottleneck at all.
    */
     if ( !d->treeview->model() ) return QModelIndex();
-    int y = d->treeview->verticalOffset();
+    if ( const_cast<Private*>( d )->ensureIndex() ) {
+        const int row = d->rowAt( height );
+        return row < 0 ? QModelIndex() : d->proxy->mapFromSource( d->rows.at( row ) );
+    }
+    int y = 0;
     QModelIndex idx = d->treeview->model()->index( 0, 0, d->treeview->rootIndex() );
-    do {
-        if ( y >= height ) break;
+    while ( idx.isValid() ) {
         y += d->treeview->rowHeight( idx );
+        if ( y > height ) break;
         idx = d->treeview->indexBelow( idx );
-    } while ( idx.isValid() );
+    }
     return d->proxy->mapFromSource( idx );
 }
 
@@ -11,24 +11,92 @@
 
 #include "kgantttreeviewrowcontroller.h"
 
+#include <QPersistentModelIndex>
+#include <QPointer>
 #include <QTreeView>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 class QAbstractProxyModel;
 QT_END_NAMESPACE
 
 namespace KGantt {
-    class Q_DECL_HIDDEN TreeViewRowController::Private {
+    /* Keeps the rows the tree view shows in their order, with a Fenwick
+     * tree over their heights, so that the start of a row and the row at
+     * a height are found in O(log n) instead of walking the tree view.
+     *
+     * Expanding and collapsing, and inserting and removing rows, splice
+     * the rows in or out. That and updating the Fenwick tree is linear in
+     * the number of rows after the splice, but does not ask the tree view
+     * about them. Other changes to the structure of the model rebuild the
+     * index the next time it is used, since the QModelIndexes in it are
+     * not valid anymore.
+     * Changes the tree view does not signal, like expandAll(), setRowHidden()
+     * or a new font, are noticed when they change its scroll range.
+     */
+    class Q_DECL_HIDDEN TreeViewRowController::Private : public QObject {
     public:
         class HackTreeView : public QTreeView {
         public:
             using QTreeView::verticalOffset;
             using QTreeView::rowHeight;
         };
+
+        Private();
+
+        void setTreeView( HackTreeView* tv );
+
+        /* returns false while the model is changing, the index is not usable then */
+        bool ensureIndex();
+        void invalidate();
+
+        int rowOf( const QModelIndex& idx ) const;
+        int rowStart( int row ) const;
+        int rowAt( int height ) const;
+
         HackTreeView* treeview;
         QAbstractProxyModel* proxy;
+
+        void setModel( QAbstractItemModel* m );
+        void rebuild();
+        void buildHeights( int from = 0 );
+        void addHeight( int row, int delta );
+        void applyPendingRows();
+        bool isInSubtree( const QModelIndex& idx, const QModelIndex& ancestor ) const;
+        bool showsChildren( const QModelIndex& parent ) const;
+        void appendShownRows( const QModelIndex& idx, QVector<QModelIndex>* shown ) const;
+        void renumberSiblings( const QModelIndex& parent, int from, int delta );
+
+        void slotExpanded( const QModelIndex& idx );
+        void slotCollapsed( const QModelIndex& idx );
+        void slotAboutToChange();
+        void slotChanged();
+        void slotRowsAboutToBeInserted();
+        void slotRowsInserted( const QModelIndex& parent, int first, int last );
+        void slotRowsAboutToBeRemoved( const QModelIndex& parent, int first, int last );
+        void slotRowsRemoved( const QModelIndex& parent, int first, int last );
+        void slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight );
+        void slotRangeChanged( int min, int max );
+
+        // - rows and heights are in the order the tree view shows the rows
+        // - heights is a Fenwick tree, heights[i] holds the sum of the
+        // heights of the rows i-(i&-i) to i-1
+        // - rows whose height may have changed are looked at again when the
+        // index is used next
+        QVector<QModelIndex> rows;
+        QVector<int> rowHeights;
+        QVector<int> heights;
+        QVector<QPersistentModelIndex> pendingRows;
+        // the rows about to be removed are rows[removedBegin, removedEnd),
+        // removedBegin is -1 if they are not shown
+        bool removalKnown;
+        int removedBegin;
+        int removedEnd;
+        bool valid;
+        int changing;
+        QPointer<QAbstractItemModel> model;
+        QPersistentModelIndex root;
     };
 }
 
 #endif /* KGANTTTREEVIEWROWCONTROLLER_P_H */
-
@@ -110,6 +110,7 @@ void View::Private::init()
     q->setLayout(layout);
 
     constraintProxy.setProxyModel( &ganttProxyModel );
+    mappedConstraintModel.setBulkUpdatesEnabled( true );
     constraintProxy.setDestinationModel( &mappedConstraintModel );
     setupGraphicsView();
 }
@@ -128,6 +129,10 @@ void View::Private::setupGraphicsView()
 
 void View::Private::updateScene()
 {
+    if ( gfxview->isVirtualizationEnabled() ) {
+        gfxview->updateScene();
+        return;
+    }
     gfxview->clearItems();
     if ( !model) return;
 
@@ -172,24 +177,37 @@ void View::Private::slotCollapsed(const QModelIndex& _idx)
     } else {
         gfxview->updateRow(pidx);
     }
-    //qDebug() << "Looking to update from " << idx;
-    while ( ( idx=tw->indexBelow( idx ) ) != QModelIndex() &&
-            gfxview->rowController()->isRowVisible( ganttProxyModel.mapFromSource(idx) ) ) {
-        const QModelIndex proxyidx( ganttProxyModel.mapFromSource( idx ) );
-        gfxview->updateRow(proxyidx);
-    }
+    // the rows below only moved up
+    gfxview->moveRowsBelow( pidx );
     gfxview->blockSignals( blocked );
     gfxview->updateSceneRect();
 }
 
 void View::Private::slotExpanded(const QModelIndex& _idx)
 {
-    QModelIndex idx( ganttProxyModel.mapFromSource( _idx ) );
-    do {
-        //qDebug() << "Updating row" << idx << idx.data( Qt::DisplayRole ).toString();
-        gfxview->updateRow(idx);
-    } while ( ( idx=gfxview->rowController()->indexBelow( idx ) ) != QModelIndex()
-             && gfxview->rowController()->isRowVisible( idx ) );
+    const QModelIndex pidx( ganttProxyModel.mapFromSource( _idx ) );
+    if ( gfxview->isVirtualizationEnabled() ) {
+        // items of a multi row leave it, those out of view are created when needed
+        for ( int i = 0; i < ganttProxyModel.rowCount( pidx ); ++i ) {
+            gfxview->deleteSubtree( ganttProxyModel.index( i, 0, pidx ) );
+        }
+    }
+    // move the rows below out of the way before the new ones get their items
+    gfxview->moveRowsBelow( pidx );
+    gfxview->updateRow( pidx );
+    if ( !gfxview->isVirtualizationEnabled() ) {
+        QModelIndex idx( pidx );
+        while ( ( idx=gfxview->rowController()->indexBelow( idx ) ) != QModelIndex()
+                && gfxview->rowController()->isRowVisible( idx ) ) {
+            QModelIndex ancestor = idx.parent();
+            while ( ancestor.isValid() && ancestor != pidx ) {
+                ancestor = ancestor.parent();
+            }
+            if ( !ancestor.isValid() ) break;
+            //qDebug() << "Updating row" << idx << idx.data( Qt::DisplayRole ).toString();
+            gfxview->updateRow(idx);
+        }
+    }
     gfxview->updateSceneRect();
 }
 
@@ -282,6 +300,19 @@ void View::setRowController( AbstractRowController* ctrl )
     if ( ctrl == d->rowController && d->gfxview->rowController() == ctrl ) return;
     d->rowController = ctrl;
     d->gfxview->setRowController( d->rowController );
+
+    if ( qobject_cast<QTreeView*>(d->leftWidget) ) {
+        // A TreeViewRowController follows the expansion of the tree itself,
+        // it has to see it before the scene asks it for the new geometry.
+        disconnect( d->leftWidget,  SIGNAL(collapsed(QModelIndex)),
+                    this, SLOT(slotCollapsed(QModelIndex)) );
+        disconnect( d->leftWidget,  SIGNAL(expanded(QModelIndex)),
+                    this, SLOT(slotExpanded(QModelIndex)) );
+        connect( d->leftWidget,  SIGNAL(collapsed(QModelIndex)),
+                 this, SLOT(slotCollapsed(QModelIndex)) );
+        connect( d->leftWidget,  SIGNAL(expanded(QModelIndex)),
+                 this, SLOT(slotExpanded(QModelIndex)) );
+    }
 }
 
 
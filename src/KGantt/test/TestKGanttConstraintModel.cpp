@@ -10,10 +10,32 @@
 
 #include "kganttglobal.h"
 #include <kganttconstraintmodel.h>
+#include <kganttconstraintproxy.h>
 
+#include <QIdentityProxyModel>
 
 using namespace KGantt;
 
+namespace {
+    class CountingConstraintModel : public ConstraintModel
+    {
+    public:
+        int added = 0;
+        int removed = 0;
+
+        void addConstraint(const Constraint& c) override
+        {
+            ++added;
+            ConstraintModel::addConstraint(c);
+        }
+        bool removeConstraint(const Constraint& c) override
+        {
+            ++removed;
+            return ConstraintModel::removeConstraint(c);
+        }
+    };
+}
+
 void TestKGanttConstraintModel::initTestCase()
 {
     itemModel = new QStandardItemModel(100, 100);
@@ -68,4 +90,151 @@ void TestKGanttConstraintModel::testModel()
     QVERIFY(model.hasConstraint(Constraint(idx1, idx2)));
 }
 
+void TestKGanttConstraintModel::testConstraintsForIndex()
+{
+    QStandardItemModel items(10, 1);
+    ConstraintModel model;
+
+    const QPersistentModelIndex idx1 = items.index(1, 0);
+    const QPersistentModelIndex idx2 = items.index(2, 0);
+    const QPersistentModelIndex idx3 = items.index(3, 0);
+    model.addConstraint(Constraint(idx1, idx2));
+    model.addConstraint(Constraint(idx2, idx3));
+    model.addConstraint(Constraint(idx3, idx1));
+
+    QCOMPARE(model.constraintsForIndex(idx1).count(), 2);
+    QCOMPARE(model.constraintsForIndex(idx2).count(), 2);
+    QCOMPARE(model.constraintsForIndex(items.index(5, 0)).count(), 0);
+
+    // the constraints follow their rows
+    items.insertRows(0, 4);
+    QVERIFY(idx2 == items.index(6, 0));
+    QCOMPARE(model.constraintsForIndex(items.index(6, 0)).count(), 2);
+    QVERIFY(model.hasConstraint(Constraint(items.index(5, 0), items.index(6, 0))));
+    QVERIFY(!model.hasConstraint(Constraint(items.index(1, 0), items.index(2, 0))));
+
+    QVERIFY(model.removeConstraint(Constraint(idx2, idx3)));
+    QCOMPARE(model.constraintsForIndex(idx2).count(), 1);
+    QCOMPARE(model.constraintsForIndex(idx3).count(), 1);
+    QCOMPARE(model.constraints().count(), 2);
+}
+
+void TestKGanttConstraintModel::testBulkOperations()
+{
+    QStandardItemModel items(100, 1);
+    ConstraintModel model;
+    // Constraint is no metatype, so count the signals without QSignalSpy
+    QList<QList<Constraint> > added;
+    QList<QList<Constraint> > removed;
+    int addedOne = 0;
+    connect(&model, &ConstraintModel::constraintsAdded, [&added](const QList<Constraint>& lst) { added << lst; });
+    connect(&model, &ConstraintModel::constraintsRemoved, [&removed](const QList<Constraint>& lst) { removed << lst; });
+    connect(&model, &ConstraintModel::constraintAdded, [&addedOne]() { ++addedOne; });
+
+    QList<Constraint> constraints;
+    for (int row = 0; row < 99; ++row) {
+        constraints << Constraint(items.index(row, 0), items.index(row + 1, 0));
+    }
+    model.addConstraints(constraints);
+    QCOMPARE(model.constraints().count(), 99);
+    QCOMPARE(added.count(), 1);
+    QCOMPARE(added.at(0).count(), 99);
+    QCOMPARE(addedOne, 0);
+    QCOMPARE(removed.count(), 0);
+
+    // adding the same constraints again changes nothing
+    model.addConstraints(constraints);
+    QCOMPARE(added.count(), 1);
+
+    // a constraint with other data replaces the old one
+    Constraint hard(items.index(0, 0), items.index(1, 0), Constraint::TypeHard);
+    model.addConstraints(QList<Constraint>() << hard);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(added.count(), 2);
+    QCOMPARE(model.constraints().count(), 99);
+    QCOMPARE(model.constraintsForIndex(items.index(0, 0)).value(0).type(), Constraint::TypeHard);
+
+    QCOMPARE(model.removeConstraints(constraints.mid(0, 50)), 50);
+    QCOMPARE(removed.count(), 2);
+    QCOMPARE(removed.at(1).count(), 50);
+    QCOMPARE(model.constraints().count(), 49);
+    QVERIFY(!model.hasConstraint(constraints.at(10)));
+    QVERIFY(model.hasConstraint(constraints.at(60)));
+    QCOMPARE(model.constraintsForIndex(items.index(50, 0)).count(), 1);
+
+    QCOMPARE(model.removeConstraints(constraints.mid(0, 50)), 0);
+    QCOMPARE(removed.count(), 2);
+}
+
+void TestKGanttConstraintModel::testOrder()
+{
+    QStandardItemModel items(20, 1);
+    ConstraintModel model;
+    QList<Constraint> constraints;
+    for (int row = 0; row < 19; ++row) {
+        constraints << Constraint(items.index(row, 0), items.index(row + 1, 0));
+        model.addConstraint(constraints.last());
+    }
+    QCOMPARE(model.constraints(), constraints);
+
+    // removing keeps the order of the others, new constraints come last
+    QVERIFY(model.removeConstraint(constraints.takeAt(3)));
+    QList<Constraint> removed;
+    removed << constraints.takeAt(0);
+    removed << constraints.takeAt(10);
+    QCOMPARE(model.removeConstraints(removed), 2);
+    QCOMPARE(model.constraints(), constraints);
+    constraints << Constraint(items.index(0, 0), items.index(2, 0));
+    model.addConstraint(constraints.last());
+    QCOMPARE(model.constraints(), constraints);
+
+    // also when most of them are removed
+    QCOMPARE(model.removeConstraints(constraints.mid(0, 12)), 12);
+    constraints = constraints.mid(12);
+    QCOMPARE(model.constraints(), constraints);
+    QVERIFY(model.hasConstraint(constraints.last()));
+    QCOMPARE(model.constraintsForIndex(items.index(0, 0)).count(), 1);
+}
+
+void TestKGanttConstraintModel::testProxyBulkUpdates()
+{
+    QStandardItemModel items(20, 1);
+    QIdentityProxyModel proxy;
+    proxy.setSourceModel(&items);
+    ConstraintModel source;
+    CountingConstraintModel destination;
+    ConstraintProxy constraintProxy;
+    constraintProxy.setProxyModel(&proxy);
+    constraintProxy.setDestinationModel(&destination);
+
+    QList<Constraint> constraints;
+    for (int row = 0; row < 10; ++row) {
+        constraints << Constraint(items.index(row, 0), items.index(row + 1, 0));
+    }
+    source.addConstraints(constraints.mid(0, 5));
+    constraintProxy.setSourceModel(&source);
+    // the virtual functions of the destination are called for every constraint
+    QCOMPARE(destination.added, 5);
+    source.addConstraints(constraints.mid(5));
+    QCOMPARE(destination.added, 10);
+    QCOMPARE(destination.constraints().count(), 10);
+
+    QCOMPARE(source.removeConstraints(constraints.mid(0, 4)), 4);
+    QCOMPARE(destination.removed, 4);
+    QCOMPARE(destination.constraints().count(), 6);
+    QVERIFY(destination.hasConstraint(Constraint(proxy.index(9, 0), proxy.index(10, 0))));
+
+    // a model with bulk updates enabled gets the constraints at once
+    ConstraintModel bulkDestination;
+    bulkDestination.setBulkUpdatesEnabled(true);
+    int addedBatches = 0;
+    int addedOne = 0;
+    connect(&bulkDestination, &ConstraintModel::constraintsAdded, [&addedBatches]() { ++addedBatches; });
+    connect(&bulkDestination, &ConstraintModel::constraintAdded, [&addedOne]() { ++addedOne; });
+    constraintProxy.setDestinationModel(&bulkDestination);
+    QCOMPARE(bulkDestination.constraints().count(), 6);
+    QCOMPARE(addedBatches, 1);
+    QCOMPARE(addedOne, 0);
+}
+
 QTEST_GUILESS_MAIN(TestKGanttConstraintModel)
@@ -22,5 +22,9 @@ private Q_SLOTS:
     void initTestCase();
     void cleanupTestCase();
     void testModel();
+    void testConstraintsForIndex();
+    void testBulkOperations();
+    void testOrder();
+    void testProxyBulkUpdates();
 };
 #endif
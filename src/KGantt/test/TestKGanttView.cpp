@@ -23,6 +23,7 @@
 #include "kgantttreeviewrowcontroller.h"
 
 #include <QListView>
+#include <QScrollBar>
 
 
 using namespace KGantt;
@@ -352,4 +353,207 @@ void TestKGanttView::testSetRowController()
     initTreeModel();
 }
 
+void TestKGanttView::testVirtualization()
+{
+    itemModel->setHorizontalHeaderLabels(QStringList()<< "Title"<<"Type"<<"Start"<<"End");
+    const QDateTime now = QDateTime::currentDateTime();
+    for (int i = 0; i < 300; ++i) {
+        QList<QStandardItem*> items;
+        items << new QStandardItem(QString("T%1").arg(i));
+        items << new QStandardItem(QString::number((int)KGantt::TypeTask));
+        items << new QStandardItem(now.addDays(i).toString());
+        items << new QStandardItem(now.addDays(i + 1).toString());
+        itemModel->appendRow(items);
+    }
+    GraphicsView *gv = view->graphicsView();
+    QCOMPARE(gv->scene()->items().count(), 300);
+
+    view->resize(600, 400);
+    view->show();
+    QVERIFY(QTest::qWaitForWindowExposed(view));
+
+    gv->setVirtualizationEnabled(true);
+    QVERIFY(gv->isVirtualizationEnabled());
+    const int visible = gv->scene()->items().count();
+    QVERIFY(visible > 0);
+    QVERIFY(visible < 300);
+
+    GraphicsScene *scene = qobject_cast<GraphicsScene*>(gv->scene());
+    QVERIFY(scene);
+    const QModelIndex first = gv->summaryHandlingModel()->mapFromSource(gv->model()->index(0, 0));
+    const QModelIndex last = gv->summaryHandlingModel()->mapFromSource(gv->model()->index(299, 0));
+    QVERIFY(scene->findItem(first));
+    QVERIFY(!scene->findItem(last));
+
+    // an item being dragged stays while scrolling away from it
+    GraphicsItem *dragged = scene->findItem(first);
+    scene->setDragSource(dragged);
+    gv->verticalScrollBar()->setValue(gv->verticalScrollBar()->maximum());
+    QCOMPARE(scene->findItem(first), dragged);
+    QCOMPARE(scene->dragSource(), dragged);
+    QVERIFY(scene->findItem(last));
+    scene->setDragSource(nullptr);
+
+    gv->verticalScrollBar()->setValue(gv->verticalScrollBar()->maximum() - 1);
+    QVERIFY(!scene->findItem(first));
+    QVERIFY(scene->findItem(last));
+    QVERIFY(gv->scene()->items().count() < 300);
+
+    // the scene keeps the height of all rows
+    QVERIFY(gv->sceneRect().height() >= gv->rowController()->totalHeight());
+
+    gv->setVirtualizationEnabled(false);
+    QCOMPARE(gv->scene()->items().count(), 300);
+}
+
+void TestKGanttView::testIncrementalUpdates()
+{
+    initTreeModel();
+    QList<QStandardItem*> items;
+    const QDateTime now = QDateTime::currentDateTime();
+    items << new QStandardItem("T3");
+    items << new QStandardItem(QString::number((int)KGantt::TypeTask));
+    items << new QStandardItem(now.toString());
+    items << new QStandardItem(now.addDays(1).toString());
+    itemModel->appendRow(items);
+
+    view->resize(600, 400);
+    view->show();
+    QVERIFY(QTest::qWaitForWindowExposed(view));
+    view->expandAll();
+
+    GraphicsView *gv = view->graphicsView();
+    GraphicsScene *scene = qobject_cast<GraphicsScene*>(gv->scene());
+    QVERIFY(scene);
+    QPersistentModelIndex t3 = gv->model()->index(1, 0);
+    GraphicsItem *item = scene->findItem(gv->summaryHandlingModel()->mapFromSource(t3));
+    QVERIFY(item);
+    QCOMPARE(item->pos().y(), gv->rowController()->rowGeometry(t3).start());
+
+    // the item of the row below is moved, not created again
+    view->collapseAll();
+    QCOMPARE(scene->items().count(), 2);
+    QCOMPARE(scene->findItem(gv->summaryHandlingModel()->mapFromSource(t3)), item);
+    QCOMPARE(item->pos().y(), gv->rowController()->rowGeometry(t3).start());
+
+    view->expandAll();
+    QCOMPARE(scene->items().count(), 4);
+    QCOMPARE(scene->findItem(gv->summaryHandlingModel()->mapFromSource(t3)), item);
+    QCOMPARE(item->pos().y(), gv->rowController()->rowGeometry(t3).start());
+
+    items.clear();
+    items << new QStandardItem("T0");
+    items << new QStandardItem(QString::number((int)KGantt::TypeTask));
+    items << new QStandardItem(now.toString());
+    items << new QStandardItem(now.addDays(1).toString());
+    itemModel->insertRow(0, items);
+    QCOMPARE(scene->items().count(), 5);
+    QCOMPARE(scene->findItem(gv->summaryHandlingModel()->mapFromSource(t3)), item);
+    QCOMPARE(item->pos().y(), gv->rowController()->rowGeometry(t3).start());
+
+    QVERIFY(itemModel->removeRows(0, 1));
+    QCOMPARE(scene->items().count(), 4);
+    QCOMPARE(scene->findItem(gv->summaryHandlingModel()->mapFromSource(t3)), item);
+    QCOMPARE(item->pos().y(), gv->rowController()->rowGeometry(t3).start());
+}
+
+void TestKGanttView::testRowGeometryIndex()
+{
+    itemModel->setHorizontalHeaderLabels(QStringList()<< "Title"<<"Type"<<"Start"<<"End");
+    const QDateTime now = QDateTime::currentDateTime();
+    for (int i = 0; i < 50; ++i) {
+        QStandardItem *sum = new QStandardItem(QString("Summary %1").arg(i));
+        itemModel->appendRow(QList<QStandardItem*>() << sum << new QStandardItem(QString::number((int)KGantt::TypeSummary)));
+        for (int j = 0; j < 5; ++j) {
+            QList<QStandardItem*> items;
+            items << new QStandardItem(QString("T%1.%2").arg(i).arg(j));
+            items << new QStandardItem(QString::number((int)KGantt::TypeTask));
+            items << new QStandardItem(now.addDays(j).toString());
+            items << new QStandardItem(now.addDays(j + 1).toString());
+            sum->appendRow(items);
+        }
+    }
+    view->resize(600, 400);
+    view->show();
+    QVERIFY(QTest::qWaitForWindowExposed(view));
+    view->expandAll();
+
+    QTreeView *tree = qobject_cast<QTreeView*>(view->leftView());
+    QVERIFY(tree);
+    const AbstractRowController *rc = view->rowController();
+    // the row controller has to agree with the tree view on every row
+    int rows = 0;
+    auto compareRows = [&]() {
+        rows = 0;
+        for (QModelIndex idx = itemModel->index(0, 0); idx.isValid(); idx = tree->indexBelow(idx)) {
+            const QModelIndex pidx = view->ganttProxyModel()->mapFromSource(idx);
+            const QRect r = tree->visualRect(idx).translated(0, tree->verticalScrollBar()->value());
+            QVERIFY(rc->isRowVisible(pidx));
+            QCOMPARE(rc->rowGeometry(pidx).start(), qreal(r.y()));
+            QCOMPARE(rc->rowGeometry(pidx).length(), qreal(r.height()));
+            QCOMPARE(rc->indexAt(r.y() + r.height() / 2), pidx);
+            ++rows;
+        }
+    };
+
+    compareRows();
+    QCOMPARE(rows, 300);
+
+    tree->collapse(itemModel->index(0, 0));
+    compareRows();
+    QCOMPARE(rows, 295);
+    QVERIFY(!rc->isRowVisible(view->ganttProxyModel()->mapFromSource(itemModel->index(0, 0, itemModel->index(0, 0)))));
+
+    tree->expand(itemModel->index(0, 0));
+    compareRows();
+    QCOMPARE(rows, 300);
+
+    QList<QStandardItem*> items;
+    items << new QStandardItem("Inserted");
+    items << new QStandardItem(QString::number((int)KGantt::TypeTask));
+    items << new QStandardItem(now.toString());
+    items << new QStandardItem(now.addDays(1).toString());
+    itemModel->item(10)->insertRow(2, items);
+    compareRows();
+    QCOMPARE(rows, 301);
+
+    QVERIFY(itemModel->removeRows(20, 1));
+    compareRows();
+    QCOMPARE(rows, 295);
+
+    // a new summary is collapsed, its children are not shown
+    QStandardItem *sum = new QStandardItem("Inserted summary");
+    sum->appendRow(new QStandardItem("Inserted child"));
+    itemModel->insertRow(5, QList<QStandardItem*>() << sum << new QStandardItem(QString::number((int)KGantt::TypeSummary)));
+    compareRows();
+    QCOMPARE(rows, 296);
+    tree->expand(sum->index());
+    compareRows();
+    QCOMPARE(rows, 297);
+
+    // rows inserted below a collapsed summary are shown when it is expanded
+    tree->collapse(itemModel->index(0, 0));
+    itemModel->item(0)->insertRow(0, new QStandardItem("Hidden child"));
+    compareRows();
+    QCOMPARE(rows, 292);
+    tree->expand(itemModel->index(0, 0));
+    compareRows();
+    QCOMPARE(rows, 298);
+
+    // the last children of a summary, and summaries with their children
+    QVERIFY(itemModel->removeRows(3, 2, itemModel->index(30, 0)));
+    compareRows();
+    QCOMPARE(rows, 296);
+    QVERIFY(itemModel->removeRows(40, 2));
+    compareRows();
+    QCOMPARE(rows, 284);
+    QVERIFY(itemModel->removeRows(itemModel->rowCount() - 1, 1));
+    compareRows();
+    QCOMPARE(rows, 278);
+
+    tree->collapseAll();
+    compareRows();
+    QCOMPARE(rows, 47);
+}
+
 QTEST_MAIN(TestKGanttView)
@@ -46,5 +46,11 @@ private Q_SLOTS:
     void testSetGraphicsView();
 
     void testSetRowController();
+
+    void testVirtualization();
+
+    void testIncrementalUpdates();
+
+    void testRowGeometryIndex();
 };
 #endif
@@ -0,0 +1,475 @@
+/**
+ * SPDX-FileCopyrightText: 2001-2015 Klaralvdalens Datakonsult AB. All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <QtTest/QtTest>
+#include <QAbstractTableModel>
+#include <QApplication>
+#include <QImage>
+#include <QPainter>
+
+#include <KChartAttributesModel>
+#include <KChartBarDiagram>
+#include <KChartBulkNumericSource>
+#include <KChartCartesianAxis>
+#include <KChartCartesianCoordinatePlane>
+#include <KChartChart>
+#include <KChartDataValueAttributes>
+#include <KChartLegend>
+#include <KChartLineDiagram>
+#include <KChartPieDiagram>
+#include <KChartPlotter>
+#include <KChartPolarCoordinatePlane>
+#include <KChartPolarDiagram>
+#include <KChartStockDiagram>
+#include <KChartTernaryCoordinatePlane>
+#include <KChartTernaryPointDiagram>
+#include <KChartCartesianDiagramDataCompressor_p.h>
+
+using namespace KChart;
+
+typedef CartesianDiagramDataCompressor::CachePosition CachePosition;
+
+#if defined(__GLIBC__)
+// counts the heap allocations of the whole process, Qt's containers included
+extern "C" {
+void* __libc_malloc( size_t size );
+void* __libc_calloc( size_t count, size_t size );
+void* __libc_realloc( void* pointer, size_t size );
+}
+
+static QBasicAtomicInteger< qint64 > allocationCount = Q_BASIC_ATOMIC_INITIALIZER( 0 );
+
+extern "C" void* malloc( size_t size ) __THROW
+{
+    allocationCount.fetchAndAddRelaxed( 1 );
+    return __libc_malloc( size );
+}
+
+extern "C" void* calloc( size_t count, size_t size ) __THROW
+{
+    allocationCount.fetchAndAddRelaxed( 1 );
+    return __libc_calloc( count, size );
+}
+
+extern "C" void* realloc( void* pointer, size_t size ) __THROW
+{
+    allocationCount.fetchAndAddRelaxed( 1 );
+    return __libc_realloc( pointer, size );
+}
+#define HAVE_ALLOCATION_COUNT
+#endif
+
+// a model with generated numbers kept in columns, handed out through BulkNumericSource
+// so that building the model does not dominate the larger data sets
+class SyntheticModel : public QAbstractTableModel, public BulkNumericSource
+{
+public:
+    SyntheticModel( int rows, int columns )
+        : m_columns( columns )
+    {
+        for ( int column = 0; column < columns; ++column ) {
+            m_columns[ column ].resize( rows );
+            for ( int row = 0; row < rows; ++row ) {
+                m_columns[ column ][ row ] = value( row, column );
+            }
+        }
+    }
+
+    static double value( int row, int column )
+    {
+        return 50.0 + 40.0 * sin( row * 0.001 * ( column + 1 ) ) + ( qint64( row ) * 7919 % 101 ) * 0.1;
+    }
+
+    int rowCount( const QModelIndex& parent = QModelIndex() ) const override
+    {
+        return parent.isValid() || m_columns.isEmpty() ? 0 : m_columns.first().size();
+    }
+
+    int columnCount( const QModelIndex& parent = QModelIndex() ) const override
+    {
+        return parent.isValid() ? 0 : m_columns.size();
+    }
+
+    QVariant data( const QModelIndex& index, int role ) const override
+    {
+        if ( role != Qt::DisplayRole || !index.isValid() ) {
+            return QVariant();
+        }
+        return m_columns.at( index.column() ).at( index.row() );
+    }
+
+    const double* columnData( int column, const QModelIndex& parent, int role ) const override
+    {
+        Q_UNUSED( parent );
+        return role == Qt::DisplayRole ? m_columns.at( column ).constData() : nullptr;
+    }
+
+    bool mayContainHiddenData( int column, const QModelIndex& parent ) const override
+    {
+        Q_UNUSED( column );
+        Q_UNUSED( parent );
+        return false;
+    }
+
+    void appendRows( int count )
+    {
+        const int rows = rowCount();
+        beginInsertRows( QModelIndex(), rows, rows + count - 1 );
+        for ( int column = 0; column < m_columns.size(); ++column ) {
+            for ( int row = rows; row < rows + count; ++row ) {
+                m_columns[ column ].append( value( row, column ) );
+            }
+        }
+        endInsertRows();
+    }
+
+private:
+    QVector< QVector< double > > m_columns;
+};
+
+enum DiagramType { LineChart, BarChart, PlotterChart, StockChart, PieChart, PolarChart, TernaryChart };
+
+static int rowsFor( int type, int points )
+{
+    // pie slices are columns
+    return type == PieChart ? 1 : points;
+}
+
+static int columnsFor( int type, int points, int datasets )
+{
+    switch ( type ) {
+    case PieChart:
+        return points;
+    case PlotterChart:
+        return 2 * datasets;
+    case StockChart:
+    case TernaryChart:
+        return 3 * datasets;
+    default:
+        return datasets;
+    }
+}
+
+// a chart showing one diagram of the given type, with axes for cartesian diagrams
+class DiagramFixture
+{
+public:
+    DiagramFixture( int type, int points, int datasets = 1 )
+        : model( rowsFor( type, points ), columnsFor( type, points, datasets ) )
+        , diagram( nullptr )
+    {
+        AbstractCartesianDiagram* cartesianDiagram = nullptr;
+        switch ( type ) {
+        case LineChart:
+            cartesianDiagram = new LineDiagram;
+            break;
+        case BarChart:
+            cartesianDiagram = new BarDiagram;
+            break;
+        case PlotterChart:
+            cartesianDiagram = new Plotter;
+            break;
+        case StockChart: {
+            StockDiagram* stockDiagram = new StockDiagram;
+            stockDiagram->setType( StockDiagram::HighLowClose );
+            cartesianDiagram = stockDiagram;
+            break;
+        }
+        case PieChart:
+        case PolarChart: {
+            PolarCoordinatePlane* plane = new PolarCoordinatePlane( &chart );
+            chart.replaceCoordinatePlane( plane );
+            diagram = type == PieChart ? static_cast< AbstractDiagram* >( new PieDiagram )
+                                       : static_cast< AbstractDiagram* >( new PolarDiagram );
+            break;
+        }
+        case TernaryChart: {
+            TernaryCoordinatePlane* plane = new TernaryCoordinatePlane( &chart );
+            chart.replaceCoordinatePlane( plane );
+            diagram = new TernaryPointDiagram;
+            break;
+        }
+        }
+
+        if ( cartesianDiagram ) {
+            CartesianAxis* bottomAxis = new CartesianAxis( cartesianDiagram );
+            bottomAxis->setPosition( CartesianAxis::Bottom );
+            CartesianAxis* leftAxis = new CartesianAxis( cartesianDiagram );
+            leftAxis->setPosition( CartesianAxis::Left );
+            cartesianDiagram->addAxis( bottomAxis );
+            cartesianDiagram->addAxis( leftAxis );
+            axes << bottomAxis << leftAxis;
+            diagram = cartesianDiagram;
+        }
+        diagram->setModel( &model );
+        chart.coordinatePlane()->replaceDiagram( diagram );
+        chart.resize( size );
+    }
+
+    // renders the chart at the widget size, so that nothing needs to be laid out again
+    void paint( QImage* image )
+    {
+        QPainter painter( image );
+        painter.setRenderHint( QPainter::Antialiasing );
+        chart.paint( &painter, QRect( QPoint( 0, 0 ), size ) );
+    }
+
+    static const QSize size;
+
+    // declared before the chart, which must go first
+    SyntheticModel model;
+    Chart chart;
+    AbstractDiagram* diagram;
+    QList< CartesianAxis* > axes;
+};
+
+const QSize DiagramFixture::size( 800, 600 );
+
+static void addDiagramRows( const char* name, int type, const QVector< int >& pointCounts )
+{
+    for ( int points : pointCounts ) {
+        const QString tag = QStringLiteral( "%1-%2" ).arg( QLatin1String( name ) ).arg( points );
+        QTest::newRow( qPrintable( tag ) ) << type << points;
+    }
+}
+
+class BenchmarkKChart : public QObject {
+  Q_OBJECT
+private Q_SLOTS:
+
+  void paint_data()
+  {
+      QTest::addColumn< int >( "type" );
+      QTest::addColumn< int >( "points" );
+      // line and plotter data are compressed to the resolution of the plane, the other
+      // diagrams paint every single point
+      addDiagramRows( "line", LineChart, { 1000, 100000, 10000000 } );
+      addDiagramRows( "plotter", PlotterChart, { 1000, 100000, 10000000 } );
+      addDiagramRows( "bar", BarChart, { 1000, 10000, 100000 } );
+      addDiagramRows( "stock", StockChart, { 1000, 10000, 100000 } );
+      addDiagramRows( "polar", PolarChart, { 1000, 10000, 100000 } );
+      addDiagramRows( "ternary", TernaryChart, { 1000, 10000, 100000 } );
+      addDiagramRows( "pie", PieChart, { 100, 1000 } );
+  }
+
+  void paint()
+  {
+      QFETCH( int, type );
+      QFETCH( int, points );
+      DiagramFixture fixture( type, points );
+      QImage image( DiagramFixture::size, QImage::Format_ARGB32_Premultiplied );
+      QBENCHMARK {
+          fixture.paint( &image );
+      }
+  }
+
+  void paintAllocations_data()
+  {
+      paint_data();
+  }
+
+  void paintAllocations()
+  {
+#ifdef HAVE_ALLOCATION_COUNT
+      QFETCH( int, type );
+      QFETCH( int, points );
+      DiagramFixture fixture( type, points );
+      QImage image( DiagramFixture::size, QImage::Format_ARGB32_Premultiplied );
+      // the first paint fills the caches
+      fixture.paint( &image );
+
+      const qint64 before = allocationCount.loadRelaxed();
+      fixture.paint( &image );
+      QTest::setBenchmarkResult( qreal( allocationCount.loadRelaxed() - before ), QTest::Events );
+#else
+      QSKIP( "Counting allocations is only implemented for glibc" );
+#endif
+  }
+
+  void compressorRebuild_data()
+  {
+      QTest::addColumn< int >( "points" );
+      QTest::newRow( "1000" ) << 1000;
+      QTest::newRow( "100000" ) << 100000;
+      QTest::newRow( "10000000" ) << 10000000;
+  }
+
+  void compressorRebuild()
+  {
+      QFETCH( int, points );
+      SyntheticModel model( points, 1 );
+      CartesianDiagramDataCompressor compressor;
+      compressor.setModel( &model );
+      int width = 800;
+      compressor.setResolution( width, 600 );
+      QBENCHMARK {
+          // a different resolution throws the cached data away
+          width = width == 800 ? 801 : 800;
+          compressor.setResolution( width, 600 );
+          qreal sum = 0.0;
+          for ( int row = 0; row < compressor.modelDataRows(); ++row ) {
+              sum += compressor.data( CachePosition( row, 0 ) ).value;
+          }
+          QVERIFY( sum > 0.0 );
+      }
+  }
+
+  void compressorAppend_data()
+  {
+      QTest::addColumn< int >( "points" );
+      QTest::newRow( "1000" ) << 1000;
+      QTest::newRow( "100000" ) << 100000;
+      QTest::newRow( "10000000" ) << 10000000;
+  }
+
+  void compressorAppend()
+  {
+      QFETCH( int, points );
+      SyntheticModel model( points, 1 );
+      CartesianDiagramDataCompressor compressor;
+      compressor.setAppendOptimized( true );
+      compressor.setModel( &model );
+      compressor.setResolution( 800, 600 );
+      for ( int row = 0; row < compressor.modelDataRows(); ++row ) {
+          compressor.data( CachePosition( row, 0 ) );
+      }
+      QBENCHMARK {
+          model.appendRows( 100 );
+          const CachePosition last( compressor.modelDataRows() - 1, 0 );
+          QVERIFY( !qIsNaN( compressor.data( last ).value ) );
+      }
+  }
+
+  void attributesModelLookup_data()
+  {
+      QTest::addColumn< bool >( "typed" );
+      QTest::newRow( "QVariant" ) << false;
+      QTest::newRow( "typed" ) << true;
+  }
+
+  void attributesModelLookup()
+  {
+      QFETCH( bool, typed );
+      DiagramFixture fixture( LineChart, 10000, 4 );
+      // a few column and cell level attributes, like real charts have
+      DataValueAttributes visibleAttributes = fixture.diagram->dataValueAttributes();
+      visibleAttributes.setVisible( true );
+      fixture.diagram->setDataValueAttributes( 1, visibleAttributes );
+      fixture.diagram->setDataValueAttributes( fixture.model.index( 5, 2 ), visibleAttributes );
+
+      const AttributesModel* attributesModel = fixture.diagram->attributesModel();
+      const int rows = attributesModel->rowCount( QModelIndex() );
+      const int columns = attributesModel->columnCount( QModelIndex() );
+      QBENCHMARK {
+          int visible = 0;
+          for ( int row = 0; row < rows; ++row ) {
+              for ( int column = 0; column < columns; ++column ) {
+                  const QModelIndex index = attributesModel->index( row, column, QModelIndex() );
+                  if ( typed ) {
+                      QVariant buffer;
+                      visible += attributesModel->attributes< DataValueAttributes >(
+                                     index, DataValueLabelAttributesRole, &buffer ).isVisible();
+                  } else {
+                      visible += attributesModel->data( index, DataValueLabelAttributesRole )
+                                     .value< DataValueAttributes >().isVisible();
+                  }
+              }
+          }
+          QCOMPARE( visible, rows + 1 );
+      }
+  }
+
+  void hitTest_data()
+  {
+      QTest::addColumn< int >( "points" );
+      QTest::newRow( "1000" ) << 1000;
+      QTest::newRow( "10000" ) << 10000;
+  }
+
+  void hitTest()
+  {
+      QFETCH( int, points );
+      DiagramFixture fixture( BarChart, points );
+      QImage image( DiagramFixture::size, QImage::Format_ARGB32_Premultiplied );
+      // painting builds the reverse mapping
+      fixture.paint( &image );
+
+      const QRect area = fixture.chart.coordinatePlane()->geometry();
+      QVector< QPoint > probes;
+      for ( int i = 0; i < 1000; ++i ) {
+          probes << QPoint( area.left() + ( i * 37 ) % area.width(), area.top() + ( i * 53 ) % area.height() );
+      }
+      QBENCHMARK {
+          int hits = 0;
+          for ( const QPoint& probe : qAsConst( probes ) ) {
+              hits += fixture.diagram->indexAt( probe ).isValid();
+          }
+          QVERIFY( hits >= 0 );
+      }
+  }
+
+  void axisLayout_data()
+  {
+      QTest::addColumn< int >( "points" );
+      QTest::newRow( "1000" ) << 1000;
+      QTest::newRow( "100000" ) << 100000;
+  }
+
+  void axisLayout()
+  {
+      QFETCH( int, points );
+      DiagramFixture fixture( LineChart, points );
+      QImage image( DiagramFixture::size, QImage::Format_ARGB32_Premultiplied );
+      fixture.paint( &image );
+
+      QBENCHMARK {
+          fixture.chart.coordinatePlane()->layoutPlanes();
+          for ( CartesianAxis* axis : qAsConst( fixture.axes ) ) {
+              axis->setCachedSizeDirty();
+              QVERIFY( axis->sizeHint().isValid() );
+          }
+      }
+  }
+
+  void legendLayout_data()
+  {
+      QTest::addColumn< int >( "datasets" );
+      QTest::newRow( "10" ) << 10;
+      QTest::newRow( "100" ) << 100;
+      QTest::newRow( "1000" ) << 1000;
+  }
+
+  void legendLayout()
+  {
+      QFETCH( int, datasets );
+      DiagramFixture fixture( LineChart, 100, datasets );
+      Legend* legend = new Legend( fixture.diagram, &fixture.chart );
+      fixture.chart.addLegend( legend );
+
+      QBENCHMARK {
+          legend->forceRebuild();
+          QVERIFY( legend->sizeHint().isValid() );
+      }
+  }
+};
+
+int main( int argc, char** argv )
+{
+    // the numbers must not depend on a display or window manager
+    if ( qEnvironmentVariableIsEmpty( "QT_QPA_PLATFORM" ) ) {
+        qputenv( "QT_QPA_PLATFORM", "offscreen" );
+    }
+    QApplication app( argc, argv );
+    BenchmarkKChart benchmark;
+    return QTest::qExec( &benchmark, argc, argv );
+}
+
+#include "main.moc"